@@ -56,11 +56,17 @@ class LMI_SO AccountValue final
   public:
     explicit AccountValue(Input const& input);
     AccountValue(AccountValue&&) = default;
-    ~AccountValue() override = default;
+    ~AccountValue() override;
 
     void RunAV();
+    std::shared_ptr<Ledger const> RunRateScenario
+        (std::vector<double> const& gen_acct_rate
+        ,std::vector<double> const& sep_acct_rate
+        );
 
+    void Rebind              (Input const&);
     void SetDebugFilename    (std::string const&);
+    void OmitGuarPremium     ();
 
     void SolveSetPmts // Antediluvian.
         (currency a_Pmt
@@ -134,6 +140,7 @@ class LMI_SO AccountValue final
     LedgerInvariant& InvariantValues();
     LedgerVariant  & VariantValues  ();
 
+    void   RestoreInitialState     ();
     void   RunOneCell              (mcenum_run_basis);
     void   RunOneBasis             (mcenum_run_basis);
     void   RunAllApplicableBases   ();
@@ -298,21 +305,24 @@ class LMI_SO AccountValue final
 
     void   ApplyDynamicMandE       (currency assets);
 
-    void   SetMonthlyDetail(int enumerator, std::string const&);
     void   SetMonthlyDetail(int enumerator, double);
     void   SetMonthlyDetail(int enumerator, currency);
     void   DebugPrintInit();
     void   DebugEndBasis();
+    void   DebugWriteRows();
+    void   DebugClose();
 
     void   EndTermRider(bool convert);
 
     void   CoordinateCounters();
 
-    // Detailed monthly trace.
+    // Detailed monthly trace. Values are recorded as raw doubles in
+    // fixed-width rows, and formatted only when a basis is complete
+    // (or not at all, if 'DebuggingRaw' is set).
     std::string     InputFilename;
     std::string     DebugFilename;
     std::ofstream   DebugStream;
-    std::vector<std::string> DebugRecord;
+    std::vector<double> DebugRows;
 
     currency        PriorAVGenAcct;
     currency        PriorAVSepAcct;
@@ -323,8 +333,10 @@ class LMI_SO AccountValue final
 
     // Mode flags.
     bool            Debugging;
+    bool            DebuggingRaw {false};
     bool            Solving;
     bool            SolvingForGuarPremium;
+    bool            GuarPremiumWanted {true};
     bool            ItLapsed;
 
     std::shared_ptr<Ledger         > ledger_;
@@ -125,6 +125,8 @@ AccountValue::AccountValue(Input const& input)
     NetPmts    .resize(12);
 }
 
+AccountValue::~AccountValue() = default;
+
 /// Specified amount.
 
 currency AccountValue::base_specamt(int year) const
@@ -148,6 +150,25 @@ void AccountValue::RunAV()
     RunAllApplicableBases();
 }
 
+/// Run this cell again, with different input interest rates.
+
+std::shared_ptr<Ledger const> AccountValue::RunRateScenario
+    (std::vector<double> const& gen_acct_rate
+    ,std::vector<double> const& sep_acct_rate
+    )
+{
+    BasicValues::SetInterestRateScenario(gen_acct_rate, sep_acct_rate);
+
+    Solving               = mce_solve_none != yare_input_.SolveType;
+    SolvingForGuarPremium = false;
+    ItLapsed              = false;
+    ledger_.reset(::new Ledger(BasicValues::GetLength(), BasicValues::ledger_type(), BasicValues::nonillustrated(), BasicValues::no_can_issue(), false));
+    ledger_invariant_.reset(::new LedgerInvariant(BasicValues::GetLength()));
+    stored_pmts = Outlay_->ee_modal_premiums();
+    RunAV();
+    return ledger_from_av();
+}
+
 //============================================================================
 void AccountValue::RunOneBasis(mcenum_run_basis TheBasis)
 {
@@ -1037,6 +1058,37 @@ void AccountValue::SetDebugFilename(std::string const& s)
     DebugFilename = s;
 }
 
+/// Reuse this object for a different cell.
+///
+/// The antediluvian branch recycles only the storage of vectors that
+/// it reassigns for every cell.
+
+void AccountValue::Rebind(Input const& input)
+{
+    BasicValues::Rebind(Input::consummate(input));
+
+    InputFilename     = "anonymous";
+    DebugFilename     = "anonymous.monthly_trace";
+    GuarPremiumWanted = true;
+    ledger_.reset(::new Ledger(BasicValues::GetLength(), BasicValues::ledger_type(), BasicValues::nonillustrated(), BasicValues::no_can_issue(), false));
+    ledger_invariant_.reset(::new LedgerInvariant(BasicValues::GetLength()));
+    ledger_variant_  .reset(::new LedgerVariant  (BasicValues::GetLength()));
+    RunBasis_         = mce_run_gen_curr_sep_full;
+    GenBasis_         = mce_gen_curr;
+    SepBasis_         = mce_sep_full;
+    pmt_mode          = mce_annual;
+    OldDBOpt          = mce_option1;
+    YearsDBOpt        = mce_option1;
+    stored_pmts       = Outlay_->ee_modal_premiums();
+}
+
+/// The antediluvian branch never solves for the guaranteed premium.
+
+void AccountValue::OmitGuarPremium()
+{
+    GuarPremiumWanted = false;
+}
+
 // Stubs for member functions not implemented on this branch.
 
 void   AccountValue::CoordinateCounters()
@@ -31,6 +31,7 @@
 #include "oecumenic_enumerations.hpp"   // methuselah
 #include "path.hpp"
 #include "path_utility.hpp"             // fs::path inserter
+#include "rate_pack.hpp"
 #include "ssize_lmi.hpp"
 
 #include <algorithm>                    // max(), min()
@@ -42,6 +43,7 @@
 #include <ios>
 #include <istream>
 #include <limits>
+#include <memory>                       // shared_ptr
 
 namespace
 {
@@ -77,6 +79,87 @@ namespace
         LMI_ASSERT(invalid != t);
         return t;
     }
+
+    /// Apply a nondefault lookup method, given a function that reads
+    /// values as actuarial_table::values() does.
+    ///
+    /// Shared by class actuarial_table and rate packs, so that both
+    /// treat reentry identically. Callers validate arguments.
+
+    template<typename Lookup>
+    std::vector<double> elaborated_values
+        (Lookup                   specific_values
+        ,char                     table_type
+        ,int                      min_age
+        ,int                      issue_age
+        ,int                      length
+        ,e_actuarial_table_method method
+        ,int                      inforce_duration
+        ,int                      reset_duration
+        )
+    {
+        if('S' != table_type)
+            {
+            return specific_values(issue_age, length);
+            }
+
+        switch(method)
+            {
+            case e_reenter_at_inforce_duration:
+                {
+                int const delta = inforce_duration;
+                std::vector<double> v = specific_values
+                    (issue_age + delta
+                    ,length    - delta
+                    );
+                v.insert(v.begin(), delta, 0.0);
+                return v;
+                }
+                // break;
+            case e_reenter_upon_rate_reset:
+                {
+                int const age_setback_limit = issue_age - min_age;
+                int const delta = std::max(reset_duration, -age_setback_limit);
+                std::vector<double> v = specific_values
+                    (issue_age + delta
+                    ,length    - delta
+                    );
+                if(delta < 0)
+                    {
+                    v.erase(v.begin(), v.begin() - delta);
+                    }
+                else
+                    {
+                    v.insert(v.begin(), delta, 0.0);
+                    }
+                return v;
+                }
+                // break;
+            case e_reenter_never:
+                {
+                alarum() << "Cannot use 'e_reenter_never' here." << LMI_FLUSH;
+                }
+            }
+        throw "Unreachable--silences a compiler diagnostic.";
+    }
+
+    /// Rate pack precompiled from the given SOA database, if there is
+    /// one that is up to date; else null.
+    ///
+    /// Whether a pack is up to date is determined once when it is
+    /// loaded (see rate_pack::is_current()), so a lookup touches the
+    /// file system only as any cached file read does.
+
+    std::shared_ptr<rate_pack const> current_rate_pack(std::string const& filename)
+    {
+        fs::path const pack_path = rate_pack::pack_filename(filename);
+        if(!fs::exists(pack_path))
+            {
+            return {};
+            }
+        auto const pack = rate_pack::read_via_cache(pack_path);
+        return pack->is_current() ? pack : nullptr;
+    }
 } // Unnamed namespace.
 
 actuarial_table::actuarial_table(std::string const& filename, int table_number)
@@ -90,9 +173,18 @@ actuarial_table::actuarial_table(std::string const& filename, int table_number)
     ,table_offset_   {-1}
 {
     // Binary tables in the SOA format are not portable; this code
-    // presumably works only on little-endian hardware.
+    // presumably works only on little-endian hardware. Check that at
+    // run time, so that lmi can still be built elsewhere.
 #if 202002 <= __cplusplus
-    static_assert(std::endian::native == std::endian::little);
+    if(std::endian::native != std::endian::little)
+        {
+        alarum()
+            << "Binary table file '"
+            << filename_
+            << "' can be read only on little-endian hardware."
+            << LMI_FLUSH
+            ;
+        }
 #endif // 202002 <= __cplusplus
 
     if(table_number_ <= 0)
@@ -139,49 +231,16 @@ std::vector<double> actuarial_table::values_elaborated
     LMI_ASSERT(inforce_duration < 1 + max_age_ - issue_age);
     LMI_ASSERT(reset_duration <= inforce_duration);
 
-    if('S' != table_type_)
-        {
-        return specific_values(issue_age, length);
-        }
-
-    switch(method)
-        {
-        case e_reenter_at_inforce_duration:
-            {
-            int const delta = inforce_duration;
-            std::vector<double> v = specific_values
-                (issue_age + delta
-                ,length    - delta
-                );
-            v.insert(v.begin(), delta, 0.0);
-            return v;
-            }
-            // break;
-        case e_reenter_upon_rate_reset:
-            {
-            int const age_setback_limit = issue_age - min_age_;
-            int const delta = std::max(reset_duration, -age_setback_limit);
-            std::vector<double> v = specific_values
-                (issue_age + delta
-                ,length    - delta
-                );
-            if(delta < 0)
-                {
-                v.erase(v.begin(), v.begin() - delta);
-                }
-            else
-                {
-                v.insert(v.begin(), delta, 0.0);
-                }
-            return v;
-            }
-            // break;
-        case e_reenter_never:
-            {
-            alarum() << "Cannot use 'e_reenter_never' here." << LMI_FLUSH;
-            }
-        }
-    throw "Unreachable--silences a compiler diagnostic.";
+    return elaborated_values
+        ([this] (int age, int n) {return specific_values(age, n);}
+        ,table_type_
+        ,min_age_
+        ,issue_age
+        ,length
+        ,method
+        ,inforce_duration
+        ,reset_duration
+        );
 }
 
 /// Find the table specified by table_number_.
@@ -566,6 +625,11 @@ std::vector<double> actuarial_table_rates
     ,int                length
     )
 {
+    auto const pack = current_rate_pack(table_filename);
+    if(pack && pack->contains(table_number))
+        {
+        return pack->find_table(table_number).values(issue_age, length);
+        }
     actuarial_table z(table_filename, table_number);
     return z.values(issue_age, length);
 }
@@ -580,6 +644,27 @@ std::vector<double> actuarial_table_rates_elaborated
     ,int                      reset_duration
     )
 {
+    auto const pack = current_rate_pack(table_filename);
+    if(pack && pack->contains(table_number))
+        {
+        auto const t = pack->find_table(table_number);
+        int const max_age = t.max_age();
+        LMI_ASSERT(t.min_age() <= issue_age && issue_age <= max_age);
+        LMI_ASSERT(0 <= length && length <= 1 + max_age - issue_age);
+        LMI_ASSERT(0 <= inforce_duration);
+        LMI_ASSERT(inforce_duration < 1 + max_age - issue_age);
+        LMI_ASSERT(reset_duration <= inforce_duration);
+        return elaborated_values
+            ([&t] (int age, int n) {return t.values(age, n);}
+            ,t.table_type()
+            ,t.min_age()
+            ,issue_age
+            ,length
+            ,method
+            ,inforce_duration
+            ,reset_duration
+            );
+        }
     actuarial_table z(table_filename, table_number);
     return z.values_elaborated
         (issue_age
@@ -27,6 +27,7 @@
 #include "cso_table.hpp"
 #include "miscellany.hpp"
 #include "oecumenic_enumerations.hpp"
+#include "rate_pack.hpp"
 #include "ssize_lmi.hpp"
 #include "test_tools.hpp"
 #include "timer.hpp"
@@ -617,6 +618,106 @@ void test_exotic_lookup_methods_with_attained_age_table()
         );
 }
 
+/// Test rate packs compiled from an SOA database.
+///
+/// A pack must reproduce every row that class actuarial_table reads,
+/// for each table type, and must be used transparently by the
+/// convenience functions when it lies beside its database. Tables
+/// absent from the pack are still read from the database.
+
+void test_rate_pack()
+{
+    for(auto const& extension : {".ndx", ".dat"})
+        {
+        std::ifstream ifs((qx_ins + extension).c_str(), ios_in_binary());
+        std::ofstream ofs((std::string("eraseme") + extension).c_str(), ios_out_trunc_binary());
+        ofs << ifs.rdbuf();
+        }
+
+    // Tables 250, 256, and 750 are of types 'A', 'S', and 'D'.
+    std::vector<int> const numbers {250, 256, 750};
+    fs::path const pack_path = rate_pack::pack_filename("eraseme");
+    LMI_TEST_EQUAL("eraseme.rpk", pack_path.string());
+    rate_pack::write("eraseme", numbers, pack_path);
+
+    {
+    rate_pack const pack(pack_path);
+    LMI_TEST_EQUAL(3, pack.tables_count());
+    LMI_TEST(pack.is_current());
+    LMI_TEST(!pack.contains(42));
+    for(auto const number : numbers)
+        {
+        actuarial_table const t("eraseme", number);
+        auto const v = pack.find_table(number);
+        LMI_TEST_EQUAL(t.table_type(), v.table_type());
+        for(int age = t.min_age(); age <= t.max_age(); ++age)
+            {
+            int const length = 1 + t.max_age() - age;
+            LMI_TEST(t.values(age, length) == v.values(age, length));
+            }
+        }
+
+    LMI_TEST_THROW
+        (pack.find_table(42)
+        ,std::runtime_error
+        ,"There is no table number 42 in rate pack eraseme.rpk."
+        );
+    }
+
+    actuarial_table const z(qx_ins, 256);
+    int const iss_age = 5 + z.min_age();
+    int const length  = 1 + z.max_age() - iss_age;
+    e_actuarial_table_method const m = e_reenter_upon_rate_reset;
+    LMI_TEST
+        (   actuarial_table_rates("eraseme", 256, iss_age, length)
+        ==  z.values(iss_age, length)
+        );
+    LMI_TEST
+        (   actuarial_table_rates_elaborated("eraseme", 256, iss_age, length, m, 5, -3)
+        ==  z.values_elaborated(iss_age, length, m, 5, -3)
+        );
+
+    rate_pack::write("eraseme", {256, 750}, pack_path);
+    actuarial_table const a(qx_ins, 250);
+    LMI_TEST
+        (   actuarial_table_rates("eraseme", 250, a.min_age(), 1)
+        ==  a.values(a.min_age(), 1)
+        );
+
+    // Altering the database in place, without changing its size or
+    // its modification time, makes the pack stale.
+    rate_pack::write("eraseme", numbers, pack_path);
+    LMI_TEST(rate_pack(pack_path).is_current());
+    auto const dat_time = fs::last_write_time("eraseme.dat");
+    {
+    std::fstream f("eraseme.dat", ios_in_binary() | std::ios_base::out);
+    char c {};
+    f.seekg(0).get(c);
+    f.seekp(0).put(static_cast<char>(~c));
+    LMI_TEST(f.good());
+    }
+    fs::last_write_time("eraseme.dat", dat_time);
+    LMI_TEST(!rate_pack(pack_path).is_current());
+
+    std::ofstream("eraseme.rpk", ios_out_trunc_binary()) << std::string(16, 'x');
+    LMI_TEST_THROW
+        (rate_pack("eraseme.rpk")
+        ,std::runtime_error
+        ,"Rate pack eraseme.rpk is truncated."
+        );
+
+    std::ofstream("eraseme.rpk", ios_out_trunc_binary()) << std::string(256, 'x');
+    LMI_TEST_THROW
+        (rate_pack("eraseme.rpk")
+        ,std::runtime_error
+        ,"File eraseme.rpk is not a rate pack."
+        );
+
+    LMI_TEST(0 == std::remove("eraseme.rpk"));
+    LMI_TEST(0 == std::remove("eraseme.dat"));
+    LMI_TEST(0 == std::remove("eraseme.ndx"));
+}
+
 void test_1980cso_errata()
 {
     test_80cso_erratum(43, oe_heterodox, oe_age_last_birthday);
@@ -635,6 +736,7 @@ int test_main(int, char*[])
     test_e_reenter_at_inforce_duration();
     test_e_reenter_upon_rate_reset();
     test_exotic_lookup_methods_with_attained_age_table();
+    test_rate_pack();
     test_1980cso_errata();
 
     assay_speed();
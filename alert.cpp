@@ -32,6 +32,7 @@
 #include <sstream>                      // stringbuf
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 namespace
 {
@@ -153,12 +154,27 @@ class status_buf
         }
 };
 
+namespace
+{
+/// Warnings are diverted to the innermost warning_capture on the
+/// current thread, if any.
+
+thread_local std::vector<std::string>* captured_warnings = nullptr;
+} // Unnamed namespace.
+
 class warning_buf
     :public alert_buf
 {
     void raise_alert() override
         {
-        warning_alert_function(alert_string());
+        if(captured_warnings)
+            {
+            captured_warnings->push_back(alert_string());
+            }
+        else
+            {
+            warning_alert_function(alert_string());
+            }
         }
 };
 
@@ -187,13 +203,18 @@ class alarum_buf
 ///
 /// Both 'failbit' [27.6.2.5.3/8] and 'badbit' [27.6.2.1/3] must be
 /// specified in the call to exceptions().
+///
+/// Each thread has its own buffer, so that a message composed on a
+/// worker thread isn't interleaved with one composed concurrently on
+/// another thread. The platform-specific alert functions are then
+/// responsible for delivering it safely.
 
 template<typename T>
 inline std::ostream& alert_stream()
 {
     static_assert(std::is_base_of_v<alert_buf,T>);
-    static T buffer_;
-    static std::ostream stream_(&buffer_);
+    thread_local T buffer_;
+    thread_local std::ostream stream_(&buffer_);
     stream_.clear();
     stream_.exceptions(std::ios_base::failbit | std::ios_base::badbit);
     return stream_;
@@ -248,6 +269,17 @@ void safely_show_message(std::string const& message)
     safely_show_message(message.c_str());
 }
 
+warning_capture::warning_capture()
+    :enclosing_ {captured_warnings}
+{
+    captured_warnings = &messages_;
+}
+
+warning_capture::~warning_capture()
+{
+    captured_warnings = enclosing_;
+}
+
 std::string const& hobsons_prompt()
 {
     static std::string s
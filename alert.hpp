@@ -33,6 +33,7 @@
 #include <exception>
 #include <ostream>
 #include <string>
+#include <vector>
 
 /// Print user messages in a manner appropriate to the interface and
 /// platform by writing to the std::ostreams these functions return.
@@ -239,6 +240,30 @@ class hobsons_choice_exception
 {
 };
 
+/// Divert warnings raised on the current thread, for the lifetime of
+/// an instance, into a list that the caller can reissue later.
+///
+/// Useful when work is divided among threads but its diagnostics
+/// must be reported in a deterministic order: each task captures its
+/// own warnings, which the caller then reissues in task order.
+/// Captures nest: only the innermost one on a thread receives them.
+
+class LMI_SO warning_capture final
+{
+  public:
+    warning_capture();
+    ~warning_capture();
+
+    std::vector<std::string> const& messages() const {return messages_;}
+
+  private:
+    warning_capture(warning_capture const&) = delete;
+    warning_capture& operator=(warning_capture const&) = delete;
+
+    std::vector<std::string>  messages_;
+    std::vector<std::string>* enclosing_;
+};
+
 /// Functions for testing, intended to be implemented in a shared
 /// library to demonstrate that alerts can be raised there and
 /// processed in the main application.
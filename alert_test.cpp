@@ -92,5 +92,21 @@ int test_main(int, char*[])
 
     LMI_TEST_THROW(test_stream_arg(alarum(), "X"), std::runtime_error, "X");
 
+    // Captured warnings are not printed, and captures nest.
+    {
+    warning_capture outer;
+    warning() << "Outer capture." << std::flush;
+    {
+    warning_capture inner;
+    warning() << "Inner" << " capture." << std::flush;
+    LMI_TEST_EQUAL(1, inner.messages().size());
+    LMI_TEST_EQUAL("Inner capture.", inner.messages().front());
+    }
+    warning() << "Outer capture again." << std::flush;
+    LMI_TEST_EQUAL(2, outer.messages().size());
+    LMI_TEST_EQUAL("Outer capture again.", outer.messages().back());
+    }
+    test_stream_arg(warning(), "Uncaptured messages should appear on stdout.");
+
     return 0;
 }
@@ -25,11 +25,13 @@
 
 #include "configurable_settings.hpp"
 #include "force_linking.hpp"
+#include "wx_utility.hpp"               // CallOnGuiThread()
 
 #include <wx/app.h>                     // wxTheApp
 #include <wx/apptrait.h>
 #include <wx/frame.h>
 #include <wx/msgdlg.h>
+#include <wx/thread.h>                  // wxThread::IsMain()
 #if defined LMI_MSW
 #   include <wx/msw/wrapwin.h>          // HWND etc.
 #endif // defined LMI_MSW
@@ -59,9 +61,18 @@ bool volatile ensure_setup = set_alert_functions
 /// away. This is arguably unnecessary, but costs practically nothing;
 /// see:
 ///   https://lists.nongnu.org/archive/html/lmi/2018-06/msg00034.html
+///
+/// A message raised on a worker thread is posted to the GUI thread,
+/// without waiting for it to be shown.
 
 void status_alert(std::string const& s)
 {
+    if(wxTheApp && !wxThread::IsMain())
+        {
+        wxTheApp->CallAfter([s] {status_alert(s);});
+        return;
+        }
+
     if(wxTheApp)
         if(wxFrame* f = dynamic_cast<wxFrame*>(wxTheApp->GetTopWindow()))
             if(wxStatusBar* b = f->GetStatusBar())
@@ -71,8 +82,17 @@ void status_alert(std::string const& s)
                 }
 }
 
+/// A message raised on a worker thread is posted to the GUI thread,
+/// so that the worker needn't wait for it to be acknowledged.
+
 void warning_alert(std::string const& s)
 {
+    if(wxTheApp && !wxThread::IsMain())
+        {
+        wxTheApp->CallAfter([s] {warning_alert(s);});
+        return;
+        }
+
     std::cerr << "Warning: " << s << std::endl;
 
     // We don't use wxSafeShowMessage() here because it would only log the
@@ -91,9 +111,18 @@ void warning_alert(std::string const& s)
 ///
 /// The catch-clause throws an exception explicitly because accessing
 /// configurable_settings during startup may be problematic.
+///
+/// On a worker thread, the question is posed on the GUI thread, and
+/// the worker waits for the answer.
 
 void hobsons_choice_alert(std::string const& s)
 {
+    if(wxTheApp && !wxThread::IsMain())
+        {
+        CallOnGuiThread([&s] {hobsons_choice_alert(s);});
+        return;
+        }
+
     std::cerr << "Hobson's choice: " << s << std::endl;
 
     wxWindow* w = nullptr;
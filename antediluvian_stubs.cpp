@@ -30,6 +30,7 @@
 #include "mec_server.hpp"
 #include "path.hpp"
 #include "product_data.hpp"
+#include "product_snapshot.hpp"
 #include "stratified_charges.hpp"
 #include "verify_products.hpp"
 #include "xml_lmi.hpp"
@@ -60,6 +61,11 @@ bool is_antediluvian_fork()
     return true;
 }
 
+std::shared_ptr<product_data const> read_product_via_cache(std::string const&)
+{
+    return {};
+}
+
 void verify_products()
 {}
 
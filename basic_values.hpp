@@ -101,6 +101,7 @@ class LMI_SO BasicValues
     virtual ~BasicValues();
 
     void Init();
+    void Rebind(Input const& input);
 
     int                   GetLength()                  const;
     int                   GetIssueAge()                const;
@@ -121,12 +122,12 @@ class LMI_SO BasicValues
 
     yare_input                                yare_input_;
 
-    std::shared_ptr<product_data       const> const product_;
-    product_database                          const database_;
-    std::shared_ptr<lingo              const> const lingo_;
-    std::shared_ptr<FundData           const> const FundData_;
-    std::shared_ptr<rounding_rules     const> const RoundingRules_;
-    std::shared_ptr<stratified_charges const> const StratifiedCharges_;
+    std::shared_ptr<product_data       const> product_;
+    product_database                          database_;
+    std::shared_ptr<lingo              const> lingo_;
+    std::shared_ptr<FundData           const> FundData_;
+    std::shared_ptr<rounding_rules     const> RoundingRules_;
+    std::shared_ptr<stratified_charges const> StratifiedCharges_;
 
     std::unique_ptr<i7702          const> i7702_;
     std::shared_ptr<gpt7702             > gpt7702_;
@@ -304,6 +305,11 @@ class LMI_SO BasicValues
         ,currency         a_specamt
         ) const;
 
+    void SetInterestRateScenario
+        (std::vector<double> const& gen_acct_rate
+        ,std::vector<double> const& sep_acct_rate
+        );
+
     // TODO ?? A priori, protected data is a defect.
     int                     Length;
     int                     IssueAge;
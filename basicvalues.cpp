@@ -88,6 +88,27 @@ BasicValues::BasicValues(Input const& input)
     Init();
 }
 
+/// Rebind to a different cell, as though constructed anew from it.
+
+void BasicValues::Rebind(Input const& input)
+{
+    yare_input_          = yare_input(input);
+    database_            = product_database
+        ("filename--empty for antediluvian fork"
+        ,yare_input_.Gender
+        ,yare_input_.UnderwritingClass
+        ,yare_input_.Smoking
+        ,yare_input_.IssueAge
+        ,yare_input_.GroupUnderwritingType
+        ,yare_input_.StateOfJurisdiction
+        );
+    StateOfJurisdiction_ = mce_s_CT;
+    StateOfDomicile_     = mce_s_CT;
+    PremiumTaxState_     = mce_s_CT;
+
+    Init();
+}
+
 /// Destructor.
 ///
 /// Although it is explicitly defaulted, this destructor is not
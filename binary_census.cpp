@@ -0,0 +1,490 @@
+// Compact binary census files.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "binary_census.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "contains.hpp"
+#include "input.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "path_utility.hpp"             // fs::path inserter
+#include "ssize_lmi.hpp"
+
+#include <bit>                          // endian
+#include <cstring>                      // memcmp(), memcpy()
+#include <type_traits>
+#include <unordered_map>
+
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // open()
+#   include <sys/mman.h>                // mmap(), munmap()
+#   include <sys/stat.h>                // fstat()
+#   include <unistd.h>                  // close()
+#endif // defined LMI_POSIX
+
+namespace
+{
+char const census_magic[8] = {'l', 'm', 'i', 'c', 'e', 'n', 's', 'b'};
+
+/// Increment whenever the layout changes. Changes to class Input
+/// require no new version, because field names are stored.
+
+std::uint32_t const census_version = 1;
+
+/// Censuses are written and read without swapping bytes, so files
+/// are portable only among little-endian machines; refuse others.
+
+void require_native_byte_order()
+{
+    if(std::endian::native != std::endian::little)
+        {
+        alarum() << "Binary censuses require little-endian hardware." << LMI_FLUSH;
+        }
+}
+
+/// The j-th element of an array of T in a census image.
+///
+/// The image is only byte-addressable as far as the language is
+/// concerned, so each datum is copied out rather than read through
+/// a cast pointer.
+
+template<typename T>
+T datum_at(char const* array, std::uint64_t j)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    T z;
+    std::memcpy(&z, array + j * sizeof z, sizeof z);
+    return z;
+}
+
+std::uint64_t u64_at(char const* array, std::uint64_t j)
+{
+    return datum_at<std::uint64_t>(array, j);
+}
+
+std::uint32_t u32_at(char const* array, std::uint64_t j)
+{
+    return datum_at<std::uint32_t>(array, j);
+}
+} // Unnamed namespace.
+
+/// Fixed-size header at the beginning of a binary census.
+///
+/// Sections follow in the order described in the class documentation,
+/// with no padding, so their offsets need not be stored.
+
+struct binary_census::header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t n_fields;
+    std::uint32_t n_classes;
+    std::uint32_t reserved;
+    std::uint64_t n_cells;
+    std::uint64_t n_strings;
+    std::uint64_t n_deltas;
+    std::uint64_t n_chars;
+    std::uint64_t file_size;
+};
+
+namespace
+{
+/// Distinct strings, each with a serial number.
+
+class string_table
+{
+  public:
+    std::uint32_t index(std::string const& s)
+        {
+        auto const i = indices_.try_emplace(s, bourn_cast<std::uint32_t>(strings_.size()));
+        if(i.second)
+            {
+            strings_.push_back(s);
+            }
+        return i.first->second;
+        }
+
+    std::vector<std::string> const& strings() const {return strings_;}
+
+  private:
+    std::unordered_map<std::string,std::uint32_t> indices_;
+    std::vector<std::string> strings_;
+};
+} // Unnamed namespace.
+
+/// Map or read a binary census, and validate its layout.
+
+binary_census::binary_census(fs::path const& filename)
+    :filename_ {filename}
+{
+    require_native_byte_order();
+
+    char const* image = nullptr;
+    std::size_t image_size = 0;
+
+#if defined LMI_POSIX
+    int const fd = ::open(filename.string().c_str(), O_RDONLY);
+    struct stat st;
+    if(-1 == fd || 0 != ::fstat(fd, &st))
+        {
+        if(-1 != fd) {::close(fd);}
+        alarum() << "Unable to open census " << filename << "." << LMI_FLUSH;
+        }
+    image_size = bourn_cast<std::size_t>(st.st_size);
+    void* const p =
+          sizeof(header) <= image_size
+        ? ::mmap(nullptr, image_size, PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED
+        ;
+    ::close(fd);
+    if(MAP_FAILED == p)
+        {
+        alarum() << "Unable to map census " << filename << "." << LMI_FLUSH;
+        }
+    mapping_      = p;
+    mapping_size_ = image_size;
+    image = static_cast<char const*>(p);
+#else  // !defined LMI_POSIX
+    fs::ifstream ifs(filename, ios_in_binary() | std::ios_base::ate);
+    if(!ifs)
+        {
+        alarum() << "Unable to open census " << filename << "." << LMI_FLUSH;
+        }
+    image_size = bourn_cast<std::size_t>(static_cast<std::streamoff>(ifs.tellg()));
+    ifs.seekg(0);
+    buffer_.resize((image_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    ifs.read(reinterpret_cast<char*>(buffer_.data()), bourn_cast<std::streamsize>(image_size));
+    if(!ifs)
+        {
+        alarum() << "Unable to read census " << filename << "." << LMI_FLUSH;
+        }
+    image = reinterpret_cast<char const*>(buffer_.data());
+#endif // !defined LMI_POSIX
+
+    try
+        {
+        header h;
+        if(image_size < sizeof h)
+            {
+            alarum() << "Census " << filename << " is truncated." << LMI_FLUSH;
+            }
+        std::memcpy(&h, image, sizeof h);
+        if(0 != std::memcmp(h.magic, census_magic, sizeof census_magic))
+            {
+            alarum() << "File " << filename << " is not a binary census." << LMI_FLUSH;
+            }
+        if(census_version != h.version)
+            {
+            alarum()
+                << "Census " << filename
+                << " has version " << h.version
+                << ", but version " << census_version
+                << " is required."
+                << LMI_FLUSH
+                ;
+            }
+        // Check each count against the bytes that remain before
+        // multiplying by it, so that no offset computed below can
+        // overflow or lie outside the image.
+        std::uint64_t remaining = image_size - sizeof h;
+        auto const fits = [&remaining] (std::uint64_t count, std::uint64_t unit)
+            {
+            if(remaining / unit < count)
+                {
+                return false;
+                }
+            remaining -= count * unit;
+            return true;
+            };
+        bool const sized =
+               0 != h.n_classes
+            && 0 != h.n_cells
+            && h.file_size == image_size
+            && fits(h.n_strings, sizeof(std::uint64_t)    )
+            && fits(1          , sizeof(std::uint64_t)    )
+            && fits(h.n_classes, sizeof(std::uint64_t)    )
+            && fits(h.n_cells  , sizeof(std::uint64_t)    )
+            && fits(1          , sizeof(std::uint64_t)    )
+            && fits(h.n_deltas , 2 * sizeof(std::uint32_t))
+            && fits(h.n_fields , sizeof(std::uint32_t)    )
+            && fits(h.n_fields , sizeof(std::uint32_t)    )
+            && fits(h.n_chars  , 1                        )
+            && 0 == remaining
+            ;
+        if(!sized)
+            {
+            alarum() << "Census " << filename << " is corrupt." << LMI_FLUSH;
+            }
+
+        std::uint64_t const n_rows = h.n_classes + h.n_cells;
+        std::uint64_t const strings_offset = sizeof h;
+        std::uint64_t const rows_offset    = strings_offset + (1 + h.n_strings) * sizeof(std::uint64_t);
+        std::uint64_t const deltas_offset  = rows_offset    + (1 + n_rows)      * sizeof(std::uint64_t);
+        std::uint64_t const names_offset   = deltas_offset  + 2 * h.n_deltas    * sizeof(std::uint32_t);
+        std::uint64_t const values_offset  = names_offset   + h.n_fields        * sizeof(std::uint32_t);
+        std::uint64_t const chars_offset   = values_offset  + h.n_fields        * sizeof(std::uint32_t);
+
+        n_fields_       = h.n_fields;
+        n_classes_      = h.n_classes;
+        n_cells_        = h.n_cells;
+        n_strings_      = h.n_strings;
+        string_offsets_ = image + strings_offset;
+        row_offsets_    = image + rows_offset;
+        deltas_         = image + deltas_offset;
+        field_names_    = image + names_offset;
+        case_values_    = image + values_offset;
+        chars_          = image + chars_offset;
+
+        // Validate every index, so that no later access can stray
+        // outside the image.
+        bool okay =
+               0         == u64_at(string_offsets_, 0)
+            && h.n_chars == u64_at(string_offsets_, n_strings_)
+            && 0         == u64_at(row_offsets_, 0)
+            && h.n_deltas == u64_at(row_offsets_, n_rows)
+            ;
+        for(std::uint64_t j = 0; okay && j < n_strings_; ++j)
+            {
+            okay = u64_at(string_offsets_, j) <= u64_at(string_offsets_, 1 + j);
+            }
+        for(std::uint64_t j = 0; okay && j < n_rows; ++j)
+            {
+            okay = u64_at(row_offsets_, j) <= u64_at(row_offsets_, 1 + j);
+            }
+        for(std::uint64_t j = 0; okay && j < h.n_deltas; ++j)
+            {
+            okay = u32_at(deltas_, 2 * j) < n_fields_ && u32_at(deltas_, 1 + 2 * j) < n_strings_;
+            }
+        for(std::uint32_t j = 0; okay && j < n_fields_; ++j)
+            {
+            okay = u32_at(field_names_, j) < n_strings_ && u32_at(case_values_, j) < n_strings_;
+            }
+        if(!okay)
+            {
+            alarum() << "Census " << filename << " is corrupt." << LMI_FLUSH;
+            }
+
+        Input const exemplar;
+        names_.reserve(n_fields_);
+        for(std::uint32_t j = 0; j < n_fields_; ++j)
+            {
+            names_.push_back(string_at(u32_at(field_names_, j)));
+            if(!contains(exemplar.member_names(), names_.back()))
+                {
+                alarum()
+                    << "Census " << filename
+                    << ": '" << names_.back()
+                    << "' is not an input field."
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+
+        case_prototype_ = std::make_unique<Input>();
+        for(std::uint32_t j = 0; j < n_fields_; ++j)
+            {
+            (*case_prototype_)[names_[j]] = string_at(u32_at(case_values_, j));
+            }
+        }
+    catch(...)
+        {
+#if defined LMI_POSIX
+        ::munmap(mapping_, mapping_size_);
+#endif // defined LMI_POSIX
+        throw;
+        }
+}
+
+binary_census::~binary_census()
+{
+#if defined LMI_POSIX
+    if(mapping_)
+        {
+        ::munmap(mapping_, mapping_size_);
+        }
+#endif // defined LMI_POSIX
+}
+
+/// Write a census in binary form.
+///
+/// The file is written under a temporary name and then renamed, so
+/// that a reader never sees a partial census.
+
+void binary_census::write
+    (fs::path           const& filename
+    ,Input              const& case_default
+    ,std::vector<Input> const& class_defaults
+    ,std::vector<Input> const& cells
+    )
+{
+    require_native_byte_order();
+    LMI_ASSERT(!class_defaults.empty());
+    LMI_ASSERT(!cells.empty());
+
+    std::vector<std::string> const& names = case_default.member_names();
+    string_table strings;
+    std::vector<std::uint32_t> field_names;
+    std::vector<std::uint32_t> case_values;
+    std::vector<std::string>   case_text;
+    for(auto const& i : names)
+        {
+        case_text.push_back(case_default[i].str());
+        field_names.push_back(strings.index(i));
+        case_values.push_back(strings.index(case_text.back()));
+        }
+
+    std::vector<std::uint64_t> row_offsets {0};
+    std::vector<std::uint32_t> deltas;
+    auto const add_row = [&] (Input const& row)
+        {
+        for(int j = 0; j < lmi::ssize(names); ++j)
+            {
+            std::string const s = row[names[j]].str();
+            if(s != case_text[j])
+                {
+                deltas.push_back(bourn_cast<std::uint32_t>(j));
+                deltas.push_back(strings.index(s));
+                }
+            }
+        row_offsets.push_back(deltas.size() / 2);
+        };
+    for(auto const& i : class_defaults) {add_row(i);}
+    for(auto const& i : cells)          {add_row(i);}
+
+    std::vector<std::uint64_t> string_offsets {0};
+    std::string chars;
+    for(auto const& i : strings.strings())
+        {
+        chars += i;
+        string_offsets.push_back(chars.size());
+        }
+
+    header h {};
+    std::memcpy(h.magic, census_magic, sizeof census_magic);
+    h.version   = census_version;
+    h.n_fields  = bourn_cast<std::uint32_t>(names.size());
+    h.n_classes = bourn_cast<std::uint32_t>(class_defaults.size());
+    h.n_cells   = cells.size();
+    h.n_strings = strings.strings().size();
+    h.n_deltas  = deltas.size() / 2;
+    h.n_chars   = chars.size();
+    h.file_size =
+          sizeof h
+        + string_offsets.size() * sizeof(std::uint64_t)
+        + row_offsets   .size() * sizeof(std::uint64_t)
+        + deltas        .size() * sizeof(std::uint32_t)
+        + field_names   .size() * sizeof(std::uint32_t)
+        + case_values   .size() * sizeof(std::uint32_t)
+        + chars         .size()
+        ;
+
+    fs::path const temporary(filename.string() + ".tmp");
+    {
+    fs::ofstream ofs(temporary, ios_out_trunc_binary());
+    auto const put = [&ofs] (void const* p, std::size_t n)
+        {
+        ofs.write(static_cast<char const*>(p), bourn_cast<std::streamsize>(n));
+        };
+    put(&h                   , sizeof h);
+    put(string_offsets.data(), string_offsets.size() * sizeof(std::uint64_t));
+    put(row_offsets   .data(), row_offsets   .size() * sizeof(std::uint64_t));
+    put(deltas        .data(), deltas        .size() * sizeof(std::uint32_t));
+    put(field_names   .data(), field_names   .size() * sizeof(std::uint32_t));
+    put(case_values   .data(), case_values   .size() * sizeof(std::uint32_t));
+    put(chars         .data(), chars         .size());
+    if(!ofs)
+        {
+        alarum() << "Unable to write census " << temporary << "." << LMI_FLUSH;
+        }
+    }
+    fs::rename(temporary, filename);
+}
+
+/// Whether a file begins as a binary census does.
+
+bool binary_census::is_binary_census(fs::path const& filename)
+{
+    char magic[sizeof census_magic] = {};
+    fs::ifstream ifs(filename, ios_in_binary());
+    ifs.read(magic, sizeof magic);
+    return ifs && 0 == std::memcmp(magic, census_magic, sizeof magic);
+}
+
+int binary_census::classes_count() const
+{
+    return bourn_cast<int>(n_classes_);
+}
+
+int binary_census::cells_count() const
+{
+    return bourn_cast<int>(n_cells_);
+}
+
+Input binary_census::case_default() const
+{
+    return row(0, 0);
+}
+
+Input binary_census::class_default(int j) const
+{
+    LMI_ASSERT(0 <= j && j < classes_count());
+    std::uint64_t const r = bourn_cast<std::uint64_t>(j);
+    return row(u64_at(row_offsets_, r), u64_at(row_offsets_, 1 + r));
+}
+
+Input binary_census::cell(int j) const
+{
+    LMI_ASSERT(0 <= j && j < cells_count());
+    std::uint64_t const r = n_classes_ + bourn_cast<std::uint64_t>(j);
+    return row(u64_at(row_offsets_, r), u64_at(row_offsets_, 1 + r));
+}
+
+std::string binary_census::string_at(std::uint64_t j) const
+{
+    return std::string
+        (chars_ + u64_at(string_offsets_, j)
+        ,chars_ + u64_at(string_offsets_, 1 + j)
+        );
+}
+
+/// Reconstitute the case default, a class default, or a cell.
+///
+/// Starting from the case default as stored, each field that differs
+/// is assigned exactly as though it had been read from xml. Then
+/// whatever class Input does after reading xml is done, so that the
+/// result equals what reading the '.cns' equivalent would produce.
+
+Input binary_census::row(std::uint64_t first_delta, std::uint64_t end_delta) const
+{
+    Input z(*case_prototype_);
+    for(std::uint64_t j = first_delta; j < end_delta; ++j)
+        {
+        z[names_[u32_at(deltas_, 2 * j)]] = string_at(u32_at(deltas_, 1 + 2 * j));
+        }
+    z.redintegrate_ad_terminum();
+    z.DoAdaptExternalities();
+    return z;
+}
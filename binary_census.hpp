@@ -0,0 +1,122 @@
+// Compact binary census files.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef binary_census_hpp
+#define binary_census_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <cstddef>                      // size_t
+#include <cstdint>
+#include <memory>                       // unique_ptr
+#include <string>
+#include <vector>
+
+class Input;
+
+/// Compact binary image of a census, with random access to its cells.
+///
+/// A '.cns' file writes every field of every cell as an xml element,
+/// though most fields equal the case default. A binary census ('.cnsb'
+/// file) stores the case default once, and for each class default and
+/// each cell only the fields that differ from the case default. Every
+/// distinct string--field name or value--is stored only once. Fields
+/// hold the same text as in a '.cns' file, so conversion between the
+/// two formats is lossless; class multiple_cell_document reads and
+/// writes either.
+///
+/// File layout, in little-endian byte order; like rate packs, files
+/// are rejected at run time on other hardware:
+///   - a fixed-size header;
+///   - the offset of each string, and the end of the last one;
+///   - the offset of each row's first difference, and the end of the
+///     last row's, where rows are class defaults followed by cells;
+///   - the differences themselves, as {field, string} index pairs in
+///     field order;
+///   - the name of each field, as a string index;
+///   - the value of each field in the case default, as a string index;
+///   - the characters of all strings.
+/// Sections that hold 64-bit integers come first, so that all are
+/// naturally aligned.
+///
+/// Where memory mapping is available, the file is mapped rather than
+/// read, so that opening even a huge census costs little: any cell
+/// can be reconstituted without examining any other.
+
+class LMI_SO binary_census final
+{
+    struct header;
+
+  public:
+    explicit binary_census(fs::path const& filename);
+    ~binary_census();
+
+    static void write
+        (fs::path           const& filename
+        ,Input              const& case_default
+        ,std::vector<Input> const& class_defaults
+        ,std::vector<Input> const& cells
+        );
+
+    static bool is_binary_census(fs::path const& filename);
+
+    int classes_count() const;
+    int cells_count  () const;
+
+    Input case_default () const;
+    Input class_default(int) const;
+    Input cell         (int) const;
+
+  private:
+    binary_census(binary_census const&) = delete;
+    binary_census& operator=(binary_census const&) = delete;
+
+    std::string string_at(std::uint64_t) const;
+    Input row(std::uint64_t first_delta, std::uint64_t end_delta) const;
+
+    fs::path                 filename_;
+    // Case default as stored, before anything is done after reading.
+    std::unique_ptr<Input>   case_prototype_;
+    std::vector<std::string> names_;
+    std::uint32_t            n_fields_       {0};
+    std::uint32_t            n_classes_      {0};
+    std::uint64_t            n_cells_        {0};
+    std::uint64_t            n_strings_      {0};
+    // Sections of the image.
+    char const*              string_offsets_ {nullptr};
+    char const*              row_offsets_    {nullptr};
+    char const*              deltas_         {nullptr};
+    char const*              field_names_    {nullptr};
+    char const*              case_values_    {nullptr};
+    char const*              chars_          {nullptr};
+
+    // Mapped image, if memory mapping is available...
+    void*                      mapping_      {nullptr};
+    std::size_t                mapping_size_ {0};
+    // ...else the image as read into memory, aligned for 64 bits.
+    std::vector<std::uint64_t> buffer_;
+};
+
+#endif // binary_census_hpp
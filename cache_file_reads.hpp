@@ -29,6 +29,7 @@
 
 #include <map>
 #include <memory>                       // shared_ptr
+#include <mutex>
 #include <utility>                      // make_pair()
 
 namespace detail
@@ -50,7 +51,10 @@ namespace detail
 /// as long as it holds a pointer to them.
 ///
 /// Implemented as a simple Meyers singleton, with the expected
-/// dead-reference and threading issues.
+/// dead-reference issues. Access is serialized by a mutex, so that
+/// census runs on a worker thread can share the cache with the GUI
+/// thread; a file being loaded blocks other readers until loading is
+/// complete, which also prevents loading it twice.
 
 template<typename T>
 class file_cache
@@ -66,6 +70,8 @@ class file_cache
 
     retrieved_type retrieve_or_reload(fs::path const& filename)
         {
+        std::lock_guard<std::mutex> lock(mutex_);
+
         // Throws if !exists(filename).
         auto const write_time = fs::last_write_time(filename);
 
@@ -91,6 +97,32 @@ class file_cache
         return i->second.data;
         }
 
+    /// Store an instance obtained otherwise than by reading the file
+    /// (e.g., from a precompiled snapshot), as though it had been
+    /// read when the file's write time was 'write_time'. An instance
+    /// already cached for that same write time is kept instead.
+
+    void adopt
+        (fs::path const&    filename
+        ,retrieved_type     data
+        ,fs::file_time_type write_time
+        )
+        {
+        LMI_ASSERT(data);
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto i = cache_.lower_bound(filename);
+        if
+            (  cache_.end() == i
+            || filename     != i->first
+            || write_time   != i->second.write_time
+            )
+            {
+            i = cache_.insert(i, std::make_pair(filename, record()));
+            i->second.data = data;
+            i->second.write_time = write_time;
+            }
+        }
+
   private:
     file_cache() = default;
     file_cache(file_cache const&) = delete;
@@ -103,6 +135,7 @@ class file_cache
     };
 
     std::map<fs::path,record> cache_;
+    std::mutex                mutex_;
 };
 } // namespace detail
 
@@ -125,6 +158,18 @@ class cache_file_reads
         {
         return detail::file_cache<T>::instance().retrieve_or_reload(filename);
         }
+
+    /// Seed the cache with an instance that represents the given file
+    /// as of the given write time. See file_cache::adopt().
+
+    static void adopt_into_cache
+        (fs::path const&    filename
+        ,retrieved_type     data
+        ,fs::file_time_type write_time
+        )
+        {
+        detail::file_cache<T>::instance().adopt(filename, data, write_time);
+        }
 };
 
 #endif // cache_file_reads_hpp
@@ -0,0 +1,305 @@
+// Census import from tab-delimited text.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "census_tsv.hpp"
+
+#include "alert.hpp"
+#include "any_member.hpp"               // exact_cast()
+#include "calendar_date.hpp"
+#include "fenv_lmi.hpp"
+#include "miscellany.hpp"               // split_fields()
+#include "ssize_lmi.hpp"
+#include "tn_range_types.hpp"           // tnr_date
+#include "value_cast.hpp"
+
+#include <algorithm>                    // any_of(), max(), min()
+#include <atomic>
+#include <charconv>                     // from_chars()
+#include <exception>                    // current_exception(), exception_ptr
+#include <string>
+#include <system_error>                 // errc
+#include <thread>
+
+namespace
+{
+/// One line of census text, with its ordinal among data lines.
+
+struct tsv_line
+{
+    int              number;
+    std::string_view text;
+};
+
+/// A column of census text, resolved to a member of class Input.
+
+struct tsv_column
+{
+    std::string name;
+    bool        is_date;
+};
+
+/// Convert a date given either as a JDN or as YYYYMMDD to a JDN.
+
+std::string jdn_from_census_date
+    (std::string_view   value
+    ,std::string const& header
+    ,int                line_number
+    )
+{
+    int constexpr jdn_min = calendar_date::gregorian_epoch_jdn;
+    int constexpr jdn_max = calendar_date::last_yyyy_date_jdn;
+    static int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
+    static int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
+
+    int z {0};
+    char const* const end = value.data() + value.size();
+    auto const [p, ec] = std::from_chars(value.data(), end, z);
+    if(std::errc() != ec || end != p)
+        {
+        // Do nothing here: reported as an invalid date below.
+        z = 0;
+        }
+
+    if(jdn_min <= z && z <= jdn_max)
+        {
+        // Do nothing: JDN is the default expectation.
+        return std::string(value);
+        }
+    else if(ymd_min <= z && z <= ymd_max)
+        {
+        return value_cast<std::string>(YmdToJdn(ymd_t(z)).value());
+        }
+    else
+        {
+        alarum()
+            << "Invalid date " << value
+            << " for '" << header << "'"
+            << " on line " << line_number << "."
+            << LMI_FLUSH
+            ;
+        return std::string();
+        }
+}
+
+/// Set the given cell's members from one line of census text, and
+/// reconcile it.
+
+void read_cell
+    (Input&                         cell
+    ,tsv_line const&                line
+    ,std::vector<tsv_column> const& columns
+    )
+{
+    std::vector<std::string_view> values;
+    split_fields(line.text, values);
+    if(values.size() != columns.size())
+        {
+        alarum()
+            << "Line #" << line.number << ": "
+            << "  (" << line.text << ") "
+            << "should have one value per column. "
+            << "Number of values: " << values.size() << "; "
+            << "number expected: " << columns.size() << "."
+            << LMI_FLUSH
+            ;
+        }
+
+    for(int j = 0; j < lmi::ssize(columns); ++j)
+        {
+        tsv_column const& c = columns[j];
+        cell[c.name] =
+              c.is_date
+            ? jdn_from_census_date(values[j], c.name, line.number)
+            : std::string(values[j])
+            ;
+        }
+    cell.Reconcile();
+    cell.RealizeAllSequenceInput();
+}
+} // Unnamed namespace.
+
+/// Split census text into lines.
+///
+/// Like std::getline() followed by 'std::ws' in a stream imbued with
+/// tab_is_not_whitespace_locale(), which this replaces: whitespace
+/// other than tabs is skipped after each line, so blank lines are
+/// ignored, and so is leading whitespace other than tabs.
+
+std::vector<std::string_view> split_lines(std::string_view text)
+{
+    static constexpr std::string_view non_tab_whitespace {" \n\v\f\r"};
+    std::vector<std::string_view> lines;
+    std::string_view::size_type pos = 0;
+    while(pos < text.size())
+        {
+        auto const eol = text.find('\n', pos);
+        auto const end = (std::string_view::npos == eol) ? text.size() : eol;
+        lines.push_back(text.substr(pos, end - pos));
+        pos = text.find_first_not_of(non_tab_whitespace, end);
+        if(std::string_view::npos == pos)
+            {
+            break;
+            }
+        }
+    return lines;
+}
+
+/// Read cells from tab-delimited census text.
+///
+/// The first line gives column headers, which name members of class
+/// Input. Each subsequent line gives the values of those members for
+/// one cell; other members take their values from the case defaults.
+/// Dates may be given either as JDN or as YYYYMMDD.
+///
+/// Headers are resolved to members only once. Cells are read and
+/// reconciled on as many threads as the hardware supports, because
+/// reconciliation dominates the cost for large censuses. If any line
+/// is invalid, the exception raised by the first such line is thrown,
+/// just as if lines had been read one at a time.
+
+census_tsv read_census_tsv
+    (std::string_view text
+    ,Input const&     case_default
+    )
+{
+    std::vector<std::string_view> const lines = split_lines(text);
+    if(lines.empty())
+        {
+        alarum() << "Census data has no header line." << LMI_FLUSH;
+        }
+
+    std::vector<std::string_view> headers;
+    split_fields(lines.front(), headers);
+
+    // Use a modifiable copy of case defaults as an archetype for new
+    // cells. Callers may write modifications back to case defaults.
+    census_tsv result {case_default, {}};
+    Input& archetype = result.archetype;
+
+    std::vector<tsv_column> columns;
+    columns.reserve(headers.size());
+    for(auto const& h : headers)
+        {
+        std::string const name(h);
+        // Throws if no such member exists.
+        bool const is_date {nullptr != exact_cast<tnr_date>(archetype[name])};
+        columns.push_back({name, is_date});
+        }
+
+    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
+    auto const has_column = [&columns](std::string const& name)
+        {
+        return std::any_of
+            (columns.begin()
+            ,columns.end()
+            ,[&name](tsv_column const& c) {return name == c.name;}
+            );
+        };
+    if(has_column("UseDOB"))
+        {
+        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
+        }
+    bool const dob_pasted = has_column("DateOfBirth");
+    bool const age_pasted = has_column("IssueAge");
+    if(dob_pasted && age_pasted)
+        {
+        alarum()
+            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
+            << LMI_FLUSH
+            ;
+        }
+    else if(dob_pasted)
+        {
+        archetype["UseDOB"] = "Yes";
+        }
+    else if(age_pasted)
+        {
+        archetype["UseDOB"] = "No";
+        }
+    else
+        {
+        // Do nothing: neither age nor DOB pasted.
+        }
+
+    std::vector<tsv_line> data_lines;
+    data_lines.reserve(lines.size() - 1);
+    for(int j = 1; j < lmi::ssize(lines); ++j)
+        {
+        data_lines.push_back({j, lines[j]});
+        }
+    int const n_cells = lmi::ssize(data_lines);
+    if(0 == n_cells)
+        {
+        return result;
+        }
+
+    std::vector<Input>& cells = result.cells;
+    cells.assign(n_cells, archetype);
+
+    // Lines are claimed in order, so when one fails and no more are
+    // claimed, every earlier line has nonetheless been read.
+    std::vector<std::exception_ptr> errors(n_cells);
+    std::atomic<int>  next_line {0};
+    std::atomic<bool> failed    {false};
+    auto const worker = [&]
+        {
+        fenv_initialize();
+        for(int j = next_line++; j < n_cells && !failed; j = next_line++)
+            {
+            try
+                {
+                read_cell(cells[j], data_lines[j], columns);
+                }
+            catch(...)
+                {
+                errors[j] = std::current_exception();
+                failed = true;
+                }
+            }
+        };
+
+    int const n_threads = std::max
+        (1
+        ,std::min(n_cells, static_cast<int>(std::thread::hardware_concurrency()))
+        );
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1);
+    for(int j = 1; j < n_threads; ++j)
+        {
+        threads.emplace_back(worker);
+        }
+    worker();
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+
+    for(auto const& e : errors)
+        {
+        if(e)
+            {
+            std::rethrow_exception(e);
+            }
+        }
+    return result;
+}
@@ -0,0 +1,52 @@
+// Census import from tab-delimited text.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef census_tsv_hpp
+#define census_tsv_hpp
+
+#include "config.hpp"
+
+#include "input.hpp"
+#include "so_attributes.hpp"
+
+#include <string_view>
+#include <vector>
+
+/// Cells read from tab-delimited census text.
+///
+/// 'archetype' is a copy of the case defaults with "UseDOB" made
+/// consistent with the columns given; every cell began as a copy of
+/// it. Callers may adopt it as case and class defaults.
+
+struct census_tsv
+{
+    Input              archetype;
+    std::vector<Input> cells;
+};
+
+LMI_SO census_tsv read_census_tsv
+    (std::string_view text
+    ,Input const&     case_default
+    );
+
+std::vector<std::string_view> split_lines(std::string_view text);
+
+#endif // census_tsv_hpp
@@ -27,11 +27,11 @@
 #include "assert_lmi.hpp"
 #include "bourn_cast.hpp"
 #include "census_document.hpp"
+#include "census_tsv.hpp"
 #include "configurable_settings.hpp"
-#include "contains.hpp"
 #include "default_view.hpp"
 #include "edit_mvc_docview_parameters.hpp"
-#include "facets.hpp"                   // tab_is_not_whitespace_locale()
+#include "fenv_lmi.hpp"
 #include "global_settings.hpp"
 #include "illustration_view.hpp"
 #include "illustrator.hpp"
@@ -43,34 +43,39 @@
 #include "miscellany.hpp"               // is_ok_for_cctype(), ios_out_app_binary()
 #include "path.hpp"
 #include "path_utility.hpp"             // unique_filepath()
+#include "progress_meter.hpp"
 #include "rtti_lmi.hpp"                 // lmi::TypeInfo
 #include "safely_dereference_as.hpp"
 #include "ssize_lmi.hpp"
 #include "timer.hpp"
 #include "value_cast.hpp"
 #include "wx_new.hpp"
-#include "wx_utility.hpp"               // class ClipboardEx
+#include "wx_utility.hpp"               // class ClipboardEx, TheApp()
 
 #include <wx/datectrl.h>
 #include <wx/grid.h>
 #include <wx/headercol.h>               // wxCOL_WIDTH_DEFAULT
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
+#include <wx/progdlg.h>
 #include <wx/settings.h>
 #include <wx/spinctrl.h>
 #include <wx/textctrl.h>
-#include <wx/utils.h>                   // wxBusyCursor
+#include <wx/utils.h>                   // wxBusyCursor, wxMilliSleep()
 #include <wx/valnum.h>
 #include <wx/wupdlock.h>                // wxWindowUpdateLocker
 #include <wx/xrc/xmlres.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>                       // isupper()
+#include <chrono>
 #include <cstddef>                      // size_t
+#include <exception>                    // current_exception(), exception_ptr
 #include <fstream>
-#include <istream>                      // ws
 #include <iterator>                     // insert_iterator
 #include <sstream>
+#include <thread>
 
 namespace
 {
@@ -732,10 +737,11 @@ void CensusViewGridTable::SetValue(int row, int col, wxString const& value)
         return;
         }
 
-    cell = new_val;
-
     Input& model = view_.cell_parms().at(row);
+    view_.tally_column_variation(model, -1);
+    cell = new_val;
     model.Reconcile();
+    view_.tally_column_variation(model, 1);
 
     view_.document().Modify(true);
 }
@@ -934,6 +940,242 @@ std::string const& col_name(wxGridTableBase const& table, int col)
 }
 } // Unnamed namespace.
 
+namespace
+{
+/// Progress of a census run on a worker thread, shared with the GUI.
+
+struct census_run_progress
+{
+    std::atomic<bool> cancel_requested {false};
+    std::atomic<int>  count            {0};
+    std::atomic<int>  max_count        {0};
+};
+
+thread_local census_run_progress* this_thread_census_run {nullptr};
+
+/// Progress meter for a census run on a worker thread.
+///
+/// It never touches the GUI: it only publishes its count, which the
+/// GUI thread polls; and it learns of cancellation the same way.
+
+class census_run_progress_meter
+    :public progress_meter
+{
+  public:
+    census_run_progress_meter
+        (int                max_count
+        ,std::string const& title
+        ,enum_display_mode  display_mode
+        )
+        :progress_meter(max_count, title, display_mode)
+        ,progress_ {*this_thread_census_run}
+        {
+        progress_.count     = 0;
+        progress_.max_count = max_count;
+        }
+
+  private:
+    void do_dawdle(int seconds) override
+        {
+        for(int i = 10 * seconds; 0 < i && !progress_.cancel_requested; --i)
+            {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+
+    std::string progress_message() const override {return std::string();}
+
+    bool show_progress_message() override
+        {
+        progress_.count = count();
+        return !progress_.cancel_requested;
+        }
+
+    void culminate_ui() override {}
+
+    census_run_progress& progress_;
+};
+
+std::unique_ptr<progress_meter> census_run_progress_meter_creator
+    (int                               max_count
+    ,std::string const&                title
+    ,progress_meter::enum_display_mode display_mode
+    )
+{
+    LMI_ASSERT(nullptr != this_thread_census_run);
+    return std::make_unique<census_run_progress_meter>
+        (max_count
+        ,title
+        ,display_mode
+        );
+}
+} // Unnamed namespace.
+
+/// A census run on a worker thread, with a progress dialog.
+///
+/// The worker operates on a copy of the census's cells, so the census
+/// may be edited meanwhile. wx is not thread-safe, so any emission
+/// that needs it is delegated to the GUI thread: see CallOnGuiThread().
+///
+/// The progress dialog disables only the census's own frame, so that
+/// other documents remain usable. It's updated by polling, so that the
+/// worker never depends on the lifetime of any window.
+
+class census_run
+{
+  public:
+    static constexpr int polling_interval_msec {100};
+
+    census_run
+        (mcenum_emission           emission
+        ,std::string const&        base_filename
+        ,std::vector<Input> const& cells
+        ,wxWindow*                 parent
+        );
+    ~census_run();
+
+    mcenum_emission emission() const {return emission_;}
+
+    bool poll();
+    std::shared_ptr<Ledger const> result();
+
+  private:
+    census_run(census_run const&) = delete;
+    census_run& operator=(census_run const&) = delete;
+
+    void run();
+
+    static constexpr int progress_dialog_style
+        {   wxPD_CAN_ABORT
+        |   wxPD_ELAPSED_TIME
+        |   wxPD_ESTIMATED_TIME
+        |   wxPD_REMAINING_TIME
+        |   wxPD_SMOOTH
+        };
+
+    mcenum_emission    const emission_;
+    std::string        const base_filename_;
+    std::vector<Input> const cells_;
+
+    census_run_progress progress_;
+    std::atomic<bool>   finished_ {false};
+
+    // Written by the worker only before it sets finished_.
+    bool                          completed_ {false};
+    std::shared_ptr<Ledger const> composite_;
+    std::exception_ptr            exception_;
+
+    wxGenericProgressDialog progress_dialog_;
+
+    // Declared last, so that the worker starts only after every
+    // other member has been initialized.
+    std::thread worker_;
+};
+
+census_run::census_run
+    (mcenum_emission           emission
+    ,std::string const&        base_filename
+    ,std::vector<Input> const& cells
+    ,wxWindow*                 parent
+    )
+    :emission_        {emission}
+    ,base_filename_   {base_filename}
+    ,cells_           {cells}
+    ,progress_dialog_
+        ("Running census"
+        ,"Starting"
+        ,lmi::ssize(cells)
+        ,parent
+        ,progress_dialog_style
+        )
+    ,worker_          {&census_run::run, this}
+{
+}
+
+/// Cancel the run if it hasn't finished, and wait for it to stop.
+///
+/// While waiting, process pending events: the worker may be waiting
+/// for the GUI thread to do something on its behalf.
+
+census_run::~census_run()
+{
+    if(!worker_.joinable())
+        {
+        return;
+        }
+
+    progress_.cancel_requested = true;
+    while(!finished_)
+        {
+        TheApp().ProcessPendingEvents();
+        wxMilliSleep(10);
+        }
+    worker_.join();
+}
+
+/// Show progress; return whether the run has finished.
+///
+/// Cancelling the dialog asks the worker to stop at its next progress
+/// report. The displayed count is kept below the maximum, because
+/// wxGenericProgressDialog::Update() would otherwise wait modally for
+/// the dialog to be dismissed.
+
+bool census_run::poll()
+{
+    int const max_count {progress_.max_count};
+    if(0 < max_count && max_count != progress_dialog_.GetRange())
+        {
+        progress_dialog_.SetRange(max_count);
+        }
+    int const range {progress_dialog_.GetRange()};
+    int const count {std::min(progress_.count.load(), range - 1)};
+
+    std::ostringstream oss;
+    oss << "Completed " << progress_.count << " of " << range;
+    if(!progress_dialog_.Update(std::max(0, count), oss.str()))
+        {
+        progress_.cancel_requested = true;
+        }
+    return finished_;
+}
+
+/// Return the composite ledger of a finished run, or a null pointer
+/// if it was cancelled; rethrow any exception it ended with.
+
+std::shared_ptr<Ledger const> census_run::result()
+{
+    LMI_ASSERT(finished_);
+    worker_.join();
+    if(exception_)
+        {
+        std::rethrow_exception(exception_);
+        }
+    return completed_ ? composite_ : nullptr;
+}
+
+void census_run::run()
+{
+    fenv_initialize();
+    this_thread_census_run = &progress_;
+    set_thread_progress_meter_creator(census_run_progress_meter_creator);
+    try
+        {
+        illustrator z(emission_);
+        completed_ = z(base_filename_, cells_);
+        if(completed_)
+            {
+            composite_ = z.principal_ledger();
+            }
+        }
+    catch(...)
+        {
+        exception_ = std::current_exception();
+        }
+    set_thread_progress_meter_creator(nullptr);
+    this_thread_census_run = nullptr;
+    finished_ = true;
+}
+
 // class CensusView
 
 IMPLEMENT_DYNAMIC_CLASS(CensusView, ViewEx)
@@ -965,11 +1207,11 @@ BEGIN_EVENT_TABLE(CensusView, ViewEx)
     EVT_UPDATE_UI(XRCID("edit_case"            ),CensusView::UponUpdateAlwaysEnabled    )
     EVT_UPDATE_UI(XRCID("run_cell"             ),CensusView::UponUpdateSingleSelection  )
     EVT_UPDATE_UI(XRCID("run_class"            ),CensusView::UponUpdateSingleSelection  )
-    EVT_UPDATE_UI(XRCID("run_case"             ),CensusView::UponUpdateAlwaysEnabled    )
-    EVT_UPDATE_UI(XRCID("print_case"           ),CensusView::UponUpdateAlwaysEnabled    )
-    EVT_UPDATE_UI(XRCID("print_case_to_disk"   ),CensusView::UponUpdateAlwaysEnabled    )
-    EVT_UPDATE_UI(XRCID("print_spreadsheet"    ),CensusView::UponUpdateAlwaysEnabled    )
-    EVT_UPDATE_UI(XRCID("print_group_roster"   ),CensusView::UponUpdateAlwaysEnabled    )
+    EVT_UPDATE_UI(XRCID("run_case"             ),CensusView::UponUpdateUnlessRunning    )
+    EVT_UPDATE_UI(XRCID("print_case"           ),CensusView::UponUpdateUnlessRunning    )
+    EVT_UPDATE_UI(XRCID("print_case_to_disk"   ),CensusView::UponUpdateUnlessRunning    )
+    EVT_UPDATE_UI(XRCID("print_spreadsheet"    ),CensusView::UponUpdateUnlessRunning    )
+    EVT_UPDATE_UI(XRCID("print_group_roster"   ),CensusView::UponUpdateUnlessRunning    )
     EVT_UPDATE_UI(XRCID("print_group_quote"    ),CensusView::UponUpdateAlwaysDisabled   )
     EVT_UPDATE_UI(XRCID("copy_census"          ),CensusView::UponUpdateColumnValuesVary )
     EVT_UPDATE_UI(XRCID("paste_census"         ),CensusView::UponUpdateAlwaysEnabled    )
@@ -983,12 +1225,21 @@ BEGIN_EVENT_TABLE(CensusView, ViewEx)
     EVT_UPDATE_UI(wxID_PREVIEW                  ,CensusView::UponUpdateAlwaysDisabled   )
     EVT_UPDATE_UI(wxID_PAGE_SETUP               ,CensusView::UponUpdateAlwaysDisabled   )
     EVT_UPDATE_UI(XRCID("print_pdf"            ),CensusView::UponUpdateAlwaysDisabled   )
+    EVT_TIMER(wxID_ANY                          ,CensusView::UponCensusRunTimer         )
 END_EVENT_TABLE()
 
 CensusView::CensusView()
     :ViewEx            {}
     ,autosize_columns_ {false}
+    ,census_run_timer_ {this}
+{
+}
+
+/// Destroying census_run_ cancels any run in progress.
+
+CensusView::~CensusView()
 {
+    census_run_timer_.Stop();
 }
 
 inline std::vector<Input>& CensusView::case_parms()
@@ -1075,10 +1326,44 @@ Input* CensusView::class_parms_from_class_name(std::string const& class_name)
 
 bool CensusView::column_value_varies_across_cells(std::string const& header) const
 {
-    auto const z = case_parms()[0][header];
-    for(auto const& j : class_parms()) {if(z != j[header]) return true;}
-    for(auto const& j : cell_parms() ) {if(z != j[header]) return true;}
-    return false;
+    std::vector<std::string> const& all_headers(case_parms()[0].member_names());
+    auto const i = std::lower_bound(all_headers.begin(), all_headers.end(), header);
+    LMI_ASSERT(i != all_headers.end() && *i == header);
+    return 0 < column_variation_[std::distance(all_headers.begin(), i)];
+}
+
+/// Add (if 'delta' is 1) or remove (if -1) the given class or cell
+/// parameters' contribution to column_variation_.
+///
+/// Call this with -1 before changing any class or cell parameters,
+/// and with 1 afterward, so that the cost of maintaining the counts
+/// is proportional to the number of columns, not to the number of
+/// cells. Changing the case defaults invalidates every count: call
+/// recount_column_variation() then instead.
+
+void CensusView::tally_column_variation(Input const& parms, int delta)
+{
+    Input const& case_default = case_parms()[0];
+    std::vector<std::string> const& all_headers(case_default.member_names());
+    LMI_ASSERT(lmi::ssize(all_headers) == lmi::ssize(column_variation_));
+    for(int j = 0; j < lmi::ssize(all_headers); ++j)
+        {
+        if(case_default[all_headers[j]] != parms[all_headers[j]])
+            {
+            column_variation_[j] += delta;
+            LMI_ASSERT(0 <= column_variation_[j]);
+            }
+        }
+}
+
+/// Count, from scratch, the class and cell parameters that differ
+/// from the case defaults, for each column.
+
+void CensusView::recount_column_variation()
+{
+    column_variation_.assign(case_parms()[0].member_names().size(), 0);
+    for(auto const& j : class_parms()) {tally_column_variation(j, 1);}
+    for(auto const& j : cell_parms() ) {tally_column_variation(j, 1);}
 }
 
 wxWindow* CensusView::CreateChildWindow()
@@ -1115,6 +1400,7 @@ wxWindow* CensusView::CreateChildWindow()
 
     // Show headers.
     document().Modify(false);
+    recount_column_variation();
     Update();
 
     return grid_window_;
@@ -1213,9 +1499,11 @@ void CensusView::update_class_names()
         }
 
     // Replace the vector of class parameters with the one we rebuilt.
+    for(auto const& j : class_parms()) {tally_column_variation(j, -1);}
     class_parms().clear();
     std::insert_iterator<std::vector<Input>> iip(class_parms(), class_parms().begin());
     std::copy(rebuilt_class_parms.begin(), rebuilt_class_parms.end(), iip);
+    for(auto const& j : class_parms()) {tally_column_variation(j, 1);}
 }
 
 /// Ascertain differences between old and new parameters and apply
@@ -1223,6 +1511,13 @@ void CensusView::update_class_names()
 ///   if 'for_this_class_only' is specified, to all cells in the
 ///     employee class of the old parameters;
 ///   otherwise, to all cells in the entire census.
+///
+/// Only parameters that actually change are reconciled.
+///
+/// Changes to class defaults are tallied incrementally. Changes to
+/// the case defaults are not, because each count was taken against
+/// the old case defaults, which have already been replaced; the
+/// caller must call recount_column_variation() afterward.
 
 void CensusView::apply_changes
     (Input const& new_parms
@@ -1248,41 +1543,57 @@ void CensusView::apply_changes
             headers_of_changed_parameters.push_back(i);
             }
         }
-    for(auto const& i : headers_of_changed_parameters)
+    if(headers_of_changed_parameters.empty())
+        {
+        return;
+        }
+
+    auto const apply_to = [&](Input& parms)
         {
-        if(!for_this_class_only)
+        bool const affected = std::any_of
+            (headers_of_changed_parameters.begin()
+            ,headers_of_changed_parameters.end()
+            ,[&](std::string const& i) {return parms[i] != new_parms[i];}
+            );
+        if(!affected)
             {
-            for(auto& j : class_parms())
-                {
-                j[i] = new_parms[i].str();
-                }
-            for(auto& j : cell_parms())
-                {
-                j[i] = new_parms[i].str();
-                }
+            return;
             }
-        else
+        if(for_this_class_only)
             {
-            for(auto& j : cell_parms())
-                {
-                if(j["EmployeeClass"] == old_parms["EmployeeClass"])
-                    {
-                    j[i] = new_parms[i].str();
-                    }
-                }
+            tally_column_variation(parms, -1);
             }
-        }
+        for(auto const& i : headers_of_changed_parameters)
+            {
+            parms[i] = new_parms[i].str();
+            }
+        parms.Reconcile();
+        if(for_this_class_only)
+            {
+            tally_column_variation(parms, 1);
+            }
+        };
 
-    // Probably this should be factored out into a member function
-    // that's called elsewhere too--e.g., when a cell is read from
-    // file, or when a census is pasted.
-    for(auto& j : class_parms())
+    if(!for_this_class_only)
         {
-        j.Reconcile();
+        for(auto& j : class_parms())
+            {
+            apply_to(j);
+            }
+        for(auto& j : cell_parms())
+            {
+            apply_to(j);
+            }
         }
-    for(auto& j : cell_parms())
+    else
         {
-        j.Reconcile();
+        for(auto& j : cell_parms())
+            {
+            if(j["EmployeeClass"] == old_parms["EmployeeClass"])
+                {
+                apply_to(j);
+                }
+            }
         }
 }
 
@@ -1294,16 +1605,13 @@ void CensusView::update_visible_columns()
     // Reason: although the case and class defaults are hidden, they're
     // still information--so if the user made them different from any cell
     // wrt some column, we respect that conscious decision.
-    std::vector<std::string> const& all_headers(case_parms()[0].member_names());
     std::vector<int> new_visible_columns;
-    int column = 0;
-    for(auto const& header : all_headers)
+    for(int column = 0; column < lmi::ssize(column_variation_); ++column)
         {
-        if(column_value_varies_across_cells(header))
+        if(0 < column_variation_[column])
             {
             new_visible_columns.push_back(column);
             }
-        ++column;
         }
 
     if(new_visible_columns != grid_table_->get_visible_columns())
@@ -1359,7 +1667,10 @@ void CensusView::UponEditCell(wxCommandEvent&)
     Input& modifiable_parms = cell_parms()[cell_number];
     std::string const title = cell_title(cell_number);
 
-    if(oe_mvc_dv_changed == edit_parameters(modifiable_parms, title))
+    tally_column_variation(modifiable_parms, -1);
+    oenum_mvc_dv_rc const rc = edit_parameters(modifiable_parms, title);
+    tally_column_variation(modifiable_parms, 1);
+    if(oe_mvc_dv_changed == rc)
         {
         Update();
         document().Modify(true);
@@ -1374,7 +1685,10 @@ void CensusView::UponEditClass(wxCommandEvent&)
     Input const unmodified_parms(modifiable_parms);
     std::string const title = class_title(cell_number);
 
-    if(oe_mvc_dv_changed == edit_parameters(modifiable_parms, title))
+    tally_column_variation(modifiable_parms, -1);
+    oenum_mvc_dv_rc const rc = edit_parameters(modifiable_parms, title);
+    tally_column_variation(modifiable_parms, 1);
+    if(oe_mvc_dv_changed == rc)
         {
         int z = wxMessageBox
             ("Apply all changes to every cell in this class?"
@@ -1407,6 +1721,9 @@ void CensusView::UponEditCase(wxCommandEvent&)
             {
             apply_changes(modifiable_parms, unmodified_parms, false);
             }
+        // Changing the case defaults can change every count, whether
+        // or not the changes were applied to every cell.
+        recount_column_variation();
         Update();
         document().Modify(true);
         }
@@ -1467,6 +1784,13 @@ void CensusView::UponUpdateAlwaysEnabled(wxUpdateUIEvent& e)
     e.Enable(true);
 }
 
+/// Disable commands that run the census while a run is in progress.
+
+void CensusView::UponUpdateUnlessRunning(wxUpdateUIEvent& e)
+{
+    e.Enable(!census_run_);
+}
+
 void CensusView::UponUpdateSingleSelection(wxUpdateUIEvent& e)
 {
     // We consider that in absence of any selected rows, the current row is the
@@ -1546,7 +1870,7 @@ void CensusView::UponPrintCaseToDisk(wxCommandEvent&)
 
 void CensusView::UponRunCase(wxCommandEvent&)
 {
-    ViewComposite();
+    DoAllCells(mce_emit_nothing);
 }
 
 void CensusView::UponRunCell(wxCommandEvent&)
@@ -1567,11 +1891,6 @@ void CensusView::ViewOneCell(int index)
 
 void CensusView::ViewComposite()
 {
-    if(!DoAllCells(mce_emit_nothing))
-        {
-        return;
-        }
-
     std::string const name("composite");
     IllustrationView& illview = MakeNewIllustrationDocAndView
         (document().GetDocumentManager()
@@ -1584,19 +1903,99 @@ void CensusView::ViewComposite()
     illview.DisplaySelectedValuesAsHtml();
 }
 
-bool CensusView::DoAllCells(mcenum_emission emission)
+/// Run all cells, with the given emission.
+///
+/// Ordinarily, the run takes place on a worker thread, so that end
+/// users can continue to use other documents meanwhile; its results
+/// are published when UponCensusRunTimer() finds it has finished.
+/// Automated GUI tests expect a run to have finished when the command
+/// that started it returns, so they set a global flag to run in the
+/// foreground instead.
+
+void CensusView::DoAllCells(mcenum_emission emission)
 {
     test_census_consensus(emission, case_parms()[0], cell_parms());
 
-    illustrator z(emission);
-    if(!z(base_filename(), cell_parms()))
+    if(!global_settings::instance().census_in_background())
         {
-        // Cancelled during run_census::operator().
-        return false;
+        illustrator z(emission);
+        if(z(base_filename(), cell_parms()))
+            {
+            CensusRunCompleted(emission, z.principal_ledger());
+            }
+        // Otherwise, cancelled during run_census::operator().
+        return;
         }
 
-    composite_ledger_ = z.principal_ledger();
-    return true;
+    if(census_run_)
+        {
+        warning() << "A census run is already in progress." << LMI_FLUSH;
+        return;
+        }
+
+    census_run_ = std::make_unique<census_run>
+        (emission
+        ,base_filename()
+        ,cell_parms()
+        ,GetFrame()
+        );
+    census_run_timer_.Start(census_run::polling_interval_msec);
+}
+
+/// Publish the composite ledger of a completed census run, and, if
+/// nothing else was to be done with it, display it.
+
+void CensusView::CensusRunCompleted
+    (mcenum_emission               emission
+    ,std::shared_ptr<Ledger const> composite
+    )
+{
+    composite_ledger_ = composite;
+    if(mce_emit_nothing == emission)
+        {
+        ViewComposite();
+        }
+}
+
+/// Cancel any census run in progress, waiting for it to stop.
+
+void CensusView::CancelCensusRun()
+{
+    census_run_timer_.Stop();
+    census_run_.reset();
+}
+
+/// Show a census run's progress, and publish its results when done.
+///
+/// If the run ended in an exception, it's rethrown here, on the GUI
+/// thread, where it's reported like any other.
+
+void CensusView::UponCensusRunTimer(wxTimerEvent&)
+{
+    if(!census_run_ || !census_run_->poll())
+        {
+        return;
+        }
+
+    census_run_timer_.Stop();
+    std::unique_ptr<census_run> finished_run {std::move(census_run_)};
+    mcenum_emission const emission {finished_run->emission()};
+    std::shared_ptr<Ledger const> composite {finished_run->result()};
+    // Dismiss the progress dialog before showing any result.
+    finished_run.reset();
+    if(composite)
+        {
+        CensusRunCompleted(emission, composite);
+        }
+}
+
+/// Cancel any census run in progress before closing: the run's
+/// progress dialog is a child of this view's frame.
+
+bool CensusView::OnClose(bool delete_window)
+{
+    CancelCensusRun();
+    return ViewEx::OnClose(delete_window);
 }
 
 void CensusView::UponAddCell(wxCommandEvent&)
@@ -1605,6 +2004,7 @@ void CensusView::UponAddCell(wxCommandEvent&)
     Timer timer;
 
     cell_parms().push_back(case_parms()[0]);
+    tally_column_variation(cell_parms().back(), 1);
     grid_window_->AppendRows();
 
     Update();
@@ -1699,6 +2099,10 @@ void CensusView::UponDeleteCells(wxCommandEvent&)
         auto const count = block.GetBottomRow() - block.GetTopRow() + 1;
 
         auto const first = cell_parms().begin() + block.GetTopRow();
+        for(auto j = first; j != first + count; ++j)
+            {
+            tally_column_variation(*j, -1);
+            }
         cell_parms().erase(first, first + count);
         grid_window_->DeleteRows(block.GetTopRow(), count);
         }
@@ -1756,137 +2160,16 @@ void CensusView::UponRunCaseToGroupQuote(wxCommandEvent&)
 
 void CensusView::UponPasteCensus(wxCommandEvent&)
 {
-    std::string const census_data = ClipboardEx::GetText();
-
-    std::vector<std::string> headers;
-    std::vector<Input> cells;
-
-    std::istringstream iss_census(census_data);
-    iss_census.imbue(tab_is_not_whitespace_locale());
-    std::string line;
-
-    // Get header line; parse into field names.
-    if(std::getline(iss_census, line, '\n'))
-        {
-        iss_census >> std::ws;
-
-        std::istringstream iss_line(line);
-        std::string token;
-
-        while(std::getline(iss_line, token, '\t'))
-            {
-            headers.push_back(token);
-            }
-        }
-    else
-        {
-        warning() << "Error pasting census data: no header line." << LMI_FLUSH;
-        return;
-        }
-
-    // Use a modifiable copy of case defaults as an archetype for new
-    // cells to be created by pasting. Modifications are conditionally
-    // written back to case defaults later.
-    Input archetype(case_parms()[0]);
-
-    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
-    if(contains(headers, "UseDOB"))
-        {
-        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
-        }
-    bool const dob_pasted = contains(headers, "DateOfBirth");
-    bool const age_pasted = contains(headers, "IssueAge");
-    if(dob_pasted && age_pasted)
-        {
-        alarum()
-            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
-            << LMI_FLUSH
-            ;
-        }
-    else if(dob_pasted)
-        {
-        archetype["UseDOB"] = "Yes";
-        }
-    else if(age_pasted)
-        {
-        archetype["UseDOB"] = "No";
-        }
-    else
-        {
-        // Do nothing: neither age nor DOB pasted.
-        }
-
-    cells.reserve(std::count(census_data.begin(), census_data.end(), '\n'));
-
-    // Read each subsequent line into an input object representing one cell.
-    int current_line = 0;
-    while(std::getline(iss_census, line, '\n'))
-        {
-        ++current_line;
-
-        iss_census >> std::ws;
-
-        Input current_cell(archetype);
-
-        std::istringstream iss_line(line);
-        std::string token;
-        std::vector<std::string> values;
-
-        while(std::getline(iss_line, token, '\t'))
-            {
-            values.push_back(token);
-            }
-
-        if(values.size() != headers.size())
-            {
-            alarum()
-                << "Line #" << current_line << ": "
-                << "  (" << line << ") "
-                << "should have one value per column. "
-                << "Number of values: " << values.size() << "; "
-                << "number expected: " << headers.size() << "."
-                << LMI_FLUSH
-                ;
-            }
-
-        for(int j = 0; j < lmi::ssize(headers); ++j)
-            {
-            if(exact_cast<tnr_date>(current_cell[headers[j]]))
-                {
-                int constexpr jdn_min = calendar_date::gregorian_epoch_jdn;
-                int constexpr jdn_max = calendar_date::last_yyyy_date_jdn;
-                static int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
-                static int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
-                int z = value_cast<int>(values[j]);
-                if(jdn_min <= z && z <= jdn_max)
-                    {
-                    // Do nothing: JDN is the default expectation.
-                    }
-                else if(ymd_min <= z && z <= ymd_max)
-                    {
-                    z = YmdToJdn(ymd_t(z)).value();
-                    values[j] = value_cast<std::string>(z);
-                    }
-                else
-                    {
-                    alarum()
-                        << "Invalid date " << values[j]
-                        << " for '" << headers[j] << "'"
-                        << " on line " << current_line << "."
-                        << LMI_FLUSH
-                        ;
-                    }
-                }
-            current_cell[headers[j]] = values[j];
-            }
-        current_cell.Reconcile();
-        current_cell.RealizeAllSequenceInput();
-        cells.push_back(current_cell);
-
-        status() << "Added cell number " << cells.size() << '.' << std::flush;
-        }
+    Timer timer;
+    census_tsv pasted = read_census_tsv
+        (ClipboardEx::GetText()
+        ,case_parms()[0]
+        );
+    Input const& archetype = pasted.archetype;
+    std::vector<Input>& cells = pasted.cells;
 
-    if(0 == current_line)
+    int const n_pasted = lmi::ssize(cells);
+    if(0 == n_pasted)
         {
         warning() << "No cells to paste." << LMI_FLUSH;
         return;
@@ -1901,6 +2184,7 @@ void CensusView::UponPasteCensus(wxCommandEvent&)
         class_parms().clear();
         class_parms().push_back(archetype);
         cell_parms ().swap(cells);
+        recount_column_variation();
         }
     else if(configurable_settings::instance().census_paste_palimpsestically())
         {
@@ -1911,9 +2195,11 @@ void CensusView::UponPasteCensus(wxCommandEvent&)
         // each cell set to "Yes".
         for(auto& j : case_parms ()) {j["UseDOB"] = "Yes";}
         for(auto& j : class_parms()) {j["UseDOB"] = "Yes";}
+        recount_column_variation();
         }
     else
         {
+        for(auto const& j : cells) {tally_column_variation(j, 1);}
         cell_parms().reserve(cell_parms().size() + cells.size());
         std::back_insert_iterator<std::vector<Input>> iip(cell_parms());
         std::copy(cells.begin(), cells.end(), iip);
@@ -1942,6 +2228,12 @@ void CensusView::UponPasteCensus(wxCommandEvent&)
     LMI_ASSERT(1 == case_parms().size());
     LMI_ASSERT(!cell_parms ().empty());
     LMI_ASSERT(!class_parms().empty());
+
+    status()
+        << "Paste " << n_pasted << " cells: "
+        << timer.stop().elapsed_msec_str()
+        << std::flush
+        ;
 }
 
 /// Copy from census manager to clipboard and TSV file.
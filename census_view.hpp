@@ -32,13 +32,15 @@
 #include "oecumenic_enumerations.hpp"
 
 #include <wx/object.h>                  // wxObjectDataPtr
+#include <wx/timer.h>
 
-#include <memory>                       // shared_ptr
+#include <memory>                       // shared_ptr, unique_ptr
 #include <string>
 #include <vector>
 
 class CensusDocument;
 class CensusViewGridTable;
+class census_run;
 
 class WXDLLIMPEXP_FWD_ADV wxGrid;
 class WXDLLIMPEXP_FWD_ADV wxGridEvent;
@@ -52,6 +54,7 @@ class CensusView final
 
   public:
     CensusView();
+    ~CensusView() override;
 
   private:
     CensusView(CensusView const&) = delete;
@@ -66,6 +69,9 @@ class CensusView final
     char const* icon_xrc_resource   () const override;
     char const* menubar_xrc_resource() const override;
 
+    // wxView overrides.
+    bool OnClose(bool delete_window) override;
+
     // Event handlers, in event-table order (reflecting GUI order)
     void UponRightClick             (wxGridEvent&);
     void UponValueChanged           (wxGridEvent&);
@@ -90,8 +96,12 @@ class CensusView final
     void UponUpdateAlwaysEnabled    (wxUpdateUIEvent&);
     void UponUpdateSingleSelection  (wxUpdateUIEvent&);
     void UponUpdateColumnValuesVary (wxUpdateUIEvent&);
+    void UponUpdateUnlessRunning    (wxUpdateUIEvent&);
+    void UponCensusRunTimer         (wxTimerEvent&);
 
-    bool DoAllCells(mcenum_emission);
+    void DoAllCells(mcenum_emission);
+    void CensusRunCompleted(mcenum_emission, std::shared_ptr<Ledger const>);
+    void CancelCensusRun();
 
     void Update();
     void ViewOneCell(int);
@@ -116,6 +126,8 @@ class CensusView final
     Input* class_parms_from_class_name(std::string const&);
 
     bool column_value_varies_across_cells(std::string const& header) const;
+    void tally_column_variation(Input const&, int delta);
+    void recount_column_variation();
 
     oenum_mvc_dv_rc edit_parameters
         (Input&             parameters
@@ -130,8 +142,16 @@ class CensusView final
 
     bool autosize_columns_;
 
+    // For each column, in member_names() order, the number of class
+    // and cell parameters that differ from the case defaults.
+    std::vector<int> column_variation_;
+
     std::shared_ptr<Ledger const> composite_ledger_;
 
+    // Census run in progress on a worker thread, if any.
+    std::unique_ptr<census_run> census_run_;
+    wxTimer                     census_run_timer_;
+
     wxGrid*              grid_window_ {nullptr};
     CensusViewGridTable* grid_table_  {nullptr};
 
@@ -32,6 +32,7 @@
 #include "lmi.hpp"                      // is_antediluvian_fork()
 #include "oecumenic_enumerations.hpp"   // methuselah
 #include "product_data.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
 #include "round_to.hpp"
 #include "ssize_lmi.hpp"
 #include "yare_input.hpp"
@@ -95,6 +96,32 @@ database_index product_database::index() const
     return index_;
 }
 
+namespace
+{
+/// Write an entity's data for the given index into a vector of the
+/// given length, replicating the last duration's value as needed.
+
+void extend_to_length
+    (database_entity const& v
+    ,database_index  const& i
+    ,int                    length
+    ,std::vector<double>&   dst
+    )
+{
+    double const*const z = v[i];
+    if(1 == v.extent())
+        {
+        dst.assign(length, *z);
+        }
+    else
+        {
+        dst.reserve(length);
+        dst.assign(z, z + std::min(length, v.extent()));
+        dst.resize(length, dst.back());
+        }
+}
+} // Unnamed namespace.
+
 /// Query database; write result into vector argument.
 
 void product_database::query_into
@@ -105,18 +132,7 @@ void product_database::query_into
 {
     int const local_length = maturity_age_ - i.issue_age();
     LMI_ASSERT(0 < local_length && local_length <= methuselah);
-    database_entity const& v = entity_from_key(k);
-    double const*const z = v[i];
-    if(1 == v.extent())
-        {
-        dst.assign(local_length, *z);
-        }
-    else
-        {
-        dst.reserve(local_length);
-        dst.assign(z, z + std::min(local_length, v.extent()));
-        dst.resize(local_length, dst.back());
-        }
+    extend_to_length(entity_from_key(k), i, local_length, dst);
 }
 
 /// Query database, using default index; write to vector<double> argument.
@@ -126,6 +142,22 @@ void product_database::query_into(e_database_key k, std::vector<double>& dst) co
     return query_into(k, dst, index_);
 }
 
+/// Query database for several keys, using default index; write each
+/// result into the vector paired with its key.
+///
+/// Equivalent to calling query_into() for each pair in turn, but the
+/// index and length are resolved only once.
+
+void product_database::query_many(query_list queries) const
+{
+    DBDictionary const& d = db();
+    for(auto const& i : queries)
+        {
+        LMI_ASSERT(nullptr != i.second);
+        extend_to_length(d.datum(i.first), index_, length_, *i.second);
+        }
+}
+
 /// Query database, using default index; write to currency& argument.
 ///
 /// Throws if conversion from double to currency (nearest cent)
@@ -246,8 +278,7 @@ void product_database::initialize(std::string const& product_name)
         }
     else
         {
-        std::string const f = filename_from_product_name(product_name);
-        product_data const& p(*product_data::read_via_cache(f));
+        product_data const& p(*read_product_via_cache(product_name));
         std::string const filename(p.datum("DatabaseFilename"));
         LMI_ASSERT(!filename.empty());
         db_ = DBDictionary::read_via_cache(AddDataDir(filename));
@@ -266,5 +297,5 @@ DBDictionary const& product_database::db() const
 
 database_entity const& product_database::entity_from_key(e_database_key k) const
 {
-    return db().datum(db_name_from_key(k));
+    return db().datum(k);
 }
@@ -30,9 +30,11 @@
 #include "mc_enum_type_enums.hpp"
 #include "so_attributes.hpp"
 
+#include <initializer_list>
 #include <memory>                       // shared_ptr
 #include <string>
 #include <type_traits>                  // is_integral_v, underlying_type_t
+#include <utility>                      // pair
 #include <vector>
 
 class currency;
@@ -61,6 +63,8 @@ class LMI_SO product_database final
     explicit product_database(yare_input const&);
     product_database(product_database &&) = default;
     product_database(product_database const&) = default;
+    product_database& operator=(product_database &&) = default;
+    product_database& operator=(product_database const&) = default;
     ~product_database() = default;
 
     int length() const;
@@ -73,6 +77,10 @@ class LMI_SO product_database final
         ) const;
     void query_into(e_database_key, std::vector<double>&) const;
 
+    using query_list = std::initializer_list
+        <std::pair<e_database_key,std::vector<double>*>>;
+    void query_many(query_list) const;
+
     void query_into(e_database_key, currency&) const;
     void query_into(e_database_key, std::vector<currency>&) const;
 
@@ -94,14 +102,12 @@ class LMI_SO product_database final
         ,length_ {length}
         {}
 
-    product_database& operator=(product_database const&) = delete;
-
     void initialize(std::string const& product_name);
 
     DBDictionary const& db() const;
     database_entity const& entity_from_key(e_database_key) const;
 
-    database_index const index_;
+    database_index       index_;
     int                  length_;
     int                  maturity_age_;
 
@@ -112,6 +112,20 @@ database_entity& DBDictionary::datum(std::string const& name)
     return *member_cast<database_entity>(operator[](name));
 }
 
+/// Member datum nominated by the given key.
+///
+/// This is what illustrations use: it's a simple array lookup, so
+/// it costs much less than looking up the corresponding name. Keys
+/// that don't name any member (e.g., DB_Topic_Underwriting) are
+/// looked up by name, just to provoke the usual diagnostic.
+
+database_entity const& DBDictionary::datum(e_database_key k) const
+{
+    LMI_ASSERT(DB_FIRST <= k && k < DB_LAST);
+    database_entity const* z = entities_[k];
+    return z ? *z : datum(db_name_from_key(k));
+}
+
 void DBDictionary::ascribe_members()
 {
     ascribe("MinIssAge"                 , &DBDictionary::MinIssAge                 );
@@ -617,6 +631,11 @@ void DBDictionary::ascribe_members()
     ascribe("GdbVxMethod"               , &DBDictionary::GdbVxMethod               );
     ascribe("PrimaryHurdle"             , &DBDictionary::PrimaryHurdle             );
     ascribe("SecondaryHurdle"           , &DBDictionary::SecondaryHurdle           );
+
+    for(auto const& i : member_names())
+        {
+        entities_[db_key_from_name(i)] = &datum(i);
+        }
 }
 
 /// Read a database file.
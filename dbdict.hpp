@@ -26,11 +26,13 @@
 
 #include "any_member.hpp"
 #include "cache_file_reads.hpp"
+#include "dbnames.hpp"                  // e_database_key
 #include "dbvalue.hpp"
 #include "path.hpp"
 #include "so_attributes.hpp"
 #include "xml_serializable.hpp"
 
+#include <array>
 #include <string>
 
 /// Cached product database.
@@ -43,6 +45,7 @@ class LMI_SO DBDictionary
     friend class DatabaseDocument;
     friend class input_test;        // For test_product_database().
     friend class premium_tax_test;  // For test_rates().
+    friend class product_snapshot;
 
   public:
     DBDictionary();
@@ -51,6 +54,7 @@ class LMI_SO DBDictionary
     ~DBDictionary() override = default;
 
     database_entity const& datum(std::string const&) const;
+    database_entity const& datum(e_database_key) const;
 
     static void write_database_files();
     static void write_proprietary_database_files();
@@ -92,6 +96,9 @@ class LMI_SO DBDictionary
         ,std::string const&     file_basename
         ) const override;
 
+    // Members indexed by e_database_key, for lookup without names.
+    std::array<database_entity const*,DB_LAST> entities_ {};
+
     // To make sure these members match e_database_key enumerators:
     //   <dbdict.hpp sed -e '/database_entity [A-Z]/!d;s/    database_entity //;s/ *;$//' >eraseme0
     //   <dbnames.hpp sed -e '/        ,DB_/!d;s/        ,DB_//' >eraseme1
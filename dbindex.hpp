@@ -116,7 +116,7 @@ class database_index
         LMI_ASSERT(0 <= issue_age() && issue_age() < e_max_dim_issue_age);
     }
 
-    std::array<int,number_of_indices> const idx_;
+    std::array<int,number_of_indices> idx_;
 };
 
 #endif // dbindex_hpp
@@ -27,7 +27,6 @@
 #include "assert_lmi.hpp"
 #include "contains.hpp"
 #include "dbnames.hpp"
-#include "et_vector.hpp"
 #include "handle_exceptions.hpp"        // report_exception()
 #include "print_matrix.hpp"
 #include "value_cast.hpp"
@@ -53,6 +52,7 @@ database_entity::database_entity()
     ,data_values_  (1)
 {
     assert_invariants();
+    set_strides();
 }
 
 /// Handy ctor for writing programs to generate '.database' files.
@@ -70,6 +70,7 @@ database_entity::database_entity
     axis_lengths_ .assign(dims, dims + ndims);
     data_values_  .assign(data, data + getndata());
     assert_invariants();
+    set_strides();
 }
 
 database_entity::database_entity
@@ -84,6 +85,7 @@ database_entity::database_entity
     ,gloss_        {gloss}
 {
     assert_invariants();
+    set_strides();
 }
 
 /// Handy ctor for scalar data.
@@ -99,6 +101,7 @@ database_entity::database_entity
     axis_lengths_ .assign(ScalarDims, ScalarDims + e_number_of_axes);
     data_values_  .push_back(datum);
     assert_invariants();
+    set_strides();
 }
 
 #if 0
@@ -184,47 +187,36 @@ void database_entity::reshape(std::vector<int> const& new_dims)
     LMI_ASSERT(1 == new_dims[5] || e_max_dim_state     == new_dims[5]);
     LMI_ASSERT(1 <= new_dims[6] && new_dims[6] <= e_max_dim_duration);
 
-    // Number of times we'll go through the assignment loop.
-    int n_iter = getndata(new_dims);
+    database_entity new_object(key(), new_dims, std::vector<double>(getndata(new_dims)));
 
-    // Create a new instance of this class having the same key but the
-    // desired dimensions, for convenient use of operator[]().
-    std::vector<double> new_data(n_iter);
-    database_entity new_object(key(), new_dims, new_data);
-
-    std::vector<int> dst_max_idx(e_number_of_axes);
-    assign(dst_max_idx, new_dims - 1);
-
-    std::vector<int> src_max_idx(e_number_of_axes);
-    assign(src_max_idx, axis_lengths_ - 1);
-
-    std::vector<int> dst_idx(e_number_of_axes); // indexes new_object
-    std::vector<int> src_idx(e_number_of_axes); // indexes '*this'
-
-    std::vector<int> working_idx(e_number_of_axes);
-    for(int j = 0; j < n_iter; ++j)
+    // Visit each element of the new object in storage order, copying
+    // the corresponding element of '*this'--i.e., along each axis,
+    // the element with the same index, or the last element if there
+    // are fewer. Broadcast (zero) strides make that the only element
+    // along any axis that doesn't vary.
+    std::array<int,e_number_of_axes> idx {};
+    for(auto& d : new_object.data_values_)
         {
-        int z = j;
-        std::vector<int>::const_iterator i = new_dims.begin();
-        std::vector<int>::iterator w = working_idx.begin();
-        while(i != new_dims.end())
+        int z = 0;
+        for(int j = 0; j < e_number_of_axes; ++j)
             {
-            LMI_ASSERT(0 != *i);
-            *w = z % *i;
-            z /= *i;
-            ++i;
-            ++w;
+            z += strides_[j] * std::min(idx[j], axis_lengths_[j] - 1);
+            }
+        d = data_values_[z];
+        // Advance the index: the last axis varies most rapidly.
+        for(int j = e_number_of_axes - 1; 0 <= j; --j)
+            {
+            if(++idx[j] < new_dims[j])
+                {
+                break;
+                }
+            idx[j] = 0;
             }
-        LMI_ASSERT(0 == z);
-
-        // limit dst and source indexes to those that actually vary
-        assign(dst_idx, Min(working_idx, dst_max_idx));
-        assign(src_idx, Min(working_idx, src_max_idx));
-        new_object[dst_idx] = operator[](src_idx);
         }
 
     axis_lengths_ = new_dims;
     data_values_  = new_object.data_values_;
+    strides_      = new_object.strides_;
     assert_invariants();
 }
 
@@ -244,11 +236,8 @@ double& database_entity::operator[](std::vector<int> const& index)
     int z = 0;
     for(int j = 0; j < e_number_of_axes; ++j)
         {
-        if(1 != axis_lengths_[j])
-            {
-            LMI_ASSERT(index[j] < axis_lengths_[j]);
-            z = z * axis_lengths_[j] + index[j];
-            }
+        LMI_ASSERT(0 == strides_[j] || index[j] < axis_lengths_[j]);
+        z += strides_[j] * index[j];
         }
     if(static_cast<int>(data_values_.size()) <= z)
         {
@@ -271,15 +260,11 @@ double const* database_entity::operator[](database_index const& idx) const
     LMI_ASSERT(e_number_of_axes == 1 + index.size());
 
     int z = 0;
-    for(int j = 0; j < e_number_of_axes - 1; ++j)
+    for(int j = 0; j < number_of_indices; ++j)
         {
-        if(1 != axis_lengths_[j])
-            {
-            LMI_ASSERT(index[j] < axis_lengths_[j]);
-            z = z * axis_lengths_[j] + index[j];
-            }
+        LMI_ASSERT(0 == strides_[j] || index[j] < axis_lengths_[j]);
+        z += strides_[j] * index[j];
         }
-    z *= axis_lengths_.back();
     if(static_cast<int>(data_values_.size()) <= z)
         {
         z = 0;
@@ -397,6 +382,22 @@ void database_entity::assert_invariants() const
             }
 }
 
+/// Precompute strides for indexing.
+///
+/// Storage is row-major, so the last (duration) axis has unit stride
+/// unless it has only one element. An axis with only one element has
+/// a stride of zero, so that any index along it selects that element.
+
+void database_entity::set_strides()
+{
+    int stride = 1;
+    for(int j = e_number_of_axes - 1; 0 <= j; --j)
+        {
+        strides_[j] = (1 == axis_lengths_[j]) ? 0 : stride;
+        stride *= axis_lengths_[j];
+        }
+}
+
 /// Calculate number of data required by lengths of object's axes.
 
 int database_entity::getndata() const
@@ -460,6 +461,7 @@ void database_entity::read(xml::element const& e)
     xml_serialize::get_element(e, "gloss"       , gloss_       );
 
     assert_invariants();
+    set_strides();
 }
 
 void database_entity::write(xml::element& e) const
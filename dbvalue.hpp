@@ -28,6 +28,7 @@
 #include "so_attributes.hpp"
 #include "xml_lmi_fwd.hpp"
 
+#include <array>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -50,9 +51,15 @@ namespace xml_serialize {template<typename T> struct xml_io;}
 /// all axes. In a typical query, all other axes are single-valued,
 /// but all durations are wanted; this axis ordering puts consecutive
 /// durational values in contiguous storage for efficient retrieval.
+///
+/// The offset of each datum is a dot product of its index with a
+/// set of strides, which are precomputed whenever the shape changes.
+/// An axis along which the entity doesn't vary has a stride of zero,
+/// so that every index along it selects the same data.
 
 class LMI_SO database_entity final
 {
+    friend class product_snapshot;
     friend struct xml_serialize::xml_io<database_entity>;
 
   public:
@@ -92,6 +99,7 @@ class LMI_SO database_entity final
 
   private:
     void assert_invariants() const;
+    void set_strides();
     int getndata() const;
     static int getndata(std::vector<int> const&);
 
@@ -103,6 +111,8 @@ class LMI_SO database_entity final
     std::vector<double> data_values_;
     // Glosses are deprecated.
     std::string         gloss_;
+
+    std::array<int,e_number_of_axes> strides_ {};
 };
 
 LMI_SO std::vector<int> const& maximum_database_dimensions();
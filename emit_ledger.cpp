@@ -35,6 +35,7 @@
 #include "miscellany.hpp"               // ios_out_trunc_binary()
 #include "path.hpp"
 #include "path_utility.hpp"             // unique_filepath()
+#include "pdf_render_pool.hpp"
 #include "timer.hpp"
 
 #include <iostream>
@@ -98,6 +99,11 @@ double ledger_emitter::initiate()
         {
         group_quote_pdf_gen_ = group_quote_pdf_generator::create();
         }
+    // Only census runs, which call finish(), use helper processes.
+    if((emission_ & mce_emit_pdf_file) && pdf_render_pool::enabled())
+        {
+        pdf_render_pool_ = std::make_unique<pdf_render_pool>();
+        }
 
     return timer.stop().elapsed_seconds();
 }
@@ -117,7 +123,14 @@ double ledger_emitter::emit_cell
 
     if(emission_ & mce_emit_pdf_file)
         {
-        write_ledger_as_pdf(ledger, cell_filepath);
+        if(pdf_render_pool_)
+            {
+            pdf_render_pool_->submit(ledger, pdf_out_filepath(cell_filepath));
+            }
+        else
+            {
+            write_ledger_as_pdf(ledger, cell_filepath);
+            }
         }
     if(emission_ & mce_emit_pdf_to_printer)
         {
@@ -204,10 +217,42 @@ double ledger_emitter::finish()
         {
         group_quote_pdf_gen_->save(case_filepath_group_quote_.string());
         }
+    if(pdf_render_pool_)
+        {
+        pdf_render_pool_->finish();
+        }
 
     return timer.stop().elapsed_seconds();
 }
 
+/// Whether any output to be emitted shows the guaranteed premium.
+///
+/// Solving for that premium can cost more than all other calculations
+/// for a cell together, so census runs omit it when it is not needed.
+/// If nothing is to be emitted, the caller presumably wants the
+/// ledgers for some other purpose (e.g., to display the composite),
+/// so every value must be calculated.
+
+bool ledger_emitter::needs_guar_prem() const
+{
+    int const readers =
+          mce_emit_pdf_file
+        | mce_emit_pdf_to_printer
+        | mce_emit_pdf_to_viewer
+        | mce_emit_test_data
+        | mce_emit_text_stream
+        | mce_emit_calculation_summary_html
+        | mce_emit_calculation_summary_tsv
+        ;
+    int const modifiers =
+          mce_emit_composite_only
+        | mce_emit_quietly
+        | mce_emit_to_pwd
+        | mce_emit_timings
+        ;
+    return (emission_ & readers) || !(emission_ & ~modifiers);
+}
+
 /// Emit a single ledger in various guises.
 ///
 /// Return time spent, which is almost always wanted.
@@ -32,6 +32,7 @@
 
 class Ledger;
 class group_quote_pdf_generator;
+class pdf_render_pool;
 
 /// Emit a group of ledgers in various guises.
 ///
@@ -48,6 +49,8 @@ class LMI_SO ledger_emitter final
     double emit_cell(fs::path const& cell_filepath, Ledger const& ledger);
     double finish   ();
 
+    bool needs_guar_prem() const;
+
   private:
     ledger_emitter(ledger_emitter const&) = delete;
     ledger_emitter& operator=(ledger_emitter const&) = delete;
@@ -64,6 +67,10 @@ class LMI_SO ledger_emitter final
 
     // Used only if emission_ includes mce_emit_group_quote; empty otherwise.
     std::unique_ptr<group_quote_pdf_generator> group_quote_pdf_gen_;
+
+    // Used only if emission_ includes mce_emit_pdf_file and helper
+    // processes have been configured; empty otherwise.
+    std::unique_ptr<pdf_render_pool> pdf_render_pool_;
 };
 
 LMI_SO double emit_ledger
@@ -26,6 +26,7 @@
 #include "alert.hpp"
 #include "force_linking.hpp"
 #include "path.hpp"
+#include "wx_utility.hpp"               // CallOnGuiThread()
 
 #include <wx/mimetype.h>
 #include <wx/utils.h>                   // wxExecute()
@@ -39,7 +40,7 @@ LMI_FORCE_LINKING_IN_SITU(file_command_wx)
 
 namespace
 {
-void concrete_file_command
+void execute_file_command
     (std::string const& file
     ,std::string const& action
     )
@@ -111,6 +112,17 @@ void concrete_file_command
         }
 }
 
+/// Census runs may be performed on a worker thread, but wx is not
+/// thread-safe, so delegate to the GUI thread.
+
+void concrete_file_command
+    (std::string const& file
+    ,std::string const& action
+    )
+{
+    CallOnGuiThread([&] {execute_file_command(file, action);});
+}
+
 /// See:
 ///   http://groups.google.com/groups?selm=1006352851.15484.0.nnrp-08.3e31d362@news.demon.co.uk
 /// and Kanze's reply:
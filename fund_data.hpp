@@ -61,6 +61,8 @@ class LMI_SO FundInfo final
 class LMI_SO FundData final
     :public cache_file_reads<FundData>
 {
+    friend class product_snapshot;
+
   public:
     explicit FundData(fs::path const& a_Filename);
 
@@ -77,6 +77,32 @@ void global_settings::set_regression_testing(bool b)
     regression_testing_ = b;
 }
 
+void global_settings::set_census_in_background(bool b)
+{
+    census_in_background_ = b;
+}
+
+void global_settings::set_cache_ledgers(bool b)
+{
+    cache_ledgers_ = b;
+}
+
+/// Set the directory where cached ledgers are stored on disk,
+/// creating it if necessary; or, if the argument is empty, cache
+/// ledgers in memory only.
+
+void global_settings::set_ledger_cache_directory(std::string const& s)
+{
+    if(s.empty())
+        {
+        ledger_cache_directory_.clear();
+        return;
+        }
+    fs::create_directory(fs::path(s));
+    validate_directory(s, "Ledger cache directory");
+    ledger_cache_directory_ = fs::absolute(s);
+}
+
 void global_settings::set_data_directory(std::string const& s)
 {
     validate_directory(s, "Data directory");
@@ -113,6 +139,21 @@ bool global_settings::regression_testing() const
     return regression_testing_;
 }
 
+bool global_settings::census_in_background() const
+{
+    return census_in_background_;
+}
+
+bool global_settings::cache_ledgers() const
+{
+    return cache_ledgers_;
+}
+
+fs::path const& global_settings::ledger_cache_directory() const
+{
+    return ledger_cache_directory_;
+}
+
 fs::path const& global_settings::data_directory() const
 {
     return data_directory_;
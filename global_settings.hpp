@@ -54,6 +54,21 @@
 /// haven't approved a product, because it is important to test new
 /// products before approval.
 ///
+/// census_in_background_: Run census illustrations in the GUI on a
+/// worker thread, so that the GUI remains responsive. GUI tests turn
+/// this off, because they expect each command to finish before they
+/// examine its results.
+///
+/// cache_ledgers_: Reuse the ledger of an identical illustration
+/// calculated earlier in the same session, instead of calculating it
+/// anew; see class ledger_cache. Off by default, because a reused
+/// ledger doesn't repeat any diagnostics its calculation issued.
+///
+/// ledger_cache_directory_: If not empty, the directory where cached
+/// ledgers are also stored on disk, so that they can be reused by
+/// other processes, as long as cache_ledgers_ is true. Empty by
+/// default, so that the cache is held in memory only.
+///
 /// data_directory_: Path to data files, initialized to ".", not an
 /// empty string. Reason: objects of the std::filesystem library's
 /// path class are created from these strings, which, if the strings
@@ -77,6 +92,9 @@ class LMI_SO global_settings final
     void set_pyx                      (std::string const&);
     void set_custom_io_0              (bool);
     void set_regression_testing       (bool);
+    void set_census_in_background     (bool);
+    void set_cache_ledgers            (bool);
+    void set_ledger_cache_directory   (std::string const&);
     void set_data_directory           (std::string const&);
     void set_prospicience_date        (calendar_date const&);
 
@@ -85,6 +103,9 @@ class LMI_SO global_settings final
     std::string const&   pyx                      () const;
     bool                 custom_io_0              () const;
     bool                 regression_testing       () const;
+    bool                 census_in_background     () const;
+    bool                 cache_ledgers            () const;
+    fs::path const&      ledger_cache_directory   () const;
     fs::path const&      data_directory           () const;
     calendar_date const& prospicience_date        () const;
 
@@ -99,6 +120,9 @@ class LMI_SO global_settings final
     std::string pyx_                 {};
     bool custom_io_0_                {false};
     bool regression_testing_         {false};
+    bool census_in_background_       {true};
+    bool cache_ledgers_              {false};
+    fs::path ledger_cache_directory_ {};
     fs::path data_directory_         {fs::absolute(".")};
     calendar_date prospicience_date_ {last_yyyy_date()};
 };
@@ -47,6 +47,7 @@
 #include "path_utility.hpp"             // unique_filepath(), fs::path inserter
 #include "premium_tax.hpp"
 #include "product_data.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
 #include "round_to.hpp"
 #include "ssize_lmi.hpp"
 #include "stratified_algorithms.hpp"    // TieredGrossToNet()
@@ -126,8 +127,8 @@ if(avoid_warning)
     double                      Payment                      = exact_cast<tnr_nonnegative_double  >(input["Payment"                     ])->value();
     double                      BenefitAmount                = exact_cast<tnr_nonnegative_double  >(input["BenefitAmount"               ])->value();
 
-    // DATABASE !! consider caching these product files
-    product_data product_filenames(ProductName);
+    auto const product(read_product_via_cache(ProductName));
+    product_data const& product_filenames = *product;
 
     product_database database
         (ProductName
@@ -139,7 +140,8 @@ if(avoid_warning)
         ,StateOfJurisdiction
         );
 
-    stratified_charges stratified(AddDataDir(product_filenames.datum("TierFilename")));
+    auto const stratified_data(stratified_charges::read_via_cache(AddDataDir(product_filenames.datum("TierFilename"))));
+    stratified_charges const& stratified = *stratified_data;
 
     // SOMEDAY !! Ideally these would be in the GUI (or read from product files).
     round_to<double> const RoundNonMecPrem  (2, r_downward);
@@ -490,6 +492,17 @@ bool gpt_server::operator()(fs::path const& file_path)
         seconds_for_input_ = timer.stop().elapsed_seconds();
         return operator()(file_path, doc.input_data());
         }
+    else if(".gpts" == extension)
+        {
+        alarum()
+            << "File '"
+            << file_path
+            << "': batch mode is not yet supported for the guideline"
+            << " premium test, which doesn't yet compute its state."
+            << LMI_FLUSH
+            ;
+        return false;
+        }
     else
         {
         alarum()
@@ -40,6 +40,10 @@ class gpt_input;
 /// a distinct enumeration seems unwarranted, especially because
 /// explaining another one in '--help' would be too complicated.
 /// Enumerators that don't make sense can be reported at run time.
+///
+/// A '.gpts' file would be a tab-delimited batch of many contracts'
+/// input, like a '.mecs' file; it is rejected for now, because this
+/// server doesn't yet compute the guideline premium test's state.
 
 class LMI_SO gpt_server final
 {
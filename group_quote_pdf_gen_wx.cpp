@@ -41,7 +41,7 @@
 #include "ssize_lmi.hpp"
 #include "version.hpp"
 #include "wx_table_generator.hpp"
-#include "wx_utility.hpp"               // ConvertDateToWx()
+#include "wx_utility.hpp"               // CallOnGuiThread(), ConvertDateToWx()
 #include "wx_workarounds.hpp"           // wxDCTextColorChanger
 
 #include <wx/datetime.h>
@@ -231,6 +231,9 @@ class group_quote_pdf_generator_wx
     void save(std::string const& output_filename) override;
 
   private:
+    void do_add_ledger(Ledger const& ledger);
+    void do_save(std::string const& output_filename);
+
     // This value is arbitrary and can be changed to conform to subjective
     // preferences.
     static int const vert_skip = 12;
@@ -460,7 +463,20 @@ void group_quote_pdf_generator_wx::global_report_data::fill_global_report_data
     extra_fields_     = parse_extra_report_fields(invar.Comments);
 }
 
+/// Census runs may be performed on a worker thread, but wx is not
+/// thread-safe, so delegate to the GUI thread.
+
 void group_quote_pdf_generator_wx::add_ledger(Ledger const& ledger)
+{
+    CallOnGuiThread([&] {do_add_ledger(ledger);});
+}
+
+void group_quote_pdf_generator_wx::save(std::string const& output_filename)
+{
+    CallOnGuiThread([&] {do_save(output_filename);});
+}
+
+void group_quote_pdf_generator_wx::do_add_ledger(Ledger const& ledger)
 {
     if(0 == ledger.GetCurrFull().LapseYear)
         {
@@ -626,7 +642,7 @@ void group_quote_pdf_generator_wx::add_ledger(Ledger const& ledger)
         }
 }
 
-void group_quote_pdf_generator_wx::save(std::string const& output_filename)
+void group_quote_pdf_generator_wx::do_save(std::string const& output_filename)
 {
     pdf_writer_wx pdf_writer
         (output_filename
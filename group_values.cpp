@@ -33,7 +33,6 @@
 #include "fenv_guard.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
-#include "ledgervalues.hpp"
 #include "materially_equal.hpp"
 #include "mc_enum_types_aux.hpp"        // mc_str()
 #include "path_utility.hpp"
@@ -41,6 +40,7 @@
 #include "ssize_lmi.hpp"
 #include "timer.hpp"
 #include "value_cast.hpp"
+#include "yare_input.hpp"
 
 // Headers required only for dtors of objects held by std::unique_ptr.
 #include "death_benefits.hpp"
@@ -55,7 +55,10 @@
 
 #include <algorithm>                    // max()
 #include <iterator>                     // back_inserter()
+#include <map>
+#include <memory>                       // make_unique()
 #include <string>
+#include <unordered_map>
 
 namespace
 {
@@ -67,6 +70,35 @@ bool cell_should_be_ignored(Input const& cell)
         ;
 }
 
+/// Index of the cell whose ledger each cell can reuse.
+///
+/// Cells that differ only in presentation (see
+/// Input::differs_only_in_presentation()) produce the same ledger,
+/// except for the text that Ledger::WithPresentationText() replaces,
+/// so only the first of them need be calculated. The result maps
+/// every other such cell to that first one, and each remaining cell
+/// to itself. Cells that are ignored, or that request any
+/// "idiosyncrasy" (which may write a monthly trace for each cell,
+/// e.g.), are always mapped to themselves.
+
+std::vector<int> calculation_sources(std::vector<Input> const& cells)
+{
+    std::vector<int> z(cells.size());
+    std::unordered_map<std::string,int> first_cell;
+    for(int j = 0; j < lmi::ssize(cells); ++j)
+        {
+        z[j] = j;
+        if
+            (   !cell_should_be_ignored(cells[j])
+            &&  !contains(cells[j]["Comments"].str(), "idiosyncrasy")
+            )
+            {
+            z[j] = first_cell.try_emplace(cells[j].calculation_fingerprint(), j).first->second;
+            }
+        }
+    return z;
+}
+
 /// Number of seconds to pause between printouts.
 ///
 /// Motivation: lmi sends illustrations to a printer in census order,
@@ -130,10 +162,31 @@ census_run_result run_census_in_series::operator()
 {
     Timer timer;
     census_run_result result;
+
+    // Calculate each distinct cell only once. A calculated ledger is
+    // retained only until the last cell that reuses it is reached.
+    std::vector<int> const source = calculation_sources(cells);
+    std::vector<int> pending_reuses(cells.size(), 0);
+    int n_reused = 0;
+    for(int j = 0; j < lmi::ssize(cells); ++j)
+        {
+        if(source[j] != j)
+            {
+            ++pending_reuses[source[j]];
+            ++n_reused;
+            }
+        }
+    std::map<int,std::shared_ptr<Ledger const>> reusable;
+
+    std::string title = "Calculating all cells";
+    if(0 != n_reused)
+        {
+        title += " (" + std::to_string(n_reused) + " duplicates reused)";
+        }
     std::unique_ptr<progress_meter> meter
         (create_progress_meter
             (lmi::ssize(cells)
-            ,"Calculating all cells"
+            ,title
             ,progress_meter_mode(emission)
             )
         );
@@ -141,17 +194,54 @@ census_run_result run_census_in_series::operator()
     ledger_emitter emitter(file, emission);
     result.seconds_for_output_ += emitter.initiate();
 
+    // Only one cell is needed at a time, so a single AccountValue is
+    // rebound to each cell in turn, keeping its scratch storage.
+    std::unique_ptr<AccountValue> av;
     for(int j = 0; j < lmi::ssize(cells); ++j)
         {
         if(!cell_should_be_ignored(cells[j]))
             {
             std::string const name(cells[j]["InsuredName"].str());
-            IllusVal IV(serial_file_path(file, name, j, "hastur").string());
-            IV.run(cells[j]);
-            composite.PlusEq(*IV.ledger());
+            fs::path const cell_filepath(serial_file_path(file, name, j, "hastur"));
+            std::shared_ptr<Ledger const> ledger;
+            int const k = source[j];
+            if(k != j)
+                {
+                ledger = std::make_shared<Ledger const>
+                    (reusable.at(k)->WithPresentationText(yare_input(cells[j]))
+                    );
+                if(0 == --pending_reuses[k])
+                    {
+                    reusable.erase(k);
+                    }
+                }
+            else
+                {
+                fenv_guard fg;
+                if(av)
+                    {
+                    av->Rebind(cells[j]);
+                    }
+                else
+                    {
+                    av = std::make_unique<AccountValue>(cells[j]);
+                    }
+                av->SetDebugFilename(cell_filepath.string());
+                if(!emitter.needs_guar_prem())
+                    {
+                    av->OmitGuarPremium();
+                    }
+                av->RunAV();
+                ledger = av->ledger_from_av();
+                if(0 != pending_reuses[j])
+                    {
+                    reusable[j] = ledger;
+                    }
+                }
+            composite.PlusEq(*ledger);
             result.seconds_for_output_ += emitter.emit_cell
-                (serial_file_path(file, name, j, "hastur")
-                ,*IV.ledger()
+                (cell_filepath
+                ,*ledger
                 );
             meter->dawdle(intermission_between_printouts(emission));
             }
@@ -171,7 +261,12 @@ census_run_result run_census_in_series::operator()
 
   done:
     double total_seconds = timer.stop().elapsed_seconds();
-    status() << Timer::elapsed_msec_str(total_seconds) << std::flush;
+    status() << Timer::elapsed_msec_str(total_seconds);
+    if(0 != n_reused)
+        {
+        status() << "; " << n_reused << " duplicate cells reused";
+        }
+    status() << std::flush;
     result.seconds_for_calculations_ = total_seconds - result.seconds_for_output_;
     return result;
 }
@@ -194,10 +289,63 @@ census_run_result run_census_in_parallel::operator()
         );
 
     ledger_emitter emitter(file, emission);
+    result.seconds_for_output_ += emitter.initiate();
 
-    std::vector<AccountValue> cell_values;
+    // The monthly state of every cell is needed until the cell is
+    // finished on the last basis, because case assets couple all
+    // cells' calculations. Therefore, the peak memory required is
+    // the state of all cells at the beginning of any basis, and
+    // nothing done here lowers it: every cell is in force then, and
+    // what a cell keeps across bases is needed--its rates and
+    // invariant values are read on every basis, and its ledger
+    // accumulates the results of each basis for output.
+    //
+    // What can be bounded is the memory retained after that peak.
+    // On the last basis, a finished cell is finalized and all of its
+    // state but its ledger is released. Its ledger is then added to
+    // the composite and written, and released in turn, as soon as
+    // every earlier cell in the census has likewise been finished.
+    std::vector<std::unique_ptr<AccountValue>> cell_values;
+    std::vector<std::shared_ptr<Ledger const>> cell_ledgers;
     std::vector<mcenum_run_basis> const& RunBases = composite.GetRunBases();
 
+    // Finalize a cell on the last basis, keep its ledger, and release
+    // everything else. Once a cell has lapsed or matured, nothing is
+    // left to calculate for it, so it can be retired early.
+    auto const retire = [&] (int k, mcenum_run_basis run_basis)
+        {
+        AccountValue& av = *cell_values[k];
+        av.FinalizeLife(run_basis);
+        av.FinalizeLifeAllBases();
+        cell_ledgers[k] = av.ledger_from_av();
+        cell_values[k].reset();
+        };
+
+    // Add retired cells to the composite and write them, in census
+    // order, so that composite values are the same as though none had
+    // been retired early; then release their ledgers.
+    int n_emitted = 0;
+    auto const emit_retired = [&]
+        {
+        for
+            (
+            ;n_emitted < lmi::ssize(cell_ledgers) && cell_ledgers[n_emitted]
+            ;++n_emitted
+            )
+            {
+            int const k = n_emitted;
+            composite.PlusEq(*cell_ledgers[k]);
+            // Indexing: here, k is an index into cell_ledgers, not cells.
+            std::string const name(cells[k]["InsuredName"].str());
+            result.seconds_for_output_ += emitter.emit_cell
+                (serial_file_path(file, name, k, "hastur")
+                ,*cell_ledgers[k]
+                );
+            cell_ledgers[k].reset();
+            meter->dawdle(intermission_between_printouts(emission));
+            }
+        };
+
     int const first_cell_inforce_year  = value_cast<int>((*cells.begin())["InforceYear"].str());
     int const first_cell_inforce_month = value_cast<int>((*cells.begin())["InforceMonth"].str());
     cell_values.reserve(cells.size());
@@ -211,8 +359,8 @@ census_run_result run_census_in_parallel::operator()
             {
             { // Begin fenv_guard scope.
             fenv_guard fg;
-            cell_values.emplace_back(ip);
-            AccountValue& av = cell_values.back();
+            cell_values.push_back(std::make_unique<AccountValue>(ip));
+            AccountValue& av = *cell_values.back();
 
             std::string const name(cells[j]["InsuredName"].str());
             // Indexing: here, j is an index into cells, not cell_values.
@@ -220,10 +368,10 @@ census_run_result run_census_in_parallel::operator()
                 (serial_file_path(file, name, j, "hastur").string()
                 );
 
-            if(contains(av.yare_input_.Comments, "idiosyncrasyZ"))
+            av.DebugPrintInit();
+            if(!emitter.needs_guar_prem())
                 {
-                av.Debugging = true;
-                av.DebugPrintInit();
+                av.OmitGuarPremium();
                 }
 
             if
@@ -265,6 +413,7 @@ census_run_result run_census_in_parallel::operator()
             << LMI_FLUSH
             ;
         }
+    cell_ledgers.resize(cell_values.size());
 
     for(auto const& run_basis : RunBases)
         {
@@ -278,6 +427,7 @@ census_run_result run_census_in_parallel::operator()
         // progress meter used earlier in this function.
         { // Begin fenv_guard scope.
         fenv_guard fg;
+        bool const last_basis = &run_basis == &RunBases.back();
         mcenum_gen_basis expense_and_general_account_basis;
         mcenum_sep_basis separate_account_basis;
         set_cloven_bases_from_run_basis
@@ -290,8 +440,8 @@ census_run_result run_census_in_parallel::operator()
         int MaxYr = 0;
         for(auto& i : cell_values)
             {
-            i.InitializeLife(run_basis);
-            MaxYr = std::max(MaxYr, i.GetLength());
+            i->InitializeLife(run_basis);
+            MaxYr = std::max(MaxYr, i->GetLength());
             }
 
         meter = create_progress_meter
@@ -306,13 +456,13 @@ census_run_result run_census_in_parallel::operator()
                 {
                 // A cell must be initialized at the beginning of any
                 // partial inforce year in which it's illustrated.
-                if(i.PrecedesInforceDuration(year, 11))
+                if(!i || i->PrecedesInforceDuration(year, 11))
                     {
                     continue;
                     }
-                i.Year = year;
-                i.CoordinateCounters();
-                i.InitializeYear();
+                i->Year = year;
+                i->CoordinateCounters();
+                i->InitializeYear();
                 }
 
             // Process one month at a time for all cells.
@@ -331,24 +481,24 @@ census_run_result run_census_in_parallel::operator()
                 // Process transactions through monthly deduction.
                 for(auto& i : cell_values)
                     {
-                    if(i.PrecedesInforceDuration(year, month))
+                    if(!i || i->PrecedesInforceDuration(year, month))
                         {
                         continue;
                         }
-                    i.Month = month;
-                    i.CoordinateCounters();
-                    i.IncrementBOM(year, month);
-                    assets += i.GetSepAcctAssetsInforce();
+                    i->Month = month;
+                    i->CoordinateCounters();
+                    i->IncrementBOM(year, month);
+                    assets += i->GetSepAcctAssetsInforce();
                     }
 
                 // Process transactions from int credit through end of month.
                 for(auto& i : cell_values)
                     {
-                    if(i.PrecedesInforceDuration(year, month))
+                    if(!i || i->PrecedesInforceDuration(year, month))
                         {
                         continue;
                         }
-                    i.IncrementEOM(year, month, assets, i.CumPmts);
+                    i->IncrementEOM(year, month, assets, i->CumPmts);
                     }
                 }
 
@@ -365,12 +515,31 @@ census_run_result run_census_in_parallel::operator()
 
             for(auto& i : cell_values)
                 {
-                if(i.PrecedesInforceDuration(year, 11))
+                if(!i || i->PrecedesInforceDuration(year, 11))
                     {
                     continue;
                     }
-                i.SetClaims();
-                i.IncrementEOY(year);
+                i->SetClaims();
+                i->IncrementEOY(year);
+                }
+
+            // A retired cell contributes no assets, which is exactly
+            // what a lapsed or matured cell would contribute.
+            if(last_basis)
+                {
+                for(int k = 0; k < lmi::ssize(cell_values); ++k)
+                    {
+                    AccountValue* i = cell_values[k].get();
+                    if
+                        (   i
+                        &&  !i->PrecedesInforceDuration(year, 11)
+                        &&  (i->ItLapsed || i->GetLength() <= 1 + year)
+                        )
+                        {
+                        retire(k, run_basis);
+                        }
+                    }
+                emit_retired();
                 }
 
             if(!meter->reflect_progress())
@@ -381,57 +550,28 @@ census_run_result run_census_in_parallel::operator()
             } // End for year.
         meter->culminate();
 
-        for(auto& i : cell_values)
+        for(int k = 0; k < lmi::ssize(cell_values); ++k)
             {
-            i.FinalizeLife(run_basis);
+            if(!cell_values[k])
+                {
+                continue;
+                }
+            if(last_basis)
+                {
+                retire(k, run_basis);
+                }
+            else
+                {
+                cell_values[k]->FinalizeLife(run_basis);
+                }
             }
-
-        } // End fenv_guard scope.
-        } // End for.
-
-    meter = create_progress_meter
-        (lmi::ssize(cell_values)
-        ,"Finalizing all cells"
-        ,progress_meter_mode(emission)
-        );
-    for(auto& i : cell_values)
-        {
-        fenv_guard fg;
-        i.FinalizeLifeAllBases();
-        composite.PlusEq(*i.ledger_from_av());
-        if(!meter->reflect_progress())
+        if(last_basis)
             {
-            result.completed_normally_ = false;
-            goto done;
+            emit_retired();
             }
-        }
-    meter->culminate();
-
-    result.seconds_for_output_ += emitter.initiate();
 
-    meter = create_progress_meter
-        (lmi::ssize(cell_values)
-        ,"Writing output for all cells"
-        ,progress_meter_mode(emission)
-        );
-    j = 0;
-    for(auto const& i : cell_values)
-        {
-        // Indexing: here, j is an index into cell_values, not cells.
-        std::string const name(cells[j]["InsuredName"].str());
-        result.seconds_for_output_ += emitter.emit_cell
-            (serial_file_path(file, name, j, "hastur")
-            ,*i.ledger_from_av()
-            );
-        meter->dawdle(intermission_between_printouts(emission));
-        if(!meter->reflect_progress())
-            {
-            result.completed_normally_ = false;
-            goto done;
-            }
-        ++j;
-        }
-    meter->culminate();
+        } // End fenv_guard scope.
+        } // End for.
 
     result.seconds_for_output_ += emitter.emit_cell
         (serial_file_path(file, "composite", -1, "hastur")
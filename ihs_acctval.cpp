@@ -31,10 +31,12 @@
 #include "dbnames.hpp"
 #include "death_benefits.hpp"
 #include "gpt7702.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
 #include "i7702.hpp"
 #include "ihs_irc7702.hpp"
 #include "ihs_irc7702a.hpp"
 #include "input.hpp"                    // consummate()
+#include "instrumentation.hpp"
 #include "interest_rates.hpp"
 #include "ledger.hpp"
 #include "ledger_invariant.hpp"
@@ -144,6 +146,28 @@ AccountValue::AccountValue(Input const& input)
     withdrawal_ullage_  .reserve(BasicValues::GetLength());
 }
 
+/// Destructor.
+///
+/// If a basis threw before it was complete, write the monthly-trace
+/// rows it recorded, which may show what went wrong.
+
+AccountValue::~AccountValue()
+{
+    if(!Debugging || DebugRows.empty())
+        {
+        return;
+        }
+
+    try
+        {
+        DebugWriteRows();
+        }
+    catch(...)
+        {
+        report_exception();
+        }
+}
+
 /// Specified amount (disregarding any term or "supplemental" amount).
 
 currency AccountValue::base_specamt(int year) const
@@ -227,17 +251,106 @@ Then run other bases.
         it should also be possible to solve on a midpt basis as well
 */
 
-    if(contains(yare_input_.Comments, "idiosyncrasyZ"))
-        {
-        Debugging = true;
-        DebugPrintInit();
-        }
+    DebugPrintInit();
 
     RunAllApplicableBases();
 
     FinalizeLifeAllBases();
 }
 
+/// Run this cell again, with different input interest rates.
+///
+/// Everything that doesn't depend on input interest rates is reused.
+
+std::shared_ptr<Ledger const> AccountValue::RunRateScenario
+    (std::vector<double> const& gen_acct_rate
+    ,std::vector<double> const& sep_acct_rate
+    )
+{
+    BasicValues::SetInterestRateScenario(gen_acct_rate, sep_acct_rate);
+    RestoreInitialState();
+    RunAV();
+    return ledger_from_av();
+}
+
+/// Reuse this object for a different cell.
+///
+/// A census run in series needs only one cell at a time. Rebinding
+/// one object to each cell in turn keeps the capacity of all scratch
+/// vectors, and the variant-ledger scratch object if the new cell's
+/// duration is the same, instead of allocating them anew.
+
+void AccountValue::Rebind(Input const& input)
+{
+    DebugClose();
+    BasicValues::Rebind(Input::consummate(input));
+
+    InputFilename     = "anonymous";
+    DebugFilename     = "anonymous.monthly_trace";
+    Debugging         = false;
+    DebuggingRaw      = false;
+    GuarPremiumWanted = true;
+    SolveGenBasis_    = mce_gen_curr;
+    SolveSepBasis_    = mce_sep_full;
+    RunBasis_         = mce_run_gen_curr_sep_full;
+    GenBasis_         = mce_gen_curr;
+    SepBasis_         = mce_sep_full;
+    OldDBOpt          = mce_option1;
+    YearsDBOpt        = mce_option1;
+
+    // InitializeLife() reinitializes this object for each basis.
+    if(BasicValues::GetLength() != ledger_variant_->GetLength())
+        {
+        ledger_variant_.reset(::new LedgerVariant(BasicValues::GetLength()));
+        }
+
+    RestoreInitialState();
+    LMI_ASSERT(InforceYear < methuselah);
+}
+
+/// Restore all that a run may have changed to its state upon
+/// construction.
+///
+/// Vectors are reassigned, so they keep their capacity. The ledger
+/// from any previous run has been handed out by ledger_from_av(), so
+/// a new one is created; so is the invariant-ledger scratch object,
+/// which holds strings that are set only conditionally.
+
+void AccountValue::RestoreInitialState()
+{
+    DebugClose();
+
+    Solving               = mce_solve_none != yare_input_.SolveType;
+    SolvingForGuarPremium = false;
+    ItLapsed              = false;
+    ledger_.reset(::new Ledger(BasicValues::GetLength(), BasicValues::ledger_type(), BasicValues::nonillustrated(), BasicValues::no_can_issue(), false));
+    ledger_invariant_.reset(::new LedgerInvariant(BasicValues::GetLength()));
+
+    SetInitialValues();
+    PerformSpecAmtStrategy();
+    PerformSupplAmtStrategy();
+    InvariantValues().Init(this);
+    set_list_bill_year_and_month();
+
+    OverridingEePmts    .assign(12 * BasicValues::GetLength(), C0);
+    OverridingErPmts    .assign(12 * BasicValues::GetLength(), C0);
+
+    OverridingLoan      .assign(BasicValues::GetLength(), C0);
+    OverridingWD        .assign(BasicValues::GetLength(), C0);
+
+    SurrChg_            .assign(BasicValues::GetLength(), C0);
+}
+
+/// Don't solve for the guaranteed premium.
+///
+/// A census runner calls this when no output it emits shows that
+/// premium; the ledger records the omission.
+
+void AccountValue::OmitGuarPremium()
+{
+    GuarPremiumWanted = false;
+}
+
 /// Guaranteed premium for NAIC illustration reg, section 7B(2).
 ///
 /// Section 7B(2) requires "basic" illustrations to show "the premium
@@ -264,6 +377,11 @@ Then run other bases.
 void AccountValue::SetGuarPrem()
 {
     GuarPremium = C0;
+    if(!GuarPremiumWanted)
+        {
+        ledger_->OmitGuarPremium();
+        return;
+        }
     if
         (  BasicValues::IsSubjectToIllustrationReg()
         && 0 == InforceYear
@@ -399,6 +517,7 @@ void AccountValue::RunOneCell(mcenum_run_basis a_Basis)
 //============================================================================
 void AccountValue::InitializeLife(mcenum_run_basis a_Basis)
 {
+    LMI_PROBE(probe_initialize_life);
     RunBasis_ = a_Basis;
     set_cloven_bases_from_run_basis(RunBasis_, GenBasis_, SepBasis_);
 
@@ -582,7 +701,12 @@ void AccountValue::FinalizeLife(mcenum_run_basis a_Basis)
     ledger_->SetOneLedgerVariant(a_Basis, VariantValues());
 }
 
-//============================================================================
+/// Finish the ledger after all bases have been run.
+///
+/// Only the guaranteed premium can be omitted here: 'InforceLives'
+/// weights every value that a composite sums, so it must be truncated
+/// at lapse even if no output shows this cell.
+
 void AccountValue::FinalizeLifeAllBases()
 {
     ledger_->ZeroInforceAfterLapse();
@@ -24,243 +24,38 @@
 #include "account_value.hpp"
 
 #include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
 #include "configurable_settings.hpp"
+#include "contains.hpp"
 #include "global_settings.hpp"
 #include "gpt7702.hpp"
 #include "ihs_irc7702a.hpp"
 #include "ledger_invariant.hpp"
-#include "mc_enum_types_aux.hpp"        // mc_str()
 #include "miscellany.hpp"
+#include "monthly_trace.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"
-#include "value_cast.hpp"
 
-#include <algorithm>
-#include <iterator>                     // ostream_iterator
 #include <string>
-#include <vector>
 
 namespace
 {
-    inline std::string const& not_applicable()
+    inline double not_applicable()
         {
-        static std::string const s{"---"};
-        return s;
+        return monthly_trace_not_applicable();
         }
-
-    // Columns can be rearranged by changing the order of enumerators.
-
-    enum DebugColNames
-        {eYear
-        ,eMonth
-        ,eBasis
-        ,eAge
-        ,eGenAcctBOMAV
-        ,eSepAcctBOMAV
-        ,eUnloanedBOMAV
-        ,eRegularLoanBOMAV
-        ,ePrefLoanBOMAV
-        ,eTotalBOMAV
-        ,eRegLoanBal
-        ,ePrefLoanBal
-        ,eDBOption
-        ,eSpecAmt
-        ,eCorridorFactor
-        ,eDeathBft
-        ,eForceout
-        ,eEePrem
-        ,eErPrem
-        ,eTotalPrem
-        ,eTargetPrem
-        ,ePremiumLoad
-        ,eSalesLoad
-        ,ePremiumTaxLoad
-        ,eDacTaxLoad
-        ,eNetPrem
-        ,ePolicyFees
-        ,eSpecAmtLoad
-        ,eNAAR
-        ,eCoiRate
-        ,eCoiCharge
-        ,eAdbRate
-        ,eAdbCharge
-        ,eWpRate
-        ,eWpCharge
-        ,eTermAmount
-        ,eTermRate
-        ,eTermCharge
-        ,eTotalRiderCharges
-        ,eTotalMonthlyDeds
-        ,eGenAcctIntRate
-        ,eGenAcctIntCred
-        ,eSepAcctIntRate
-        ,eSepAcctIntCred
-        ,eAssetsPostBom
-        ,eCumPmtsPostBom
-        ,eSepAcctLoad
-        ,eRegLnIntRate
-        ,eRegLnIntCred
-        ,ePrfLnIntRate
-        ,ePrfLnIntCred
-        ,eYearsHMValueRate
-        ,eYearsPostHMRate
-        ,eRequestedWD
-        ,eMaxWD
-        ,eGrossWD
-        ,eNetWD
-        ,eRequestedLoan
-        ,eMaxLoan
-        ,eNewLoan
-        ,eTaxBasis
-        ,eCumNoLapsePrem
-        ,eNoLapseActive
-        ,eEOMAV
-        ,eHMValue
-        ,eSurrChg
-        ,eEOMCSVNet
-        ,eEOMCV7702
-        ,eInforceFactor
-        ,eClaimsPaid
-        ,e7702ATestDur
-        ,e7702A7ppRate
-        ,e7702ANsp
-        ,e7702ALowestDb
-        ,e7702ADeemedCv
-        ,e7702ANetMaxNecPm
-        ,e7702AGrossMaxNecPm
-        ,e7702AUnnecPm
-        ,e7702ADbAdj
-        ,e7702A7pp
-        ,e7702ACum7pp
-        ,e7702AAmountsPaid
-        ,e7702AIsMec
-        ,eGLP
-        ,eCumGLP
-        ,eGSP
-        ,e7702PremiumsPaid
-        // Insert new enumerators above
-        ,eLast
-        };
-
-    // Headers for monthly output.
-
-    inline std::vector<std::string> const& DebugColHeadersHelper()
-    {
-        static std::vector<std::string> v(eLast);
-        v[eYear]                = "Year";
-        v[eMonth]               = "Month";
-        v[eBasis]               = "Basis for values";
-        v[eAge]                 = "Age";
-        v[eGenAcctBOMAV]        = "Unloaned BOM GA AV";
-        v[eSepAcctBOMAV]        = "Unloaned BOM SA AV";
-        v[eUnloanedBOMAV]       = "Unloaned BOM Tot AV";
-        v[eRegularLoanBOMAV]    = "Regular loan BOM AV";
-        v[ePrefLoanBOMAV]       = "Pref loan BOM AV";
-        v[eTotalBOMAV]          = "Total BOM AV";
-        v[eRegLoanBal]          = "Reg loan bal";
-        v[ePrefLoanBal]         = "Pref loan bal";
-        v[eDBOption]            = "DB option";
-        v[eSpecAmt]             = "Spec amt";
-        v[eCorridorFactor]      = "Corridor factor";
-        v[eDeathBft]            = "Death benefit";
-        v[eForceout]            = "Forceout";
-        v[eEePrem]              = "Ee prem";
-        v[eErPrem]              = "Er prem";
-        v[eTotalPrem]           = "Total prem";
-        v[eTargetPrem]          = "Target prem";
-        v[ePremiumLoad]         = "Prem load";
-        v[eSalesLoad]           = "Sales load";
-        v[ePremiumTaxLoad]      = "Prem tax load";
-        v[eDacTaxLoad]          = "DAC tax load";
-        v[eNetPrem]             = "Net prem";
-        v[ePolicyFees]          = "Policy fees";
-        v[eSpecAmtLoad]         = "Spec amt load";
-        v[eNAAR]                = "NAAR";
-        v[eCoiRate]             = "COI rate";
-        v[eCoiCharge]           = "COI charge";
-        v[eAdbRate]             = "ADD rate";
-        v[eAdbCharge]           = "ADD charge";
-        v[eWpRate]              = "WP rate";
-        v[eWpCharge]            = "WP charge";
-        v[eTermAmount]          = "Term amount";
-        v[eTermRate]            = "Term rate";
-        v[eTermCharge]          = "Term charge";
-        v[eTotalRiderCharges]   = "Total rider charges";
-        v[eTotalMonthlyDeds]    = "Total monthly deductions";
-        v[eGenAcctIntRate]      = "Unloaned GA interest rate";
-        v[eGenAcctIntCred]      = "Unloaned GA interest credited";
-        v[eSepAcctIntRate]      = "Unloaned SA interest rate";
-        v[eSepAcctIntCred]      = "Unloaned SA interest credited";
-        v[eAssetsPostBom]       = "Assets post BOM";
-        v[eCumPmtsPostBom]      = "Cumulative payments post BOM";
-        v[eSepAcctLoad]         = "Separate account load";
-        v[eRegLnIntRate]        = "Regular loan interest rate";
-        v[eRegLnIntCred]        = "Regular loan interest credited";
-        v[ePrfLnIntRate]        = "Pref loan interest rate";
-        v[ePrfLnIntCred]        = "Pref loan interest credited";
-        v[eYearsHMValueRate]    = "Honeymoon value rate";
-        v[eYearsPostHMRate]     = "Post honeymoon rate";
-        v[eRequestedWD]         = "Requested wd";
-        v[eMaxWD]               = "Max wd";
-        v[eGrossWD]             = "Gross wd";
-        v[eNetWD]               = "Net wd";
-        v[eRequestedLoan]       = "Requested loan";
-        v[eMaxLoan]             = "Max loan";
-        v[eNewLoan]             = "New loan";
-        v[eTaxBasis]            = "Tax basis";
-        v[eCumNoLapsePrem]      = "Cumulative no lapse prem";
-        v[eNoLapseActive]       = "No lapse active";
-        v[eEOMAV]               = "EOM AV";
-        v[eHMValue]             = "Honeymoon value";
-        v[eSurrChg]             = "EOM surrender charge";
-        v[eEOMCSVNet]           = "EOM CSV net";
-        v[eEOMCV7702]           = "EOM CV for 7702";
-        v[eInforceFactor]       = "Inforce factor";
-        v[eClaimsPaid]          = "Partial mort claims paid";
-        v[e7702ATestDur]        = "7702A test duration";
-        v[e7702A7ppRate]        = "7702A 7pp rate";
-        v[e7702ANsp]            = "7702A NSP";
-        v[e7702ALowestDb]       = "7702A lowest DB";
-        v[e7702ADeemedCv]       = "7702A deemed CV";
-        v[e7702ANetMaxNecPm]    = "7702A net max nec prem";
-        v[e7702AGrossMaxNecPm]  = "7702A gross max nec prem";
-        v[e7702AUnnecPm]        = "7702A unnec prem";
-        v[e7702ADbAdj]          = "7702A DB adjustment";
-        v[e7702A7pp]            = "7702A 7pp";
-        v[e7702ACum7pp]         = "7702A cumulative 7pp";
-        v[e7702AAmountsPaid]    = "7702A amounts paid";
-        v[e7702AIsMec]          = "Is MEC";
-        v[eGLP]                 = "GLP";
-        v[eCumGLP]              = "Cumulative GLP";
-        v[eGSP]                 = "GSP";
-        v[e7702PremiumsPaid]    = "7702 premiums paid";
-
-        return v;
-    }
 } // Unnamed namespace.
 
-inline std::vector<std::string> const& DebugColHeaders()
-{
-    static std::vector<std::string> v(DebugColHeadersHelper());
-    return v;
-}
-
-//============================================================================
-inline void AccountValue::SetMonthlyDetail(int enumerator, std::string const& s)
-{
-    DebugRecord[enumerator] = s;
-}
-
 //============================================================================
 inline void AccountValue::SetMonthlyDetail(int enumerator, double d)
 {
-    DebugRecord[enumerator] = value_cast<std::string>(d);
+    *(DebugRows.end() - eLast + enumerator) = d;
 }
 
 //============================================================================
 inline void AccountValue::SetMonthlyDetail(int enumerator, currency c)
 {
-    DebugRecord[enumerator] = value_cast<std::string>(dblize(c));
+    *(DebugRows.end() - eLast + enumerator) = dblize(c);
 }
 
 //============================================================================
@@ -275,23 +70,39 @@ void AccountValue::SetDebugFilename(std::string const& s)
     DebugFilename = unique_filepath(f, ".monthly_trace" + tsv_ext).string();
 }
 
-//============================================================================
+/// Activate the monthly trace if requested in the "Comments" field.
+///
+/// "idiosyncrasyZ" writes tab-delimited text, formatted as each basis
+/// is completed. "idiosyncrasy_raw_monthly_trace" writes the same
+/// data as raw binary, which costs hardly more than not tracing at
+/// all; format_monthly_trace() converts it to text later.
+
 void AccountValue::DebugPrintInit()
 {
-    DebugRecord.assign(eLast, "EMPTY");
+    DebuggingRaw = contains(yare_input_.Comments, "idiosyncrasy_raw_monthly_trace");
+    Debugging    = DebuggingRaw || contains(yare_input_.Comments, "idiosyncrasyZ");
 
     if(!Debugging)
         {
         return;
         }
 
-    DebugStream.open(DebugFilename.c_str(), ios_out_trunc_binary());
-    std::copy
-        (DebugColHeaders().begin()
-        ,DebugColHeaders().end()
-        ,std::ostream_iterator<std::string>(DebugStream, "\t")
-        );
-    DebugStream << '\n';
+    // Preallocate enough rows for a full basis, so that recording
+    // a month never allocates.
+    DebugRows.clear();
+    DebugRows.reserve(static_cast<std::size_t>(eLast) * 12 * GetLength());
+
+    if(DebuggingRaw)
+        {
+        fs::path const f = fs::path{DebugFilename}.replace_extension(".mtrace");
+        DebugStream.open(f.string().c_str(), ios_out_trunc_binary());
+        write_raw_monthly_trace_header(DebugStream);
+        }
+    else
+        {
+        DebugStream.open(DebugFilename.c_str(), ios_out_trunc_binary());
+        write_monthly_trace_headers(DebugStream);
+        }
 }
 
 //============================================================================
@@ -301,11 +112,51 @@ void AccountValue::DebugEndBasis()
         {
         return;
         }
-    DebugStream << '\n';
+
+    DebugWriteRows();
+}
+
+/// Write and discard the rows recorded so far.
+///
+/// Called when a basis is complete, and also by the destructor, so
+/// that a basis that throws still leaves its trace up to the month
+/// that failed.
+
+void AccountValue::DebugWriteRows()
+{
+    int const rows = bourn_cast<int>(DebugRows.size() / eLast);
+    if(DebuggingRaw)
+        {
+        write_raw_monthly_trace_rows(DebugStream, DebugRows.data(), rows);
+        }
+    else
+        {
+        write_monthly_trace_rows(DebugStream, DebugRows.data(), rows);
+        }
+    DebugStream.flush();
+    DebugRows.clear();
+}
+
+/// Close the monthly trace, so that DebugPrintInit() can open it again.
+///
+/// Rows left by a basis that threw are written first, as the
+/// destructor would write them.
+
+void AccountValue::DebugClose()
+{
+    if(Debugging && !DebugRows.empty())
+        {
+        DebugWriteRows();
+        }
+    DebugRows.clear();
+    if(DebugStream.is_open())
+        {
+        DebugStream.close();
+        }
 }
 
 //============================================================================
-// To add a new column, see ihs_dbughdr.hpp .
+// To add a new column, see monthly_trace.hpp .
 void AccountValue::DebugPrint()
 {
     if(!Debugging || Solving || SolvingForGuarPremium)
@@ -313,11 +164,12 @@ void AccountValue::DebugPrint()
         return; // Show detail on final run, not every solve iteration.
         }
 
-    DebugRecord.assign(eLast, "EMPTY");
+    // Append one row; capacity was reserved in DebugPrintInit().
+    DebugRows.resize(DebugRows.size() + eLast, monthly_trace_empty());
 
     SetMonthlyDetail(eYear               ,Year);
     SetMonthlyDetail(eMonth              ,Month);
-    SetMonthlyDetail(eBasis              ,mc_str(RunBasis_));
+    SetMonthlyDetail(eBasis              ,RunBasis_);
     SetMonthlyDetail(eAge                ,BasicValues::GetIssueAge() + Year);
 
     // Initial values at beginning of run, reflecting inforce if applicable.
@@ -351,7 +203,7 @@ void AccountValue::DebugPrint()
 
     SetMonthlyDetail(eRegLoanBal         ,RegLnBal                         );
     SetMonthlyDetail(ePrefLoanBal        ,PrfLnBal                         );
-    SetMonthlyDetail(eDBOption           ,mc_str(YearsDBOpt)               );
+    SetMonthlyDetail(eDBOption           ,YearsDBOpt                       );
     SetMonthlyDetail(eSpecAmt            ,ActualSpecAmt                    );
     SetMonthlyDetail(eCorridorFactor     ,YearsCorridorFactor              );
     SetMonthlyDetail(eDeathBft           ,DBReflectingCorr                 );
@@ -523,12 +375,4 @@ void AccountValue::DebugPrint()
         SetMonthlyDetail(eGSP                ,not_applicable()             );
         SetMonthlyDetail(e7702PremiumsPaid   ,not_applicable()             );
         }
-
-    std::copy
-        (DebugRecord.begin()
-        ,DebugRecord.end()
-        ,std::ostream_iterator<std::string>(DebugStream, "\t")
-        );
-    DebugStream << '\n';
-    DebugRecord.assign(eLast, "EMPTY");
 }
@@ -32,6 +32,7 @@
 #include "gpt7702.hpp"
 #include "ihs_irc7702.hpp"
 #include "ihs_irc7702a.hpp"
+#include "instrumentation.hpp"
 #include "interest_rates.hpp"
 #include "ledger_invariant.hpp"
 #include "ledger_variant.hpp"
@@ -102,6 +103,7 @@
 // Monthly transactions up through monthly deduction.
 void AccountValue::DoMonthDR()
 {
+    LMI_PROBE(probe_do_month_dr);
     if(ItLapsed)
         {
         return;
@@ -274,6 +276,7 @@ void AccountValue::DoMonthDR()
 // Monthly transactions that follow monthly deduction.
 void AccountValue::DoMonthCR()
 {
+    LMI_PROBE(probe_do_month_cr);
     TxTakeSepAcctLoad();
     TxLoanInt();
     TxCreditInt();
@@ -527,6 +530,7 @@ void AccountValue::DecrementAVProgressively
 //============================================================================
 void AccountValue::TxExch1035()
 {
+    LMI_PROBE(probe_tx_exch_1035);
     if(!(0 == Year && 0 == Month))
         {
         return;
@@ -882,6 +886,7 @@ void AccountValue::InitializeMonth()
 
 void AccountValue::TxOptionChange()
 {
+    LMI_PROBE(probe_tx_option_change);
     // Illustrations allow option changes only on anniversary,
     // but not on the zeroth anniversary.
     if(0 != Month || 0 == Year)
@@ -998,6 +1003,7 @@ void AccountValue::TxOptionChange()
 
 void AccountValue::TxSpecAmtChange()
 {
+    LMI_PROBE(probe_tx_spec_amt_change);
     if(0 != Month || 0 == Year)
         {
 // > This initializes DBReflectingCorr and others so that the at-issue but
@@ -1084,6 +1090,7 @@ void AccountValue::TxSpecAmtChange()
 //============================================================================
 void AccountValue::TxTestGPT()
 {
+    LMI_PROBE(probe_tx_test_gpt);
     if(mce_gpt != DefnLifeIns_ || mce_run_gen_curr_sep_full != RunBasis_)
         {
         return;
@@ -1215,6 +1222,7 @@ void AccountValue::TxTestGPT()
 
 void AccountValue::TxAscertainDesiredPayment()
 {
+    LMI_PROBE(probe_tx_ascertain_desired_payment);
 // SOMEDAY !! Some systems force monthly premium to be integral cents even
 // though actual mode is not monthly; is that something we need to do here?
 //
@@ -1345,6 +1353,7 @@ void AccountValue::TxAscertainDesiredPayment()
 
 void AccountValue::TxLimitPayment(double a_maxpmt)
 {
+    LMI_PROBE(probe_tx_limit_payment);
 // Subtract premium load from gross premium yielding net premium.
 
     // This is needed only for current-basis or solve-basis runs.
@@ -1440,6 +1449,7 @@ void AccountValue::TxRecognizePaymentFor7702A
 //============================================================================
 void AccountValue::TxAcceptPayment(currency a_pmt)
 {
+    LMI_PROBE(probe_tx_accept_payment);
     if(C0 == a_pmt)
         {
         return;
@@ -1593,6 +1603,7 @@ currency AccountValue::GetRefundableSalesLoad() const
 // TODO ?? This is untested, and probably isn't right.
 void AccountValue::TxLoanRepay()
 {
+    LMI_PROBE(probe_tx_loan_repay);
     // Illustrations allow loan repayment only on anniversary.
     if(0 != Month)
         {
@@ -1625,6 +1636,7 @@ void AccountValue::TxLoanRepay()
 
 void AccountValue::TxSetBOMAV()
 {
+    LMI_PROBE(probe_tx_set_bom_av);
     // Subtract monthly policy fee and per K charge from account value.
 
     // Set base for specified-amount load. Usually, this represents
@@ -1719,6 +1731,7 @@ void AccountValue::TxSetBOMAV()
 
 void AccountValue::TxSetDeathBft()
 {
+    LMI_PROBE(probe_tx_set_death_bft);
     switch(YearsDBOpt)
         {
         case mce_option1:
@@ -1796,6 +1809,7 @@ void AccountValue::TxSetDeathBft()
 //============================================================================
 void AccountValue::TxSetTermAmt()
 {
+    LMI_PROBE(probe_tx_set_term_amt);
     if(!TermRiderActive)
         {
         return;
@@ -1861,6 +1875,7 @@ void AccountValue::EndTermRider(bool convert)
 
 void AccountValue::TxSetCoiCharge()
 {
+    LMI_PROBE(probe_tx_set_coi_charge);
     // Net amount at risk is the death benefit discounted one month
     // at the guaranteed interest rate, minus account value iff
     // nonnegative (a negative account value mustn't increase NAAR);
@@ -1901,6 +1916,7 @@ void AccountValue::TxSetCoiCharge()
 
 void AccountValue::TxSetRiderDed()
 {
+    LMI_PROBE(probe_tx_set_rider_ded);
     AdbCharge = C0;
     if(yare_input_.AccidentalDeathBenefit)
         {
@@ -2001,6 +2017,7 @@ void AccountValue::TxSetRiderDed()
 
 void AccountValue::TxDoMlyDed()
 {
+    LMI_PROBE(probe_tx_do_mly_ded);
     if(TermRiderActive && TermCanLapse && (AVGenAcct + AVSepAcct - CoiCharge) < TermCharge)
         {
         EndTermRider(false);
@@ -2043,6 +2060,7 @@ void AccountValue::TxDoMlyDed()
 //============================================================================
 void AccountValue::TxTestHoneymoonForExpiration()
 {
+    LMI_PROBE(probe_tx_test_honeymoon);
     if(!HoneymoonActive)
         {
         return;
@@ -2093,6 +2111,7 @@ void AccountValue::TxTestHoneymoonForExpiration()
 
 void AccountValue::TxTakeSepAcctLoad()
 {
+    LMI_PROBE(probe_tx_take_sep_acct_load);
     if(SepAcctLoadIsDynamic)
         {
         // CURRENCY !! should class stratified_charges use currency?
@@ -2227,6 +2246,7 @@ void AccountValue::ApplyDynamicMandE(currency assets)
 
 void AccountValue::TxCreditInt()
 {
+    LMI_PROBE(probe_tx_credit_int);
     ApplyDynamicMandE(AssetsPostBom);
 
     currency notional_sep_acct_charge = C0;
@@ -2294,6 +2314,7 @@ void AccountValue::TxCreditInt()
 
 void AccountValue::TxLoanInt()
 {
+    LMI_PROBE(probe_tx_loan_int);
     // Reinitialize to zero before potential early exit, to sweep away
     // any leftover values (e.g., after a loan has been paid off).
     RegLnIntCred = C0;
@@ -2402,6 +2423,7 @@ void AccountValue::SetMaxWD()
 
 void AccountValue::TxTakeWD()
 {
+    LMI_PROBE(probe_tx_take_wd);
     // Illustrations allow withdrawals only on anniversary; products
     // may forbid them altogether, or for the first N months. On the
     // issue date, the maximum withdrawal is zero anyway, because not
@@ -2760,6 +2782,7 @@ void AccountValue::SetMaxLoan()
 
 void AccountValue::TxTakeLoan()
 {
+    LMI_PROBE(probe_tx_take_loan);
     // Illustrations allow loans only on anniversary.
     if(0 != Month)
         {
@@ -2839,6 +2862,7 @@ void AccountValue::TxTakeLoan()
 // On anniversary, capitalize loan and set loaned AV equal to loan balance.
 void AccountValue::TxCapitalizeLoan()
 {
+    LMI_PROBE(probe_tx_capitalize_loan);
     // Capitalized loans only on anniversary.
     if(0 != Month)
         {
@@ -2858,6 +2882,7 @@ void AccountValue::TxCapitalizeLoan()
 
 void AccountValue::TxTestLapse()
 {
+    LMI_PROBE(probe_tx_test_lapse);
     // The refundable load cannot prevent a lapse that would otherwise
     // occur, because it is refunded only after termination. The same
     // principle applies to a negative surrender charge.
@@ -2985,5 +3010,6 @@ void AccountValue::FinalizeMonth()
 //============================================================================
 void AccountValue::TxDebug()
 {
+    LMI_PROBE(probe_tx_debug);
     DebugPrint();
 }
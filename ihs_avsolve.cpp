@@ -35,6 +35,7 @@
 #include "contains.hpp"
 #include "death_benefits.hpp"
 #include "global_settings.hpp"
+#include "instrumentation.hpp"
 #include "ledger_invariant.hpp"
 #include "ledger_variant.hpp"
 #include "mc_enum_types_aux.hpp"        // set_run_basis_from_cloven_bases()
@@ -329,6 +330,7 @@ void AccountValue::SolveSetWD(currency a_CandidateValue)
 
 currency AccountValue::SolveGuarPremium()
 {
+    LMI_PROBE(probe_solve_guar_premium);
     Outlay_->set_er_modal_premiums(C0, 0, BasicValues::GetLength());
     Outlay_->block_dumpin              ();
     Outlay_->block_external_1035_amount();
@@ -360,6 +362,7 @@ currency AccountValue::Solve
     ,mcenum_sep_basis    a_SolveSepBasis
     )
 {
+    LMI_PROBE(probe_solve);
     SolveBeginYear_      = a_SolveBeginYear;
     SolveEndYear_        = a_SolveEndYear;
     SolveTarget_         = a_SolveTarget;
@@ -32,7 +32,7 @@
 #include "data_directory.hpp"           // AddDataDir()
 #include "death_benefits.hpp"
 #include "et_vector.hpp"
-#include "financial.hpp"                // coi_rate_from_q(), i_upper_12_over_12_from_i()
+#include "financial.hpp"                // coi_rate_from_q_batch(), i_upper_12_over_12_from_i()
 #include "fund_data.hpp"
 #include "global_settings.hpp"
 #include "gpt7702.hpp"
@@ -41,6 +41,7 @@
 #include "ihs_irc7702.hpp"
 #include "ihs_irc7702a.hpp"
 #include "input.hpp"
+#include "instrumentation.hpp"
 #include "interest_rates.hpp"
 #include "lingo.hpp"
 #include "loads.hpp"
@@ -49,6 +50,7 @@
 #include "oecumenic_enumerations.hpp"
 #include "outlay.hpp"
 #include "premium_tax.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
 #include "rounding_rules.hpp"
 #include "stratified_charges.hpp"
 #include "ul_utilities.hpp"             // list_bill_premium(), max_modal_premium()
@@ -64,7 +66,7 @@
 //============================================================================
 BasicValues::BasicValues(Input const& input)
     :yare_input_         (input)
-    ,product_            (product_data::read_via_cache(filename_from_product_name(yare_input_.ProductName)))
+    ,product_            (read_product_via_cache(yare_input_.ProductName))
     ,database_           (yare_input_)
     ,lingo_              (lingo::read_via_cache
         (AddDataDir(product().datum("LingoFilename"))))
@@ -105,7 +107,7 @@ BasicValues::BasicValues
     // TODO ?? Need loan rate type here?
     )
     :yare_input_         (Input{})
-    ,product_            (product_data::read_via_cache(filename_from_product_name(a_ProductName)))
+    ,product_            (read_product_via_cache(a_ProductName))
     ,database_
         (a_ProductName
         ,a_Gender
@@ -192,6 +194,40 @@ BasicValues::BasicValues
     Init();
 }
 
+/// Rebind to a different cell, as though constructed anew from it.
+///
+/// Product files are read through caches, so rebinding to a cell of
+/// a product already in use costs only a few lookups. Data that Init()
+/// recreates are replaced; everything else that the constructor sets
+/// is reset here, in the same order.
+
+void BasicValues::Rebind(Input const& input)
+{
+    yare_input_          = yare_input(input);
+    product_             = read_product_via_cache(yare_input_.ProductName);
+    database_            = product_database(yare_input_);
+    lingo_               = lingo::read_via_cache
+        (AddDataDir(product().datum("LingoFilename")));
+    FundData_            = FundData::read_via_cache
+        (AddDataDir(product().datum("FundFilename")));
+    RoundingRules_       = rounding_rules::read_via_cache
+        (AddDataDir(product().datum("RoundingFilename")));
+    StratifiedCharges_   = stratified_charges::read_via_cache
+        (AddDataDir(product().datum("TierFilename")));
+    i7702_               = std::make_unique<i7702>(database(), *StratifiedCharges_);
+    DefnLifeIns_         = mce_cvat;
+    DefnMaterialChange_  = mce_unnecessary_premium;
+    Effective7702DboRop  = mce_option1_for_7702;
+    MaxWDDed_            = mce_twelve_times_last;
+    MaxLoanDed_          = mce_twelve_times_last;
+    StateOfJurisdiction_ = mce_s_CT;
+    StateOfDomicile_     = mce_s_CT;
+    PremiumTaxState_     = mce_s_CT;
+    InitialTargetPremium = 0.0;
+
+    Init();
+}
+
 /// Destructor.
 ///
 /// Although it is explicitly defaulted, this destructor is not
@@ -204,6 +240,7 @@ BasicValues::~BasicValues() = default;
 //============================================================================
 void BasicValues::Init()
 {
+    LMI_PROBE(probe_basic_values_init);
     SetRoundingFunctors();
 
     SetPermanentInvariants();
@@ -414,11 +451,12 @@ double BasicValues::InvestmentManagementFee() const
 
 void BasicValues::Init7702()
 {
+    LMI_PROBE(probe_init_7702);
     std::vector<double> Mly7702qc = GetIrc7702QRates();
     double max_coi_rate = database().query<double>(DB_MaxMonthlyCoiRate);
     LMI_ASSERT(0.0 != max_coi_rate);
     max_coi_rate = 1.0 / max_coi_rate;
-    assign(Mly7702qc, apply_binary(coi_rate_from_q<double>(), Mly7702qc, max_coi_rate));
+    coi_rate_from_q_batch<double>(Mly7702qc, max_coi_rate, Mly7702qc);
 
     // DCV follows the usual monthiversary mechanics, which involve
     // (optionally) rounding monthly COI rates.
@@ -515,6 +553,7 @@ void BasicValues::Init7702()
 //============================================================================
 void BasicValues::Init7702A()
 {
+    LMI_PROBE(probe_init_7702a);
     Irc7702A_ = std::make_unique<Irc7702A>
         (DefnLifeIns_
         ,DefnMaterialChange_
@@ -31,6 +31,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "instrumentation.hpp"
 #include "materially_equal.hpp"
 #include "miscellany.hpp"               // minmax
 #include "ssize_lmi.hpp"
@@ -331,6 +332,7 @@ void Irc7702A::Initialize7702A
 
 void Irc7702A::UpdateBOY7702A(int a_PolicyYear)
 {
+    LMI_PROBE(probe_irc7702a);
     if(Ignore || IsMec)
         {
         return;
@@ -363,6 +365,7 @@ void Irc7702A::UpdateBOY7702A(int a_PolicyYear)
 
 void Irc7702A::UpdateBOM7702A(int a_PolicyMonth)
 {
+    LMI_PROBE(probe_irc7702a);
     if(Ignore || IsMec)
         {
         return;
@@ -380,6 +383,7 @@ void Irc7702A::UpdateBOM7702A(int a_PolicyMonth)
 
 bool Irc7702A::UpdateEOM7702A()
 {
+    LMI_PROBE(probe_irc7702a);
     if(!(Ignore || IsMec))
         {
         ++TestPeriodDur;
@@ -400,6 +404,7 @@ void Irc7702A::Update1035Exch7702A
     ,double  a_Bft
     )
 {
+    LMI_PROBE(probe_irc7702a);
     LMI_ASSERT(0.0 <= a_Net1035Amount);
     a_DeemedCashValue = a_Net1035Amount;
 
@@ -530,6 +535,7 @@ double Irc7702A::MaxNonMecPremium
     ,double a_CashValue
     ) const
 {
+    LMI_PROBE(probe_irc7702a);
     // state_.B4_deduced_target_premium etc. are not set here because
     // this function is a mere inquiry, not an essential transaction.
     // However, state_.Q6_max_non_mec_prem is recorded because it's
@@ -621,6 +627,7 @@ double Irc7702A::MaxNecessaryPremium
     ,double a_CashValue
     ) const
 {
+    LMI_PROBE(probe_irc7702a);
     state_.B4_deduced_target_premium = a_TargetPrem;
     state_.B5_deduced_target_load    = a_LoadTarget;
     state_.B6_deduced_excess_load    = a_LoadExcess;
@@ -673,6 +680,7 @@ double Irc7702A::UpdatePmt7702A
     ,double // a_CashValue
     )
 {
+    LMI_PROBE(probe_irc7702a);
     if(Ignore || IsMec)
         {
         return a_Payment;
@@ -853,6 +861,7 @@ double Irc7702A::UpdateBft7702A
     ,double  // a_CashValue // TODO ?? TAXATION !! Not used.
     )
 {
+    LMI_PROBE(probe_irc7702a);
     if(Ignore || IsMec)
         {
         return 0.0;
@@ -1077,6 +1086,7 @@ void Irc7702A::TestBftDecrease(double a_NewBft)
 
 void Irc7702A::InduceMaterialChange()
 {
+    LMI_COUNT(probe_irc7702a_material_change);
     IsMatChg = true;
 }
 
@@ -1095,6 +1105,7 @@ void Irc7702A::RedressMatChg
     ,double  a_CashValue
     )
 {
+    LMI_PROBE(probe_irc7702a);
 // TODO ?? TAXATION !! I think all public functions in this class need this test:
     if(Ignore || IsMec || !IsMaterialChangeInQueue())
         {
@@ -27,10 +27,11 @@
 #include "assert_lmi.hpp"
 #include "basic_values.hpp"
 #include "et_vector.hpp"
-#include "math_functions.hpp"           // assign_midpoint()
+#include "math_functions.hpp"           // assign_midpoint(), coi_rate_from_q_batch()
 #include "oecumenic_enumerations.hpp"
 
 #include <algorithm>                    // min()
+#include <span>
 
 //============================================================================
 MortalityRates::MortalityRates(BasicValues const& basic_values)
@@ -109,18 +110,29 @@ void MortalityRates::SetCoiRates
     ,bool                       table_is_annual
     )
 {
+    std::span<double> const z(coi_rates.data(), Length_);
     for(int j = 0; j < Length_; ++j)
         {
-        double z = coi_rates[j] * coi_multiplier[j];
-        if(table_is_annual)
-            {
-            z = coi_rate_from_q<double>()(z, maximum[j]);
-            }
-        else
+        z[j] *= coi_multiplier[j];
+        }
+    if(table_is_annual)
+        {
+        coi_rate_from_q_batch<double>
+            (z
+            ,std::span<double const>(maximum.data(), Length_)
+            ,z
+            );
+        }
+    else
+        {
+        for(int j = 0; j < Length_; ++j)
             {
-            z = std::min                 (z, maximum[j]);
+            z[j] = std::min(z[j], maximum[j]);
             }
-        coi_rates[j] = round_coi_rate_(z);
+        }
+    for(int j = 0; j < Length_; ++j)
+        {
+        z[j] = round_coi_rate_(z[j]);
         }
 }
 
@@ -47,17 +47,20 @@
 #include "input.hpp"
 #include "istream_to_string.hpp"
 #include "ledger.hpp"
+#include "ledger_cache.hpp"
 #include "ledger_text_formats.hpp"
 #include "path_utility.hpp"             // unique_filepath()
 #include "safely_dereference_as.hpp"
 #include "timer.hpp"
 #include "wx_new.hpp"
 #include "wx_utility.hpp"               // class ClipboardEx
+#include "yare_input.hpp"
 
 #include <wx/html/htmlwin.h>
 #include <wx/xrc/xmlres.h>
 
 #include <fstream>
+#include <memory>                       // make_shared
 #include <string>
 
 IMPLEMENT_DYNAMIC_CLASS(IllustrationView, ViewEx)
@@ -291,6 +294,15 @@ void IllustrationView::UponUpdateProperties(wxUpdateUIEvent& e)
     e.Enable(!is_phony_);
 }
 
+/// Calculate an illustration for the current input.
+///
+/// Reuse the last ledger if nothing else that can affect the
+/// calculation (product files, e.g.) has changed since it was made,
+/// and the input is either unchanged or differs only in text that is
+/// merely copied into the ledger for display (agent's name, e.g.),
+/// in which case that text is replaced. Otherwise, run the full
+/// calculation.
+
 void IllustrationView::Run(Input* overriding_input)
 {
     Timer timer;
@@ -300,9 +312,26 @@ void IllustrationView::Run(Input* overriding_input)
         input_data() = *overriding_input;
         }
 
-    illustrator z(mce_emit_nothing);
-    z(base_filename(), input_data());
-    ledger_values_ = z.principal_ledger();
+    std::string const environment = ledger_cache::environment_key(input_data());
+    bool const reusable =
+           ledger_values_
+        && ledger_input_
+        && environment == ledger_environment_
+        ;
+    if(reusable && input_data().differs_only_in_presentation(*ledger_input_))
+        {
+        ledger_values_ = std::make_shared<Ledger const>
+            (ledger_values_->WithPresentationText(yare_input(input_data()))
+            );
+        }
+    else if(!reusable || !(input_data() == *ledger_input_))
+        {
+        illustrator z(mce_emit_nothing);
+        z(base_filename(), input_data());
+        ledger_values_ = z.principal_ledger();
+        }
+    ledger_input_       = std::make_shared<Input const>(input_data());
+    ledger_environment_ = environment;
 
     status() << "Calculate: " << timer.stop().elapsed_msec_str();
     timer.restart();
@@ -324,6 +353,8 @@ void IllustrationView::Run(Input* overriding_input)
 void IllustrationView::SetLedger(std::shared_ptr<Ledger const> ledger)
 {
     ledger_values_ = ledger;
+    ledger_input_.reset();
+    ledger_environment_.clear();
     LMI_ASSERT(ledger_values_.get());
 }
 
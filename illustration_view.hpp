@@ -40,6 +40,7 @@
 #include <wx/event.h>
 
 #include <memory>                       // shared_ptr
+#include <string>
 
 class IllustrationDocument;
 class Input;
@@ -102,6 +103,8 @@ class IllustrationView final
     wxHtmlWindow* html_window_                   {nullptr};
     bool is_phony_                               {false};
     std::shared_ptr<Ledger const> ledger_values_ {};
+    std::shared_ptr<Input const>  ledger_input_  {};
+    std::string ledger_environment_              {};
 
     DECLARE_DYNAMIC_CLASS(IllustrationView)
     DECLARE_EVENT_TABLE()
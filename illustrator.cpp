@@ -25,14 +25,20 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "census_tsv.hpp"
 #include "configurable_settings.hpp"
 #include "custom_io_0.hpp"
 #include "custom_io_1.hpp"
 #include "emit_ledger.hpp"
+#include "global_settings.hpp"
 #include "group_values.hpp"
 #include "handle_exceptions.hpp"        // report_exception()
 #include "input.hpp"
+#include "instrumentation.hpp"
+#include "istream_to_string.hpp"
+#include "ledger_cache.hpp"
 #include "ledgervalues.hpp"
+#include "miscellany.hpp"               // ios_in_binary()
 #include "multiple_cell_document.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"             // fs::path inserter
@@ -40,6 +46,7 @@
 #include "single_cell_document.hpp"
 #include "timer.hpp"
 
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -54,7 +61,7 @@ illustrator::illustrator(mcenum_emission emission)
 bool illustrator::operator()(fs::path const& file_path)
 {
     std::string const extension = file_path.extension().string();
-    if(".cns" == extension)
+    if(".cns" == extension || ".cnsb" == extension)
         {
         Timer timer;
         multiple_cell_document doc(file_path.string());
@@ -62,6 +69,25 @@ bool illustrator::operator()(fs::path const& file_path)
         seconds_for_input_ = timer.stop().elapsed_seconds();
         return operator()(file_path, doc.cell_parms());
         }
+    else if
+        (  extension
+        == configurable_settings::instance().spreadsheet_file_extension()
+        )
+        {
+        // Tab-delimited census, as copied from the GUI census manager.
+        Timer timer;
+        std::ifstream ifs(file_path.string(), ios_in_binary());
+        if(!ifs)
+            {
+            alarum() << "Unable to read file " << file_path << "." << LMI_FLUSH;
+            }
+        std::string text;
+        istream_to_string(ifs, text);
+        census_tsv const census = read_census_tsv(text, default_cell());
+        test_census_consensus(emission_, census.archetype, census.cells);
+        seconds_for_input_ = timer.stop().elapsed_seconds();
+        return operator()(file_path, census.cells);
+        }
     else if(".ill" == extension)
         {
         Timer timer;
@@ -115,14 +141,29 @@ bool illustrator::operator()(fs::path const& file_path)
         }
 }
 
+/// Illustrate a single cell.
+///
+/// If ledger caching is enabled, reuse the ledger of any identical
+/// illustration calculated earlier; see class ledger_cache.
+
 bool illustrator::operator()(fs::path const& file_path, Input const& z)
 {
     Timer timer;
-    IllusVal IV(file_path.string());
-    IV.run(z);
-    principal_ledger_ = IV.ledger();
+    bool const use_cache = global_settings::instance().cache_ledgers();
+    std::string const key = use_cache ? ledger_cache::key(z) : std::string();
+    principal_ledger_ = use_cache ? ledger_cache::instance().find(key) : nullptr;
+    if(!principal_ledger_)
+        {
+        IllusVal IV(file_path.string());
+        IV.run(z);
+        principal_ledger_ = IV.ledger();
+        if(use_cache)
+            {
+            ledger_cache::instance().store(key, principal_ledger_);
+            }
+        }
     seconds_for_calculations_ = timer.stop().elapsed_seconds();
-    seconds_for_output_ = emit_ledger(file_path, *IV.ledger(), emission_);
+    seconds_for_output_ = emit_ledger(file_path, *principal_ledger_, emission_);
     conditionally_show_timings_on_stdout();
     return true;
 }
@@ -152,6 +193,7 @@ void illustrator::conditionally_show_timings_on_stdout() const
             << Timer::elapsed_msec_str(seconds_for_output_)
             << '\n'
             ;
+        report_probes(std::cout);
         }
 }
 
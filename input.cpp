@@ -24,6 +24,7 @@
 #include "input.hpp"
 
 #include "alert.hpp"
+#include "contains.hpp"
 #include "database.hpp"                 // product_database::~product_database()
 #include "timer.hpp"
 
@@ -262,6 +263,92 @@ bool Input::operator==(Input const& z) const
     return MemberSymbolTable<Input>::equals(z);
 }
 
+namespace
+{
+/// Fields whose values are merely copied into a ledger for display
+/// (by LedgerInvariant::SetPresentationText()), and affect no
+/// calculation.
+///
+/// 'Comments' is deliberately not treated as presentation-only,
+/// because it may contain "idiosyncrasy" keywords that change what
+/// is calculated or written.
+
+bool is_presentation_field(std::string const& name)
+{
+    static std::vector<std::string> const presentation_fields
+        {"AgentAddress"
+        ,"AgentCity"
+        ,"AgentId"
+        ,"AgentName"
+        ,"AgentPhone"
+        ,"AgentState"
+        ,"AgentZipCode"
+        ,"ContractNumber"
+        ,"CorporationName"
+        ,"InsuredName"
+        ,"MasterContractNumber"
+        ,"SupplementalReportColumn00"
+        ,"SupplementalReportColumn01"
+        ,"SupplementalReportColumn02"
+        ,"SupplementalReportColumn03"
+        ,"SupplementalReportColumn04"
+        ,"SupplementalReportColumn05"
+        ,"SupplementalReportColumn06"
+        ,"SupplementalReportColumn07"
+        ,"SupplementalReportColumn08"
+        ,"SupplementalReportColumn09"
+        ,"SupplementalReportColumn10"
+        ,"SupplementalReportColumn11"
+        };
+    return contains(presentation_fields, name);
+}
+} // Unnamed namespace.
+
+/// Whether this object differs from another only in presentation.
+///
+/// Returns true iff the two objects differ, but only in fields that
+/// affect no calculation. Then a ledger calculated for one can be
+/// reused for the other, as with Ledger::WithPresentationText(),
+/// instead of calculated anew.
+
+bool Input::differs_only_in_presentation(Input const& z) const
+{
+    bool any_difference = false;
+    for(auto const& i : member_names())
+        {
+        if(operator[](i) != z[i])
+            {
+            if(!is_presentation_field(i))
+                {
+                return false;
+                }
+            any_difference = true;
+            }
+        }
+    return any_difference;
+}
+
+/// Canonical text of all fields that can affect a calculation.
+///
+/// Two objects whose fingerprints are equal are equal, or else they
+/// differ only in presentation: see differs_only_in_presentation().
+
+std::string Input::calculation_fingerprint() const
+{
+    std::string z;
+    for(auto const& i : member_names())
+        {
+        if(!is_presentation_field(i))
+            {
+            z += i;
+            z += '=';
+            z += operator[](i).str();
+            z += '\n';
+            }
+        }
+    return z;
+}
+
 mcenum_ledger_type Input::ledger_type () const {return GleanedLedgerType_;}
 int                Input::maturity_age() const {return GleanedMaturityAge_;}
 
@@ -119,6 +119,7 @@ class LMI_SO Input final
     ,public  MvcModel
     ,public  MemberSymbolTable          <Input>
 {
+    friend class binary_census;
     friend class input_test;
     friend class yare_input;
 
@@ -129,6 +130,8 @@ class LMI_SO Input final
 
     Input& operator=(Input const&);
     bool operator==(Input const&) const;
+    bool differs_only_in_presentation(Input const&) const;
+    std::string calculation_fingerprint() const;
 
     mcenum_ledger_type ledger_type () const;
     int                maturity_age() const;
@@ -32,22 +32,31 @@
 // End of headers tested here.
 
 #include "assert_lmi.hpp"
+#include "binary_census.hpp"
+#include "census_tsv.hpp"
 #include "dbdict.hpp"
 #include "dbnames.hpp"
 #include "global_settings.hpp"
-#include "miscellany.hpp"               // stifle_unused_warning()
+#include "istream_to_string.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), stifle_unused_warning()
 #include "oecumenic_enumerations.hpp"
+#include "ssize_lmi.hpp"
 #include "test_tools.hpp"
 #include "timer.hpp"
 #include "xml_lmi.hpp"
 
 #include <xmlwrapp/document.h>
 
+#include <cstdint>
 #include <cstdio>                       // remove()
+#include <cstring>                      // memcpy()
 #include <fstream>
 #include <functional>                   // bind()
 #include <ios>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class input_test
 {
@@ -57,6 +66,8 @@ class input_test
         test_product_database();
         test_input_class();
         test_document_classes();
+        test_binary_census();
+        test_census_tsv();
         test_obsolete_history();
         assay_speed();
         // Rerun this test after assay_speed() because it removes
@@ -68,6 +79,8 @@ class input_test
     static void test_product_database();
     static void test_input_class();
     static void test_document_classes();
+    static void test_binary_census();
+    static void test_census_tsv();
     static void test_obsolete_history();
     static void assay_speed();
 
@@ -224,6 +237,15 @@ void input_test::test_product_database()
     db.query_into(DB_SnflQ, v);
     LMI_TEST_EQUAL(55, db.length());
     LMI_TEST_EQUAL(55, v.size());
+
+    // Querying several keys at once is equivalent to querying each.
+    std::vector<double> w0;
+    std::vector<double> w1;
+    db.query_many({{DB_SnflQ, &w0}, {DB_MaturityAge, &w1}});
+    LMI_TEST(v == w0);
+    db.query_into(DB_MaturityAge, v);
+    LMI_TEST(v == w1);
+    db.query_into(DB_SnflQ, v);
     database_index index = db.index().issue_age(29);
     db.query_into(DB_SnflQ, v, index);
     LMI_TEST_EQUAL(55, db.length());
@@ -395,6 +417,21 @@ std::cout << "replica.FundAllocs.size() is " << replica.FundAllocs.size() << '\n
     LMI_TEST(std::string("Angela")    == copy1   .InsuredName.value());
     LMI_TEST(std::string("Full Name") == original.InsuredName.value());
 
+    // Test differs_only_in_presentation().
+    Input copy2(original);
+    LMI_TEST(!copy2.differs_only_in_presentation(original));
+    copy2["InsuredName"] = "Angela";
+    copy2["AgentState"]  = "NY";
+    LMI_TEST( copy2.differs_only_in_presentation(original));
+    LMI_TEST( original.differs_only_in_presentation(copy2));
+    LMI_TEST(original.calculation_fingerprint() == copy2.calculation_fingerprint());
+    copy2["Comments"]    = "idiosyncrasyY";
+    LMI_TEST(!copy2.differs_only_in_presentation(original));
+    copy2["Comments"]    = original["Comments"];
+    copy2["IssueAge"]    = std::string("58");
+    LMI_TEST(!copy2.differs_only_in_presentation(original));
+    LMI_TEST(original.calculation_fingerprint() != copy2.calculation_fingerprint());
+
     // For now at least, just test that this compiles and runs.
     yare_input y(original);
 }
@@ -407,6 +444,96 @@ void input_test::test_document_classes()
     test_document_io<S>("sample.ill", "replica.ill", __FILE__, __LINE__, false);
 }
 
+void input_test::test_binary_census()
+{
+    // Round trip: xml to binary to xml.
+    multiple_cell_document const original("sample.cns");
+    original.write_binary("eraseme.cnsb");
+    LMI_TEST(binary_census::is_binary_census("eraseme.cnsb"));
+    LMI_TEST(!binary_census::is_binary_census("sample.cns"));
+
+    multiple_cell_document const replica("eraseme.cnsb");
+    LMI_TEST(original.case_parms () == replica.case_parms ());
+    LMI_TEST(original.class_parms() == replica.class_parms());
+    LMI_TEST(original.cell_parms () == replica.cell_parms ());
+
+    std::ofstream ofs("eraseme.cns", ios_out_trunc_binary());
+    replica.write(ofs);
+    ofs.close();
+    LMI_TEST(files_are_identical("sample.cns", "eraseme.cns"));
+
+    // Random access to cells.
+    binary_census const census("eraseme.cnsb");
+    LMI_TEST_EQUAL(lmi::ssize(original.cell_parms()), census.cells_count());
+    int const last = census.cells_count() - 1;
+    LMI_TEST(original.cell_parms()[last] == census.cell(last));
+
+    // Counts that the file is too short to hold are rejected, even if
+    // multiplying them by their element sizes would overflow.
+    std::string image;
+    {
+    std::ifstream ifs("eraseme.cnsb", ios_in_binary());
+    istream_to_string(ifs, image);
+    }
+    // Offsets of 'n_cells' and 'n_strings' in the header.
+    for(std::size_t const offset : {24, 32})
+        {
+        for(std::uint64_t const count : {std::uint64_t(1) << 61, ~std::uint64_t(0)})
+            {
+            std::string forged(image);
+            std::memcpy(forged.data() + offset, &count, sizeof count);
+            std::ofstream("eraseme.cnsb", ios_out_trunc_binary()) << forged;
+            LMI_TEST_THROW
+                (binary_census("eraseme.cnsb")
+                ,std::runtime_error
+                ,lmi_test::what_regex("is corrupt")
+                );
+            }
+        }
+
+    LMI_TEST(0 == std::remove("eraseme.cns"));
+    LMI_TEST(0 == std::remove("eraseme.cnsb"));
+}
+
+void input_test::test_census_tsv()
+{
+    using v = std::vector<std::string_view>;
+
+    // Blank lines, and leading whitespace other than tabs, are skipped
+    // after each line--but not before the first, as with getline().
+    LMI_TEST(v{} == split_lines(""));
+    LMI_TEST((v{""}) == split_lines("\n"));
+    LMI_TEST((v{"a\tb", "c", "\td"}) == split_lines("a\tb\n\n  c\n\n\td\n"));
+    LMI_TEST((v{"a", "b"}) == split_lines("a\nb"));
+
+    Input const case_default;
+    census_tsv const z = read_census_tsv
+        ("Gender\tIssueAge\nFemale\t45\n\nMale\t50\t\n"
+        ,case_default
+        );
+    LMI_TEST_EQUAL("No", z.archetype["UseDOB"].str());
+    LMI_TEST_EQUAL(2, lmi::ssize(z.cells));
+    LMI_TEST_EQUAL("Female", z.cells[0]["Gender"].str());
+    LMI_TEST_EQUAL("50", z.cells[1]["IssueAge"].str());
+
+    // Ragged rows are rejected.
+    LMI_TEST_THROW
+        (read_census_tsv("Gender\tIssueAge\nFemale\t45\nMale\n", case_default)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Line #2: .* Number of values: 1; number expected: 2")
+        );
+    LMI_TEST_THROW
+        (read_census_tsv("Gender\nFemale\t45\n", case_default)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Line #1: .* Number of values: 2; number expected: 1")
+        );
+    LMI_TEST_THROW
+        (read_census_tsv("", case_default)
+        ,std::runtime_error
+        ,"Census data has no header line."
+        );
+}
+
 void input_test::test_obsolete_history()
 {
     Input z;
@@ -0,0 +1,238 @@
+// Optional instrumentation of the calculation hot path.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "instrumentation.hpp"
+
+#if defined LMI_INSTRUMENT
+
+#include <algorithm>                    // find()
+#include <chrono>
+#include <cstring>                      // strcmp()
+#include <iomanip>                      // setw()
+#include <iterator>                     // size()
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+struct site_info
+{
+    char const* phase;
+    char const* name;
+};
+
+site_info const site_infos[] =
+    {{"setup"       , "BasicValues::Init()"                       }
+    ,{"setup"       , "BasicValues::Init7702()"                   }
+    ,{"setup"       , "BasicValues::Init7702A()"                  }
+    ,{"setup"       , "AccountValue::InitializeLife()"            }
+    ,{"monthly"     , "AccountValue::DoMonthDR()"                 }
+    ,{"monthly"     , "AccountValue::DoMonthCR()"                 }
+    ,{"transactions", "TxCapitalizeLoan()"                        }
+    ,{"transactions", "TxOptionChange()"                          }
+    ,{"transactions", "TxSpecAmtChange()"                         }
+    ,{"transactions", "TxTakeWD()"                                }
+    ,{"transactions", "TxExch1035()"                              }
+    ,{"transactions", "TxAscertainDesiredPayment()"               }
+    ,{"transactions", "TxLimitPayment()"                          }
+    ,{"transactions", "TxAcceptPayment()"                         }
+    ,{"transactions", "TxTakeLoan()"                              }
+    ,{"transactions", "TxLoanRepay()"                             }
+    ,{"transactions", "TxSetBOMAV()"                              }
+    ,{"transactions", "TxTestHoneymoonForExpiration()"            }
+    ,{"transactions", "TxSetDeathBft()"                           }
+    ,{"transactions", "TxSetTermAmt()"                            }
+    ,{"transactions", "TxSetCoiCharge()"                          }
+    ,{"transactions", "TxSetRiderDed()"                           }
+    ,{"transactions", "TxDoMlyDed()"                              }
+    ,{"transactions", "TxTakeSepAcctLoad()"                       }
+    ,{"transactions", "TxLoanInt()"                               }
+    ,{"transactions", "TxCreditInt()"                             }
+    ,{"transactions", "TxTestLapse()"                             }
+    ,{"transactions", "TxDebug()"                                 }
+    ,{"7702"        , "TxTestGPT()"                               }
+    ,{"7702A"       , "class Irc7702A, monthly processing"        }
+    ,{"7702A"       , "material changes induced"                  }
+    ,{"solve"       , "AccountValue::Solve()"                     }
+    ,{"solve"       , "AccountValue::SolveGuarPremium()"          }
+    };
+
+static_assert(probe_n_sites == std::size(site_infos));
+
+/// One thread's totals.
+
+struct thread_probes
+{
+    thread_probes();
+    ~thread_probes();
+
+    probe_counter counters[probe_n_sites];
+};
+
+/// All threads' totals.
+///
+/// Each thread's totals are registered here while the thread runs,
+/// and added to the retired totals when it ends. Totals as of the
+/// last report are kept, so that each report shows only what has
+/// happened since the previous one.
+///
+/// To convert ticks to seconds, the clock is compared to
+/// std::chrono::steady_clock over the life of the program.
+///
+/// This is a simple Meyers singleton. Because each thread's totals
+/// refer to it as they are constructed, it is destroyed only after
+/// they are.
+
+struct probe_registry
+{
+    static probe_registry& instance();
+
+    std::mutex                 mutex;
+    std::vector<thread_probes*> live;
+    std::uint64_t retired_calls [probe_n_sites] {};
+    std::uint64_t retired_ticks [probe_n_sites] {};
+    std::uint64_t reported_calls[probe_n_sites] {};
+    std::uint64_t reported_ticks[probe_n_sites] {};
+
+    std::uint64_t                         const origin_ticks {probe_ticks()};
+    std::chrono::steady_clock::time_point const origin_time
+        {std::chrono::steady_clock::now()};
+};
+
+probe_registry& probe_registry::instance()
+{
+    static probe_registry z;
+    return z;
+}
+
+thread_probes::thread_probes()
+{
+    probe_registry& r = probe_registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+}
+
+thread_probes::~thread_probes()
+{
+    probe_registry& r = probe_registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for(int j = 0; j < probe_n_sites; ++j)
+        {
+        r.retired_calls[j] += counters[j].calls.load(std::memory_order_relaxed);
+        r.retired_ticks[j] += counters[j].ticks.load(std::memory_order_relaxed);
+        }
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+}
+} // Unnamed namespace.
+
+probe_counter& this_thread_probe(probe_site site)
+{
+    thread_local thread_probes z;
+    return z.counters[site];
+}
+
+void report_probes(std::ostream& os)
+{
+    std::uint64_t calls[probe_n_sites];
+    std::uint64_t ticks[probe_n_sites];
+    double seconds_per_tick = 0.0;
+    bool any = false;
+    {
+    probe_registry& r = probe_registry::instance();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for(int j = 0; j < probe_n_sites; ++j)
+        {
+        std::uint64_t c = r.retired_calls[j];
+        std::uint64_t t = r.retired_ticks[j];
+        for(auto const* i : r.live)
+            {
+            c += i->counters[j].calls.load(std::memory_order_relaxed);
+            t += i->counters[j].ticks.load(std::memory_order_relaxed);
+            }
+        calls[j] = c - r.reported_calls[j];
+        ticks[j] = t - r.reported_ticks[j];
+        r.reported_calls[j] = c;
+        r.reported_ticks[j] = t;
+        any = any || 0 != calls[j];
+        }
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - r.origin_time;
+    std::uint64_t const elapsed_ticks = probe_ticks() - r.origin_ticks;
+    if(0 != elapsed_ticks)
+        {
+        seconds_per_tick = elapsed.count() / static_cast<double>(elapsed_ticks);
+        }
+    }
+
+    if(!any)
+        {
+        return;
+        }
+
+    std::ostringstream oss;
+    oss
+        << "\n    Instrumented sites (times include nested sites):\n"
+        << std::fixed
+        ;
+    char const* phase = "";
+    for(int j = 0; j < probe_n_sites; ++j)
+        {
+        if(0 == calls[j])
+            {
+            continue;
+            }
+        site_info const& s = site_infos[j];
+        if(0 != std::strcmp(phase, s.phase))
+            {
+            phase = s.phase;
+            oss << "    " << phase << '\n';
+            }
+        double const msec = 1000.0 * seconds_per_tick * static_cast<double>(ticks[j]);
+        oss
+            << "      " << std::left << std::setw(40) << s.name << std::right
+            << std::setw(12) << calls[j] << " calls"
+            ;
+        if(0 != ticks[j])
+            {
+            oss
+                << std::setprecision(3)
+                << std::setw(12) << msec << " msec"
+                << std::setw(12) << 1000.0 * msec / static_cast<double>(calls[j])
+                << " usec/call"
+                ;
+            }
+        oss << '\n';
+        }
+    os << oss.str();
+}
+
+#else  // !defined LMI_INSTRUMENT
+
+void report_probes(std::ostream&)
+{
+}
+
+#endif // !defined LMI_INSTRUMENT
@@ -0,0 +1,182 @@
+// Optional instrumentation of the calculation hot path.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef instrumentation_hpp
+#define instrumentation_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <iosfwd>
+
+#if defined LMI_INSTRUMENT
+#   include <atomic>
+#   include <cstdint>
+#   if defined LMI_X86
+#       include <x86intrin.h>           // __rdtsc()
+#   else  // !defined LMI_X86
+#       include <chrono>
+#   endif // !defined LMI_X86
+#endif // defined LMI_INSTRUMENT
+
+/// Instrumented sites in the calculation hot path.
+///
+/// Each enumerator names one site; report_probes() groups them by
+/// phase, in this order.
+
+enum probe_site
+    {probe_basic_values_init
+    ,probe_init_7702
+    ,probe_init_7702a
+    ,probe_initialize_life
+    ,probe_do_month_dr
+    ,probe_do_month_cr
+    ,probe_tx_capitalize_loan
+    ,probe_tx_option_change
+    ,probe_tx_spec_amt_change
+    ,probe_tx_take_wd
+    ,probe_tx_exch_1035
+    ,probe_tx_ascertain_desired_payment
+    ,probe_tx_limit_payment
+    ,probe_tx_accept_payment
+    ,probe_tx_take_loan
+    ,probe_tx_loan_repay
+    ,probe_tx_set_bom_av
+    ,probe_tx_test_honeymoon
+    ,probe_tx_set_death_bft
+    ,probe_tx_set_term_amt
+    ,probe_tx_set_coi_charge
+    ,probe_tx_set_rider_ded
+    ,probe_tx_do_mly_ded
+    ,probe_tx_take_sep_acct_load
+    ,probe_tx_loan_int
+    ,probe_tx_credit_int
+    ,probe_tx_test_lapse
+    ,probe_tx_debug
+    ,probe_tx_test_gpt
+    ,probe_irc7702a
+    ,probe_irc7702a_material_change
+    ,probe_solve
+    ,probe_solve_guar_premium
+    ,probe_n_sites
+    };
+
+/// Write call counts and times for all sites since the last report.
+///
+/// Writes nothing unless instrumentation was compiled in and some
+/// instrumented site has been reached since the last report.
+
+LMI_SO void report_probes(std::ostream&);
+
+/// Instrumentation is compiled in only if LMI_INSTRUMENT is defined,
+/// e.g., by adding '-DLMI_INSTRUMENT' to $(CPPFLAGS). Otherwise, the
+/// macros expand to nothing, so that production code pays nothing
+/// for them.
+///
+/// LMI_PROBE(site) counts entries into the enclosing scope and
+/// measures the time spent in it. Times are inclusive of any other
+/// sites reached from that scope. If a site is re-entered (e.g., a
+/// solve that runs a solve), only the outermost entry is timed, so
+/// that no time is counted twice for the same site.
+///
+/// LMI_COUNT(site) only counts how many times it is reached.
+///
+/// Totals are kept per thread, without locking, and aggregated only
+/// when a report is written.
+
+#if defined LMI_INSTRUMENT
+
+/// Totals for one site on one thread.
+///
+/// Only the owning thread writes these counters, so they needn't be
+/// incremented atomically; relaxed atomic loads and stores compile to
+/// plain moves, yet let another thread read them for a report.
+
+struct probe_counter
+{
+    std::atomic<std::uint64_t> calls {0};
+    std::atomic<std::uint64_t> ticks {0};
+    int                        depth {0};
+};
+
+LMI_SO probe_counter& this_thread_probe(probe_site);
+
+/// Ticks of the finest clock available: RDTSC where possible.
+
+inline std::uint64_t probe_ticks()
+{
+#if defined LMI_X86
+    return __rdtsc();
+#else  // !defined LMI_X86
+    auto const t = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>
+        (std::chrono::duration_cast<std::chrono::nanoseconds>(t).count()
+        );
+#endif // !defined LMI_X86
+}
+
+inline void probe_add(std::atomic<std::uint64_t>& z, std::uint64_t n)
+{
+    z.store(n + z.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+class scoped_probe
+{
+  public:
+    explicit scoped_probe(probe_site site)
+        :counter_   {this_thread_probe(site)}
+        ,outermost_ {0 == counter_.depth++}
+        ,start_     {outermost_ ? probe_ticks() : 0}
+        {
+        }
+
+    ~scoped_probe()
+        {
+        if(outermost_)
+            {
+            probe_add(counter_.ticks, probe_ticks() - start_);
+            }
+        probe_add(counter_.calls, 1);
+        --counter_.depth;
+        }
+
+  private:
+    scoped_probe(scoped_probe const&) = delete;
+    scoped_probe& operator=(scoped_probe const&) = delete;
+
+    probe_counter&      counter_;
+    bool          const outermost_;
+    std::uint64_t const start_;
+};
+
+#   define LMI_PROBE(site) scoped_probe const lmi_scoped_probe {site}
+#   define LMI_COUNT(site) probe_add(this_thread_probe(site).calls, 1)
+
+#else  // !defined LMI_INSTRUMENT
+
+#   define LMI_PROBE(site)
+#   define LMI_COUNT(site)
+
+#endif // !defined LMI_INSTRUMENT
+
+#endif // instrumentation_hpp
@@ -260,6 +260,27 @@ void Ledger::SetGuarPremium(double a_GuarPrem)
     ledger_invariant_->GuarPrem = a_GuarPrem;
 }
 
+//============================================================================
+void Ledger::OmitGuarPremium()
+{
+    ledger_invariant_->OmitGuarPrem();
+}
+
+/// Copy of this ledger, with text copied from the given input.
+///
+/// Values calculated by basis are shared with the original, as with
+/// the implicitly-defined copy ctor (see the comment on bug 13599
+/// above), but the invariant ledger is not: it is copied, so that
+/// the original remains unchanged.
+
+Ledger Ledger::WithPresentationText(yare_input const& y) const
+{
+    Ledger z(*this);
+    z.ledger_invariant_ = std::make_shared<LedgerInvariant>(*ledger_invariant_);
+    z.ledger_invariant_->SetPresentationText(y);
+    return z;
+}
+
 //============================================================================
 void Ledger::SetOneLedgerVariant
     (mcenum_run_basis     a_Basis
@@ -59,9 +59,11 @@
 class LedgerInvariant;
 class LedgerVariant;
 class ledger_map_holder;
+class yare_input;
 
 class LMI_SO Ledger final
 {
+    friend class ledger_image;
     friend class ledger_test;
 
   public:
@@ -80,6 +82,9 @@ class LMI_SO Ledger final
     void SetOneLedgerVariant(mcenum_run_basis, LedgerVariant const&);
 
     void SetGuarPremium(double);
+    void OmitGuarPremium();
+
+    Ledger WithPresentationText(yare_input const&) const;
 
     void AutoScale();
 
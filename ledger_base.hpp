@@ -171,6 +171,7 @@ typedef std::map<std::string,double*> scalar_map;
 class LMI_SO LedgerBase
 {
     friend class Ledger;
+    friend class ledger_image;
 
   public:
     virtual ~LedgerBase() = default;
@@ -0,0 +1,343 @@
+// Cache of ledgers for repeated illustrations of identical input.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "ledger_cache.hpp"
+
+#include "alert.hpp"
+#include "calendar_date.hpp"
+#include "configurable_settings.hpp"
+#include "data_directory.hpp"           // AddDataDir()
+#include "global_settings.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_image.hpp"
+#include "md5sum.hpp"                   // md5_calculate_file_checksum()
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "path.hpp"
+#include "product_data.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
+#include "version.hpp"
+
+#include <cstdint>                      // uint64_t, uintmax_t
+#include <cstring>                      // memcpy()
+#include <map>
+#include <mutex>
+#include <random>                       // random_device
+#include <sstream>
+#include <string>
+
+namespace
+{
+/// MD5 digest of a file's contents.
+///
+/// Digests are remembered, and recomputed only when a file's
+/// modification time or size changes, so that rate tables need not
+/// be read for every key.
+
+std::string file_digest(fs::path const& path)
+{
+    struct digest
+    {
+        fs::file_time_type write_time;
+        std::uintmax_t     size;
+        std::string        md5;
+    };
+    static std::mutex mutex;
+    static std::map<fs::path,digest> digests;
+
+    auto const write_time = fs::last_write_time(path);
+    auto const size       = fs::file_size(path);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto const i = digests.find(path);
+    if(digests.end() != i && write_time == i->second.write_time && size == i->second.size)
+        {
+        return i->second.md5;
+        }
+    std::string const md5 = md5_calculate_file_checksum(path);
+    digests.insert_or_assign(path, digest {write_time, size, md5});
+    return md5;
+}
+
+/// Append a file's digest to a cache key.
+///
+/// A file that does not exist is marked as such, so that creating it
+/// changes the key.
+
+void append_file_digest(std::string& key, fs::path const& path)
+{
+    key += '\n';
+    key += path.string();
+    if(!fs::exists(path))
+        {
+        key += " absent";
+        return;
+        }
+    key += ' ' + file_digest(path);
+}
+
+/// File in which a key's ledger is stored on disk, named for the
+/// MD5 digest of the key.
+
+fs::path disk_filename(std::string const& key)
+{
+    std::istringstream iss(key);
+    std::string const md5 = md5_calculate_stream_checksum(iss, "ledger cache key");
+    return global_settings::instance().ledger_cache_directory() / (md5 + ".ledger");
+}
+
+/// Read a ledger stored on disk, if there is one for the given key.
+///
+/// A file holds the size of the key, as a 64-bit word, then the key
+/// itself, then an image of the ledger (see class ledger_image). The
+/// whole key is compared, so that keys whose digests collide can't
+/// be confused. A file that can't be read, or that holds a different
+/// key, is treated as absent; storing the key's ledger replaces it.
+
+std::shared_ptr<Ledger const> read_from_disk(std::string const& key)
+{
+    fs::path const filename = disk_filename(key);
+    if(!fs::exists(filename))
+        {
+        return {};
+        }
+    try
+        {
+        std::string image;
+        {
+        fs::ifstream ifs(filename, ios_in_binary());
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        image = oss.str();
+        }
+        std::uint64_t key_size;
+        if(image.size() < sizeof key_size)
+            {
+            return {};
+            }
+        std::memcpy(&key_size, image.data(), sizeof key_size);
+        std::size_t const offset = sizeof key_size + key.size();
+        if
+            (  key.size() != key_size
+            || image.size() < offset
+            || 0 != image.compare(sizeof key_size, key.size(), key)
+            )
+            {
+            return {};
+            }
+        ledger_image const z(image.data() + offset, image.size() - offset);
+        return std::make_shared<Ledger const>(z.ledger());
+        }
+    catch(std::exception const&)
+        {
+        return {};
+        }
+}
+
+/// Store a ledger on disk, in the format read_from_disk() reads.
+///
+/// The file is written under a temporary name and then renamed, so
+/// that a reader never sees a partial file. Another process may be
+/// storing the same key at the same moment, so the temporary name
+/// is made unique.
+
+void write_to_disk(std::string const& key, Ledger const& ledger)
+{
+    fs::path const filename = disk_filename(key);
+    fs::path const temporary
+        (filename.string() + '.' + std::to_string(std::random_device()()) + ".tmp"
+        );
+    std::uint64_t const key_size = key.size();
+    std::string const image = ledger_image::image(ledger);
+    {
+    fs::ofstream ofs(temporary, ios_out_trunc_binary());
+    ofs.write(reinterpret_cast<char const*>(&key_size), sizeof key_size);
+    ofs << key << image;
+    if(!ofs)
+        {
+        alarum() << "Unable to write cached ledger " << temporary << "." << LMI_FLUSH;
+        }
+    }
+    fs::rename(temporary, filename);
+}
+} // Unnamed namespace.
+
+ledger_cache& ledger_cache::instance()
+{
+    try
+        {
+        static ledger_cache z;
+        return z;
+        }
+    catch(...)
+        {
+        report_exception();
+        alarum() << "Instantiation failed." << LMI_FLUSH;
+        throw "Unreachable--silences a compiler diagnostic.";
+        }
+}
+
+/// Canonical text of everything that can affect a calculation.
+
+std::string ledger_cache::key(Input const& input)
+{
+    std::string z = environment_key(input);
+    for(auto const& i : input.member_names())
+        {
+        z += '\n' + i + '=' + input[i].str();
+        }
+    return z;
+}
+
+/// Canonical text of everything but the input's own fields that can
+/// affect its calculation.
+///
+/// Every product datum whose name ends in "Filename" names a file
+/// that may be used: either a product file, or an SOA table database
+/// whose '.dat' and '.ndx' files are digested as well.
+
+std::string ledger_cache::environment_key(Input const& input)
+{
+    global_settings const& g = global_settings::instance();
+    std::string z = LMI_VERSION;
+    z += '\n' + g.data_directory().string();
+    z += '\n' + std::to_string(g.mellon());
+    z += '\n' + std::to_string(g.ash_nazg());
+    z += '\n' + std::to_string(g.regression_testing());
+    z += '\n' + g.pyx();
+    z += '\n' + g.prospicience_date().str();
+
+    std::string const product_name = input["ProductName"].str();
+    append_file_digest(z, fs::path(filename_from_product_name(product_name)));
+    auto const p = read_product_via_cache(product_name);
+    if(!p)
+        {
+        return z; // Antediluvian branch: no product data.
+        }
+    std::string const suffix = "Filename";
+    for(auto const& i : p->member_names())
+        {
+        if(!i.ends_with(suffix))
+            {
+            continue;
+            }
+        std::string const& name = p->datum(i);
+        if(name.empty())
+            {
+            continue;
+            }
+        std::string const path = AddDataDir(name);
+        append_file_digest(z, fs::path(path));
+        append_file_digest(z, fs::path(path + ".dat"));
+        append_file_digest(z, fs::path(path + ".ndx"));
+        }
+    return z;
+}
+
+/// Directory where ledgers are ordinarily stored on disk.
+
+std::string ledger_cache::default_directory()
+{
+    fs::path const z(configurable_settings::instance().print_directory());
+    return (z / "ledger_cache").string();
+}
+
+/// Ledger stored for the given key, or a null pointer if none is.
+///
+/// If global_settings::ledger_cache_directory() is not empty, then a
+/// key not found in memory is sought on disk, and a ledger found there
+/// is also kept in memory.
+
+std::shared_ptr<Ledger const> ledger_cache::find(std::string const& key)
+{
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto const i = ledgers_.find(key);
+    if(ledgers_.end() != i)
+        {
+        return i->second;
+        }
+    }
+    if(global_settings::instance().ledger_cache_directory().empty())
+        {
+        return {};
+        }
+    auto const z = read_from_disk(key);
+    if(z)
+        {
+        remember(key, z);
+        }
+    return z;
+}
+
+/// Store a ledger, in memory and, if global_settings member
+/// ledger_cache_directory() is not empty, on disk.
+///
+/// Failure to write to disk is reported, but doesn't prevent the
+/// ledger from being kept in memory.
+
+void ledger_cache::store
+    (std::string const&            key
+    ,std::shared_ptr<Ledger const> ledger
+    )
+{
+    remember(key, ledger);
+    if(!global_settings::instance().ledger_cache_directory().empty())
+        {
+        try
+            {
+            write_to_disk(key, *ledger);
+            }
+        catch(...)
+            {
+            report_exception();
+            }
+        }
+}
+
+/// Keep a ledger in memory, evicting the oldest if there are too many.
+
+void ledger_cache::remember
+    (std::string const&            key
+    ,std::shared_ptr<Ledger const> ledger
+    )
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(ledgers_.insert_or_assign(key, ledger).second)
+        {
+        keys_.push_back(key);
+        }
+    while(capacity < static_cast<int>(keys_.size()))
+        {
+        ledgers_.erase(keys_.front());
+        keys_.pop_front();
+        }
+}
+
+void ledger_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ledgers_.clear();
+    keys_.clear();
+}
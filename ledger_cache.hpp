@@ -0,0 +1,105 @@
+// Cache of ledgers for repeated illustrations of identical input.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef ledger_cache_hpp
+#define ledger_cache_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <deque>
+#include <memory>                       // shared_ptr
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class Input;
+class Ledger;
+
+/// Ledgers of recent illustrations, for reuse when identical input
+/// is illustrated again.
+///
+/// The same input is often illustrated repeatedly--to print it again,
+/// or to emit it in a different format. If global_settings member
+/// cache_ledgers() is true, then class illustrator stores each ledger
+/// it calculates here, and reuses it in place of calculating an
+/// identical illustration anew.
+///
+/// Ledgers are keyed by the canonical text of everything that can
+/// affect a calculation: the program version, the global settings
+/// that govern calculations, every input field, and an MD5 digest of
+/// each product file and rate table the input's product uses. The
+/// full text serves as the key, so different input can never be
+/// mistaken for the same input, as it might if only a hash of it were
+/// stored. The input is keyed as given, rather than after
+/// Input::consummate() reconciles it, because reconciliation is a
+/// function of the input alone. The rest of the key, which depends
+/// only on the input's product, is available as environment_key() to
+/// callers that compare input themselves.
+///
+/// Only the 'capacity' most recent ledgers are kept in memory, so
+/// that memory is bounded.
+///
+/// Optionally, ledgers are stored on disk as well, under the directory
+/// given by global_settings::ledger_cache_directory() (ordinarily,
+/// default_directory(), under the print directory), so that a
+/// process that runs a single illustration, like the CGI program,
+/// can reuse a ledger calculated by an earlier process. Each is
+/// stored as a ledger_image, in a file named for the MD5 digest of
+/// its key, along with the key itself so that a collision can't be
+/// mistaken for a match. Files on disk are never evicted: removing
+/// them is left to whoever administers that directory.
+///
+/// This is a simple Meyers singleton, with the expected dead-reference
+/// issues. Its members may be called from any thread.
+
+class LMI_SO ledger_cache final
+{
+  public:
+    static ledger_cache& instance();
+
+    static std::string key(Input const&);
+    static std::string environment_key(Input const&);
+    static std::string default_directory();
+
+    std::shared_ptr<Ledger const> find(std::string const& key);
+    void store(std::string const& key, std::shared_ptr<Ledger const>);
+    void clear();
+
+    static constexpr int capacity {100};
+
+  private:
+    ledger_cache() = default;
+    ~ledger_cache() = default;
+    ledger_cache(ledger_cache const&) = delete;
+    ledger_cache& operator=(ledger_cache const&) = delete;
+
+    void remember(std::string const& key, std::shared_ptr<Ledger const>);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string,std::shared_ptr<Ledger const>> ledgers_;
+    // Keys in order of insertion, oldest first, for eviction.
+    std::deque<std::string> keys_;
+};
+
+#endif // ledger_cache_hpp
@@ -0,0 +1,185 @@
+// Cache of ledgers for identical illustrations--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger_cache.hpp"
+
+#include "global_settings.hpp"
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_image.hpp"
+#include "mc_enum_types.hpp"
+#include "miscellany.hpp"               // ios_out_trunc_binary()
+#include "path.hpp"
+#include "product_data.hpp"             // filename_from_product_name()
+#include "test_tools.hpp"
+#include "version.hpp"
+
+#include <fstream>
+#include <memory>                       // make_shared()
+#include <string>
+
+void authenticate_system() {} // Do-nothing stub.
+
+namespace
+{
+std::shared_ptr<Ledger const> new_ledger()
+{
+    return std::make_shared<Ledger const>(100, mce_finra, false, false, false);
+}
+} // Unnamed namespace.
+
+/// Test that a key reflects the input and the product files.
+///
+/// The environment key reflects everything but the input.
+
+void test_key()
+{
+    Input input;
+    std::string const k0 = ledger_cache::key(input);
+    LMI_TEST_EQUAL(k0, ledger_cache::key(input));
+    LMI_TEST(k0.starts_with(LMI_VERSION));
+
+    std::string const policy = filename_from_product_name(input["ProductName"].str());
+    LMI_TEST(std::string::npos != k0.find('\n' + policy + ' '));
+    LMI_TEST(std::string::npos == k0.find('\n' + policy + " absent"));
+
+    LMI_TEST(std::string::npos != k0.find("\nIssueAge=45"));
+    input["IssueAge"] = std::string("57");
+    std::string const k1 = ledger_cache::key(input);
+    LMI_TEST(k0 != k1);
+    LMI_TEST(std::string::npos != k1.find("\nIssueAge=57"));
+
+    // Input fields don't affect the environment key, which begins
+    // every key.
+    std::string const e = ledger_cache::environment_key(input);
+    LMI_TEST(std::string::npos == e.find("\nIssueAge="));
+    LMI_TEST(k0.starts_with(e));
+    LMI_TEST(k1.starts_with(e));
+
+    // Restoring the original input restores the original key.
+    input["IssueAge"] = std::string("45");
+    LMI_TEST_EQUAL(k0, ledger_cache::key(input));
+}
+
+/// Test storing and finding ledgers.
+
+void test_find_and_store()
+{
+    ledger_cache& cache = ledger_cache::instance();
+    cache.clear();
+    LMI_TEST(nullptr == cache.find("a"));
+
+    auto const a = new_ledger();
+    auto const b = new_ledger();
+    cache.store("a", a);
+    LMI_TEST(a == cache.find("a"));
+    LMI_TEST(nullptr == cache.find("b"));
+
+    // Storing under an existing key replaces the ledger.
+    cache.store("a", b);
+    LMI_TEST(b == cache.find("a"));
+
+    cache.clear();
+    LMI_TEST(nullptr == cache.find("a"));
+}
+
+/// Test that the oldest ledgers are evicted when capacity is reached.
+
+void test_capacity()
+{
+    ledger_cache& cache = ledger_cache::instance();
+    cache.clear();
+    auto const z = new_ledger();
+    for(int j = 0; j < ledger_cache::capacity; ++j)
+        {
+        cache.store(std::to_string(j), z);
+        }
+    LMI_TEST(z == cache.find("0"));
+    LMI_TEST(z == cache.find(std::to_string(ledger_cache::capacity - 1)));
+
+    // Replacing a ledger doesn't make its key any newer.
+    cache.store("0", z);
+    cache.store("new", z);
+    LMI_TEST(nullptr == cache.find("0"));
+    LMI_TEST(z == cache.find("1"));
+    LMI_TEST(z == cache.find("new"));
+
+    cache.store("newer", z);
+    LMI_TEST(nullptr == cache.find("1"));
+    LMI_TEST(z == cache.find("2"));
+    cache.clear();
+}
+
+/// Test storing ledgers on disk.
+///
+/// A ledger stored by one process is found by another, which is
+/// simulated here by clearing the cache's memory.
+
+void test_disk()
+{
+    ledger_cache& cache = ledger_cache::instance();
+    cache.clear();
+    std::string const directory = "ledger_cache_eraseme";
+    global_settings::instance().set_ledger_cache_directory(directory);
+
+    auto const a = new_ledger();
+    cache.store("a", a);
+    cache.clear();
+    auto const z = cache.find("a");
+    LMI_TEST(nullptr != z);
+    LMI_TEST(a != z);
+    LMI_TEST_EQUAL(ledger_image::image(*a), ledger_image::image(*z));
+    // Once found on disk, it's kept in memory.
+    LMI_TEST(z == cache.find("a"));
+    LMI_TEST(nullptr == cache.find("b"));
+
+    // A file that doesn't hold the key sought is treated as absent.
+    cache.clear();
+    for(auto const& i : fs::directory_iterator(directory))
+        {
+        std::ofstream(i.path().string(), ios_out_trunc_binary()) << "corrupt";
+        }
+    LMI_TEST(nullptr == cache.find("a"));
+
+    // Storing the key again replaces the bad file.
+    cache.store("a", a);
+    cache.clear();
+    LMI_TEST(nullptr != cache.find("a"));
+
+    cache.clear();
+    global_settings::instance().set_ledger_cache_directory("");
+    LMI_TEST(nullptr == cache.find("a"));
+    fs::remove_all(directory);
+}
+
+int test_main(int, char*[])
+{
+    // Location of product files.
+    global_settings::instance().set_data_directory("/opt/lmi/data");
+
+    test_key();
+    test_find_and_store();
+    test_capacity();
+    test_disk();
+    return 0;
+}
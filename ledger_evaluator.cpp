@@ -25,6 +25,7 @@
 #include "ledger_evaluator.hpp"
 
 #include "alert.hpp"
+#include "assert_lmi.hpp"
 #include "authenticity.hpp"
 #include "bourn_cast.hpp"
 #include "calendar_date.hpp"
@@ -48,6 +49,8 @@
 
 #include <functional>                   // minus
 #include <map>
+#include <memory>                       // make_shared()
+#include <mutex>
 #include <numeric>                      // iota()
 #include <unordered_map>
 #include <utility>                      // move(), pair
@@ -135,7 +138,7 @@ bool format_exists
         }
 }
 
-title_map_t static_titles()
+title_map_t const& static_titles()
 {
 //  Here are the columns to be listed in the user interface
 //  as well as their corresponding titles.
@@ -218,10 +221,12 @@ title_map_t static_titles()
     ,{"IrrDb_Guaranteed"                , "Guar IRR\non DB"}
     ,{"LoanIntAccrued_Current"          , "Curr Loan\nInt\nAccrued"}
     ,{"LoanIntAccrued_Guaranteed"       , "Guar Loan\nInt\nAccrued"}
+    ,{"MiscCharges"                     , "Miscellaneous\nCharges"}
     ,{"ModalMinimumPremium"             , "Modal\nMinimum\nPremium"}
 //  ,{"NaarForceout"                    , "Forced\nWithdrawal\ndue to\nNAAR Limit"}
     ,{"NetClaims_Current"               , "Curr Net\nClaims"}
     ,{"NetClaims_Guaranteed"            , "Guar Net\nClaims"}
+    ,{"NetDeathBenefit"                 , "Net\nDeath\nBenefit"}
     ,{"NetIntCredited_Current"          , "Curr Net\nInt\nCredited"}
     ,{"NetIntCredited_Guaranteed"       , "Guar Net\nInt\nCredited"}
     ,{"NetPmt_Current"                  , "Curr Net\nPayment"}
@@ -237,6 +242,7 @@ title_map_t static_titles()
     ,{"PrefLoanBalance_Guaranteed"      , "Guar\nPreferred\nLoan Bal"}
     ,{"PremTaxLoad_Current"             , "Curr\nPremium\nTax Load"}
     ,{"PremTaxLoad_Guaranteed"          , "Guar\nPremium\nTax Load"}
+    ,{"PremiumLoad"                     , "Premium\nLoad"}
     ,{"RefundableSalesLoad"             , "Refundable\nSales\nLoad"}
     ,{"RiderCharges_Current"            , "Curr Rider\nCharges"}
     ,{"Salary"                          , "Salary"}
@@ -245,6 +251,9 @@ title_map_t static_titles()
     ,{"SpecAmt"                         , "Specified\nAmount"}
     ,{"SpecAmtLoad_Current"             , "Curr Spec\nAmt Load"}
     ,{"SpecAmtLoad_Guaranteed"          , "Guar Spec\nAmt Load"}
+    ,{"SupplDeathBft_Current"           , "Curr Suppl\nDeath\nBenefit"}
+    ,{"SupplDeathBft_Guaranteed"        , "Guar Suppl\nDeath\nBenefit"}
+    ,{"SupplSpecAmt"                    , "Suppl\nSpecified\nAmount"}
     ,{"SurrChg_Current"                 , "Curr Surr\nCharge"}
     ,{"SurrChg_Guaranteed"              , "Guar Surr\nCharge"}
     ,{"TermPurchased_Current"           , "Curr Term\nAmt\nPurchased"}
@@ -268,7 +277,7 @@ title_map_t static_titles()
     return title_map;
 }
 
-mask_map_t static_masks()
+mask_map_t const& static_masks()
 {
     static mask_map_t const mask_map =
     {{"AVGenAcct_CurrentZero"           , "999,999,999"}
@@ -343,10 +352,12 @@ mask_map_t static_masks()
     ,{"IrrDb_Guaranteed"                ,  "100000.00%"}
     ,{"LoanIntAccrued_Current"          , "999,999,999"}
     ,{"LoanIntAccrued_Guaranteed"       , "999,999,999"}
+    ,{"MiscCharges"                     , "999,999,999"}
     ,{"ModalMinimumPremium"             , "999,999,999"}
 //  ,{"NaarForceout"                    , "999,999,999"}
     ,{"NetClaims_Current"               , "999,999,999"}
     ,{"NetClaims_Guaranteed"            , "999,999,999"}
+    ,{"NetDeathBenefit"                 , "999,999,999"}
     ,{"NetIntCredited_Current"          , "999,999,999"}
     ,{"NetIntCredited_Guaranteed"       , "999,999,999"}
     ,{"NetPmt_Current"                  , "999,999,999"}
@@ -362,6 +373,7 @@ mask_map_t static_masks()
     ,{"PrefLoanBalance_Guaranteed"      , "999,999,999"}
     ,{"PremTaxLoad_Current"             , "999,999,999"}
     ,{"PremTaxLoad_Guaranteed"          , "999,999,999"}
+    ,{"PremiumLoad"                     , "999,999,999"}
     ,{"RefundableSalesLoad"             , "999,999,999"}
     ,{"RiderCharges_Current"            , "999,999,999"}
     ,{"Salary"                          , "999,999,999"}
@@ -370,6 +382,9 @@ mask_map_t static_masks()
     ,{"SpecAmt"                         , "999,999,999"}
     ,{"SpecAmtLoad_Current"             , "999,999,999"}
     ,{"SpecAmtLoad_Guaranteed"          , "999,999,999"}
+    ,{"SupplDeathBft_Current"           , "999,999,999"}
+    ,{"SupplDeathBft_Guaranteed"        , "999,999,999"}
+    ,{"SupplSpecAmt"                    , "999,999,999"}
     ,{"SurrChg_Current"                 , "999,999,999"}
     ,{"SurrChg_Guaranteed"              , "999,999,999"}
     ,{"TermPurchased_Current"           , "999,999,999"}
@@ -383,7 +398,7 @@ mask_map_t static_masks()
     return mask_map;
 }
 
-format_map_t static_formats()
+format_map_t const& static_formats()
 {
 // Formats
 //
@@ -544,6 +559,7 @@ format_map_t static_formats()
     ,{"MaleProportion"                  , f3}
     ,{"NonsmokerProportion"             , f3}
     ,{"PartMortTableMult"               , f3}
+    ,{"SepAcctAllocation"               , f3}
 // F4: scaled by 100, two decimals, with '%' at end:
 // > Format as percentage with two decimal places (##0.00%)
     ,{"AnnGAIntRate"                    , f4}
@@ -591,9 +607,11 @@ format_map_t static_formats()
     ,{"GrossIntCredited"                , f5}
     ,{"GrossPmt"                        , f5}
     ,{"LoanIntAccrued"                  , f5}
+    ,{"MiscCharges"                     , f5}
     ,{"ModalMinimumPremium"             , f5}
     ,{"NaarForceout"                    , f5}
     ,{"NetClaims"                       , f5}
+    ,{"NetDeathBenefit"                 , f5}
     ,{"NetIntCredited"                  , f5}
     ,{"NetPmt"                          , f5}
     ,{"NetWD"                           , f5}
@@ -602,11 +620,15 @@ format_map_t static_formats()
     ,{"PolicyFee"                       , f5}
     ,{"PrefLoanBalance"                 , f5} // Not used yet.
     ,{"PremTaxLoad"                     , f5}
+    ,{"PremiumLoad"                     , f5}
     ,{"RiderCharges"                    , f5}
     ,{"Salary"                          , f5}
     ,{"SepAcctCharges"                  , f5}
     ,{"SpecAmt"                         , f5}
     ,{"SpecAmtLoad"                     , f5}
+    ,{"SupplDeathBft_Current"           , f5}
+    ,{"SupplDeathBft_Guaranteed"        , f5}
+    ,{"SupplSpecAmt"                    , f5}
     ,{"SurrChg"                         , f5}
     ,{"TermPurchased"                   , f5}
     ,{"TermSpecAmt"                     , f5}
@@ -620,6 +642,105 @@ format_map_t static_formats()
 }
 } // Unnamed namespace.
 
+/// Implementation of class ledger_evaluator.
+///
+/// Numbers are held as pointers, either to data in the ledger's
+/// shared components, which are kept alive here, or to derived values
+/// owned here. Elements of an unordered_map never move, so pointers
+/// to owned values remain valid as long as this object exists. Each
+/// number is formatted when it is first requested, and the resulting
+/// string is memoized.
+
+class ledger_evaluator_impl
+{
+    friend class Ledger;
+    friend class ledger_evaluator;
+
+    template<typename T> using umap = std::unordered_map<std::string,T>;
+    using format_t = std::pair<int,oenum_format_style>;
+
+    struct scalar_source
+    {
+        double const* data;
+        format_t      format;
+    };
+
+    struct vector_source
+    {
+        std::vector<double> const* data;
+        format_t                   format;
+    };
+
+    std::string              const& scalar_string(std::string const&) const;
+    std::vector<std::string> const& vector_string(std::string const&) const;
+
+    std::shared_ptr<ledger_map_holder const> ledger_map_;
+    std::shared_ptr<LedgerInvariant   const> ledger_invariant_;
+
+    umap<double>              owned_scalars_;
+    umap<std::vector<double>> owned_vectors_;
+
+    umap<scalar_source>       scalar_sources_;
+    umap<vector_source>       vector_sources_;
+
+    mutable std::mutex                     mutex_;
+    mutable umap<std::string>              scalars_;
+    mutable umap<std::vector<std::string>> vectors_;
+};
+
+/// Formatted scalar, memoized.
+///
+/// Precondition: 'mutex_' is locked.
+
+std::string const& ledger_evaluator_impl::scalar_string
+    (std::string const& name
+    ) const
+{
+    auto i = scalars_.find(name);
+    if(scalars_.end() == i)
+        {
+        auto const j = scalar_sources_.find(name);
+        if(scalar_sources_.end() == j)
+            {
+            alarum() << "Key '" << name << "' not found." << LMI_FLUSH;
+            }
+        // Census runs may omit the guaranteed premium.
+        LMI_ASSERT
+            (  "GuarPrem" != name
+            || !ledger_invariant_->is_guar_prem_omitted()
+            );
+        i = scalars_.emplace
+            (name
+            ,ledger_format(*j->second.data, j->second.format)
+            ).first;
+        }
+    return i->second;
+}
+
+/// Formatted vector, memoized.
+///
+/// Precondition: 'mutex_' is locked.
+
+std::vector<std::string> const& ledger_evaluator_impl::vector_string
+    (std::string const& name
+    ) const
+{
+    auto i = vectors_.find(name);
+    if(vectors_.end() == i)
+        {
+        auto const j = vector_sources_.find(name);
+        if(vector_sources_.end() == j)
+            {
+            alarum() << "Key '" << name << "' not found." << LMI_FLUSH;
+            }
+        i = vectors_.emplace
+            (name
+            ,ledger_format(*j->second.data, j->second.format)
+            ).first;
+        }
+    return i->second;
+}
+
 ledger_evaluator Ledger::make_evaluator() const
 {
     throw_if_interdicted(*this);
@@ -628,18 +749,15 @@ ledger_evaluator Ledger::make_evaluator() const
     LedgerVariant   const& curr  = GetCurrFull();
     LedgerVariant   const& guar  = GetGuarFull();
 
-    title_map_t title_map {static_titles()};
-
-    mask_map_t mask_map {static_masks()};
+    title_map_t  const& title_map  {static_titles()};
+    mask_map_t   const& mask_map   {static_masks()};
+    format_map_t const& format_map {static_formats()};
 
-//  std::pair<int,oenum_format_style> f1(0, oe_format_normal);     // not used
-//  std::pair<int,oenum_format_style> f2(2, oe_format_normal);     // not used
-    std::pair<int,oenum_format_style> f3(0, oe_format_percentage);
-//  std::pair<int,oenum_format_style> f4(2, oe_format_percentage); // not used
-    std::pair<int,oenum_format_style> f5(0, oe_cents_as_dollars);
-//  std::pair<int,oenum_format_style> f6(2, oe_cents_as_dollars);  // not used
-
-    format_map_t format_map {static_formats()};
+    auto impl = std::make_shared<ledger_evaluator_impl>();
+    impl->ledger_map_       = ledger_map_;
+    impl->ledger_invariant_ = ledger_invariant_;
+    auto& owned_scalars = impl->owned_scalars_;
+    auto& owned_vectors = impl->owned_vectors_;
 
     // This is a little tricky. We have some stuff that
     // isn't in the maps inside the ledger classes. We're going to
@@ -656,7 +774,8 @@ ledger_evaluator Ledger::make_evaluator() const
 
     // Now we add the stuff that wasn't in the invariant
     // ledger's class's maps (indexable by name). Because we're
-    // working with maps of pointers, we need pointers here.
+    // working with maps of pointers, we need pointers here; values
+    // derived here are owned by the evaluator, which outlives them.
 
     ledger_invariant_->CalculateIrrs(*this);
 
@@ -669,15 +788,19 @@ ledger_evaluator Ledger::make_evaluator() const
     vectors["IrrCsv_Current"        ] = &ledger_invariant_->IrrCsvCurrInput;
     vectors["IrrDb_Current"         ] = &ledger_invariant_->IrrDbCurrInput ;
 
-    double GreatestLapseDuration = greatest_lapse_dur();
+    double& GreatestLapseDuration = owned_scalars["GreatestLapseDuration"];
+    GreatestLapseDuration = greatest_lapse_dur();
     scalars["GreatestLapseDuration"] = &GreatestLapseDuration;
 
     int max_duration = bourn_cast<int>(invar.EndtAge - invar.Age);
     int issue_age = bourn_cast<int>(invar.Age);
 
-    std::vector<double> AttainedAge(max_duration);
-    std::vector<double> Duration   (max_duration);
-    std::vector<double> PolicyYear (max_duration);
+    std::vector<double>& AttainedAge = owned_vectors["AttainedAge"];
+    std::vector<double>& Duration    = owned_vectors["Duration"   ];
+    std::vector<double>& PolicyYear  = owned_vectors["PolicyYear" ];
+    AttainedAge.resize(max_duration);
+    Duration   .resize(max_duration);
+    PolicyYear .resize(max_duration);
     std::iota(AttainedAge.begin(), AttainedAge.end(), 1 + issue_age);
     std::iota(Duration   .begin(), Duration   .end(), 0);
     std::iota(PolicyYear .begin(), PolicyYear .end(), 1);
@@ -700,10 +823,14 @@ ledger_evaluator Ledger::make_evaluator() const
     // TODO ?? A really good design would give users the power to
     // define and store their own derived-column definitions. For now,
     // however, code changes are required, and this is as appropriate
-    // a place as any to make them.
-
-    std::vector<double> PremiumLoad(max_duration);
-    std::vector<double> MiscCharges(max_duration);
+    // a place as any to make them. Their titles, masks, and formats
+    // are given in static_titles(), static_masks(), and
+    // static_formats().
+
+    std::vector<double>& PremiumLoad = owned_vectors["PremiumLoad"];
+    std::vector<double>& MiscCharges = owned_vectors["MiscCharges"];
+    PremiumLoad.resize(max_duration);
+    MiscCharges.resize(max_duration);
     for(int j = 0; j < max_duration; ++j)
         {
         PremiumLoad[j] = invar.GrossPmt[j] - curr.NetPmt[j];
@@ -711,45 +838,32 @@ ledger_evaluator Ledger::make_evaluator() const
         }
 
     vectors   ["PremiumLoad"] = &PremiumLoad;
-    title_map ["PremiumLoad"] = "Premium\nLoad";
-    mask_map  ["PremiumLoad"] = "999,999,999";
-    format_map["PremiumLoad"] = f5;
-
     vectors   ["MiscCharges"] = &MiscCharges;
-    title_map ["MiscCharges"] = "Miscellaneous\nCharges";
-    mask_map  ["MiscCharges"] = "999,999,999";
-    format_map["MiscCharges"] = f5;
 
-    std::vector<double> NetDeathBenefit(curr.EOYDeathBft);
+    std::vector<double>& NetDeathBenefit = owned_vectors["NetDeathBenefit"];
+    NetDeathBenefit = curr.EOYDeathBft;
     NetDeathBenefit -= curr.TotalLoanBalance;
     vectors   ["NetDeathBenefit"] = &NetDeathBenefit;
-    title_map ["NetDeathBenefit"] = "Net\nDeath\nBenefit";
-    mask_map  ["NetDeathBenefit"] = "999,999,999";
-    format_map["NetDeathBenefit"] = f5;
 
-    std::vector<double> SupplDeathBft_Current   (curr.TermPurchased);
-    std::vector<double> SupplDeathBft_Guaranteed(guar.TermPurchased);
+    std::vector<double>& SupplDeathBft_Current    = owned_vectors["SupplDeathBft_Current"   ];
+    std::vector<double>& SupplDeathBft_Guaranteed = owned_vectors["SupplDeathBft_Guaranteed"];
+    SupplDeathBft_Current    = curr.TermPurchased;
+    SupplDeathBft_Guaranteed = guar.TermPurchased;
     vectors   ["SupplDeathBft_Current"   ] = &SupplDeathBft_Current;
     vectors   ["SupplDeathBft_Guaranteed"] = &SupplDeathBft_Guaranteed;
-    title_map ["SupplDeathBft_Current"   ] = "Curr Suppl\nDeath\nBenefit";
-    title_map ["SupplDeathBft_Guaranteed"] = "Guar Suppl\nDeath\nBenefit";
-    mask_map  ["SupplDeathBft_Current"   ] = "999,999,999";
-    mask_map  ["SupplDeathBft_Guaranteed"] = "999,999,999";
-    format_map["SupplDeathBft_Current"   ] = f5;
-    format_map["SupplDeathBft_Guaranteed"] = f5;
-
-    std::vector<double> SupplSpecAmt(invar.TermSpecAmt);
+
+    std::vector<double>& SupplSpecAmt = owned_vectors["SupplSpecAmt"];
+    SupplSpecAmt = invar.TermSpecAmt;
     vectors   ["SupplSpecAmt"            ] = &SupplSpecAmt;
-    title_map ["SupplSpecAmt"            ] = "Suppl\nSpecified\nAmount";
-    mask_map  ["SupplSpecAmt"            ] = "999,999,999";
-    format_map["SupplSpecAmt"            ] = f5;
 
     // [End of derived columns.]
 
-    double Composite = is_composite();
+    double& Composite = owned_scalars["Composite"];
+    Composite = is_composite();
     scalars["Composite"] = &Composite;
 
-    double NoLapse =
+    double& NoLapse = owned_scalars["NoLapse"];
+    NoLapse =
             0 != invar.NoLapseMinDur
         ||  0 != invar.NoLapseMinAge
         ;
@@ -797,10 +911,12 @@ ledger_evaluator Ledger::make_evaluator() const
 
     // PDF !! Sales-load refunds are mentioned on 'mce_ill_reg' PDFs
     // only. Other formats defectively ignore them.
-    double SalesLoadRefundAvailable =
-        !each_equal(invar.RefundableSalesLoad, 0.0);
-    double SalesLoadRefundRate0 = invar.RefundableSalesLoad[0];
-    double SalesLoadRefundRate1 = invar.RefundableSalesLoad[1];
+    double& SalesLoadRefundAvailable = owned_scalars["SalesLoadRefundAvailable"];
+    double& SalesLoadRefundRate0     = owned_scalars["SalesLoadRefundRate0"    ];
+    double& SalesLoadRefundRate1     = owned_scalars["SalesLoadRefundRate1"    ];
+    SalesLoadRefundAvailable = !each_equal(invar.RefundableSalesLoad, 0.0);
+    SalesLoadRefundRate0     = invar.RefundableSalesLoad[0];
+    SalesLoadRefundRate1     = invar.RefundableSalesLoad[1];
     // At present, only the first two durations are used; that's
     // correct only if all others are zero.
     LMI_ASSERT
@@ -816,27 +932,32 @@ ledger_evaluator Ledger::make_evaluator() const
     scalars["SalesLoadRefundRate0"    ] = &SalesLoadRefundRate0;
     scalars["SalesLoadRefundRate1"    ] = &SalesLoadRefundRate1;
 
-    double SepAcctAllocation = 1.0 - invar.GenAcctAllocation;
+    double& SepAcctAllocation = owned_scalars["SepAcctAllocation"];
+    SepAcctAllocation = 1.0 - invar.GenAcctAllocation;
     scalars   ["SepAcctAllocation"] = &SepAcctAllocation;
-    format_map["SepAcctAllocation"] = f3;
 
     std::string ScaleUnit = invar.scale_unit();
     strings["ScaleUnit"] = &ScaleUnit;
 
-    double InitTotalSA =
+    double& InitTotalSA = owned_scalars["InitTotalSA"];
+    InitTotalSA =
             invar.InitBaseSpecAmt
         +   invar.InitTermSpecAmt
         ;
     scalars["InitTotalSA"] = &InitTotalSA;
 
-    // Maps to hold the results of formatting numeric data.
+    // Maps to hold the results of formatting numeric data, which is
+    // done only on demand; strings need no formatting, so they are
+    // stored here directly.
 
-    std::unordered_map<std::string,std::string> stringscalars;
-    std::unordered_map<std::string,std::vector<std::string>> stringvectors;
+    auto& stringscalars = impl->scalars_;
+    auto& stringvectors = impl->vectors_;
+    auto& scalar_sources = impl->scalar_sources_;
+    auto& vector_sources = impl->vector_sources_;
 
     stringvectors["FundNames"] = invar.FundNames;
 
-    // Map the data, formatting it as necessary.
+    // Map the data, noting how to format it as necessary.
 
     // First we'll get the invariant stuff--the copy we made,
     // along with all the stuff we plugged into it above.
@@ -845,7 +966,7 @@ ledger_evaluator Ledger::make_evaluator() const
     for(auto const& j : scalars)
         {
         if(format_exists(j.first, suffix, format_map))
-            stringscalars[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+            scalar_sources[j.first + suffix] = {j.second, map_lookup(format_map, j.first)};
         }
     for(auto const& j : strings)
         {
@@ -854,14 +975,10 @@ ledger_evaluator Ledger::make_evaluator() const
     for(auto const& j : vectors)
         {
         if(format_exists(j.first, suffix, format_map))
-            stringvectors[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+            vector_sources[j.first + suffix] = {j.second, map_lookup(format_map, j.first)};
         }
     }
 
-//    stringscalars["GuarMaxMandE"] = ledger_format(*scalars["GuarMaxMandE"], 2, true);
-//    stringvectors["CorridorFactor"] = ledger_format(*vectors["CorridorFactor"], 0, true);
-//    stringscalars["InitAnnGenAcctInt_Current"] = ledger_format(*scalars["InitAnnGenAcctInt_Current"], 0, true);
-
     // That was the tricky part. Now it's all downhill.
 
     for(auto const& i : ledger_map_->held())
@@ -869,19 +986,13 @@ ledger_evaluator Ledger::make_evaluator() const
         std::string suffix = suffixes[i.first];
         for(auto const& j : i.second.AllScalars)
             {
-//            scalars[j.first + suffix] = j.second;
             if(format_exists(j.first, suffix, format_map))
-                stringscalars[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
-            }
-        for(auto const& j : i.second.Strings)
-            {
-            strings[j.first + suffix] = j.second;
+                scalar_sources[j.first + suffix] = {j.second, map_lookup(format_map, j.first)};
             }
         for(auto const& j : i.second.AllVectors)
             {
-//            vectors[j.first + suffix] = j.second;
             if(format_exists(j.first, suffix, format_map))
-                stringvectors[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+                vector_sources[j.first + suffix] = {j.second, map_lookup(format_map, j.first)};
             }
         }
 
@@ -943,8 +1054,10 @@ ledger_evaluator Ledger::make_evaluator() const
 
         for(auto const& j : SupplementalReportColumns)
             {
-            SupplementalReportColumnsTitles.push_back(title_map[j]);
-            SupplementalReportColumnsMasks .push_back(mask_map [j]);
+            auto const t = title_map.find(j);
+            auto const m = mask_map .find(j);
+            SupplementalReportColumnsTitles.push_back(title_map.end() == t ? "" : t->second);
+            SupplementalReportColumnsMasks .push_back(mask_map .end() == m ? "" : m->second);
             }
 
         stringvectors["SupplementalReportColumnsNames"] = std::move(SupplementalReportColumns);
@@ -952,14 +1065,13 @@ ledger_evaluator Ledger::make_evaluator() const
         stringvectors["SupplementalReportColumnsMasks" ] = std::move(SupplementalReportColumnsMasks );
         }
 
-    return ledger_evaluator(std::move(stringscalars), std::move(stringvectors));
+    return ledger_evaluator(std::move(impl));
 }
 
 std::string ledger_evaluator::value(std::string const& scalar_name) const
 {
-    if(!contains(scalars_, scalar_name))
-        alarum() << "Key '" << scalar_name << "' not found." << LMI_FLUSH;
-    return map_lookup(scalars_, scalar_name);
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->scalar_string(scalar_name);
 }
 
 std::string ledger_evaluator::value
@@ -967,17 +1079,30 @@ std::string ledger_evaluator::value
     ,int                index
     ) const
 {
-    if(!contains(vectors_, vector_name))
-        alarum() << "Key '" << vector_name << "' not found." << LMI_FLUSH;
-    return map_lookup(vectors_, vector_name).at(index);
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->vector_string(vector_name).at(index);
+}
+
+/// Formatted vector.
+///
+/// The reference remains valid as long as this object (or any copy)
+/// exists, because memoized results are never erased.
+
+std::vector<std::string> const& ledger_evaluator::values
+    (std::string const& vector_name
+    ) const
+{
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->vector_string(vector_name);
 }
 
 /// Write values to a TSV file as a side effect of writing a PDF.
 ///
-/// Copy 'vectors_' to a (sorted) std::map in order to show columns
-/// alphabetically; 'scalars_', likewise. Other, more complicated
-/// techniques are faster, but direct copying favors simplicity over
-/// speed--appropriately, as this facility is rarely used.
+/// Format every value, then copy the memoized vectors to a (sorted)
+/// std::map in order to show columns alphabetically; scalars,
+/// likewise. Other, more complicated techniques are faster, but
+/// direct copying favors simplicity over speed--appropriately, as
+/// this facility is rarely used.
 
 void ledger_evaluator::write_tsv(fs::path const& pdf_out_file) const
 {
@@ -989,7 +1114,20 @@ void ledger_evaluator::write_tsv(fs::path const& pdf_out_file) const
     fs::ofstream ofs(filepath, ios_out_trunc_binary());
 
     using v_map_t = std::map<std::string,std::vector<std::string>> const;
-    v_map_t sorted_vectors(vectors_.begin(), vectors_.end());
+    using s_map_t = std::map<std::string,std::string> const;
+
+    std::unique_lock<std::mutex> lock(impl_->mutex_);
+    for(auto const& j : impl_->vector_sources_)
+        {
+        impl_->vector_string(j.first);
+        }
+    for(auto const& j : impl_->scalar_sources_)
+        {
+        impl_->scalar_string(j.first);
+        }
+    v_map_t sorted_vectors(impl_->vectors_.begin(), impl_->vectors_.end());
+    s_map_t sorted_scalars(impl_->scalars_.begin(), impl_->scalars_.end());
+    lock.unlock();
 
     for(auto const& j : sorted_vectors)
         {
@@ -1017,9 +1155,6 @@ void ledger_evaluator::write_tsv(fs::path const& pdf_out_file) const
 
     ofs << '\n';
 
-    using s_map_t = std::map<std::string,std::string> const;
-    s_map_t sorted_scalars(scalars_.begin(), scalars_.end());
-
     for(auto const& j : sorted_scalars)
         {
         ofs << j.first << '\t' << j.second << '\n';
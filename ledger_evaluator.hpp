@@ -27,38 +27,44 @@
 #include "path.hpp"
 #include "so_attributes.hpp"
 
+#include <memory>                       // shared_ptr
 #include <string>
-#include <unordered_map>
-#include <utility>                      // move()
 #include <vector>
 
+class ledger_evaluator_impl;
+
 /// Class allowing to retrieve the string representation of any scalar or
 /// vector stored in a ledger.
+///
+/// Numbers are formatted lazily: each scalar or vector is formatted
+/// only when it is first requested, and the result is memoized, so
+/// that reports that use only a few columns don't pay for formatting
+/// all of them. Copies share the same memoized results.
+///
+/// Values are read from the ledger when they are first requested, so
+/// the ledger must not be modified while an evaluator made from it is
+/// in use. (Its data are kept alive, though, even if the ledger itself
+/// is destroyed.)
 
 class LMI_SO ledger_evaluator
 {
     friend class Ledger;
 
-    template<typename K, typename T> using umap = std::unordered_map<K,T>;
-    using scalar_map_t = umap<std::string,            std::string >;
-    using vector_map_t = umap<std::string,std::vector<std::string>>;
-
   public:
     std::string value(std::string const& scalar_name) const;
     std::string value(std::string const& vector_name, int index) const;
+    std::vector<std::string> const& values(std::string const& vector_name) const;
 
     void write_tsv(fs::path const&) const;
 
   private:
     // Constructible only by friends: see Ledger::make_evaluator().
-    ledger_evaluator(scalar_map_t&& scalars, vector_map_t&& vectors)
-        :scalars_ {std::move(scalars)}
-        ,vectors_ {std::move(vectors)}
+    explicit ledger_evaluator(std::shared_ptr<ledger_evaluator_impl> impl)
+        :impl_ {impl}
     {
     }
 
-    scalar_map_t const scalars_;
-    vector_map_t const vectors_;
+    std::shared_ptr<ledger_evaluator_impl> impl_;
 };
 
 #endif // ledger_evaluator_hpp
@@ -0,0 +1,979 @@
+// Compact binary images of ledgers.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "ledger_image.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "mc_enum.hpp"
+#include "mc_enum_types_aux.hpp"        // mc_str()
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "path_utility.hpp"             // fs::path inserter
+
+#include <algorithm>                    // adjacent_find(), sort()
+#include <bit>                          // endian
+#include <cstring>                      // memcmp(), memcpy()
+
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // open()
+#   include <sys/mman.h>                // mmap(), munmap()
+#   include <sys/stat.h>                // fstat()
+#   include <unistd.h>                  // close()
+#endif // defined LMI_POSIX
+
+namespace
+{
+char const ledger_magic[8] = {'l', 'm', 'i', 'l', 'e', 'd', 'g', 'r'};
+
+/// Increment whenever the layout changes. Adding or removing ledger
+/// members requires no new version, because entry names are stored.
+
+std::uint32_t const ledger_version = 2;
+
+/// Run basis recorded for the invariant part.
+
+std::int32_t const invariant_basis = -1;
+
+/// What an entry holds, and where.
+
+enum : std::uint32_t
+    {e_doubles  = 0 // Vector of double, in doubles.
+    ,e_scalar   = 1 // One double, in doubles.
+    ,e_string   = 2 // Characters, in chars.
+    ,e_integers = 3 // Vector of signed integers, in words.
+    ,e_strings  = 4 // Vector of strings: {offset, size} pairs in words.
+    };
+
+/// Flags for the arguments of Ledger's ctor.
+
+std::uint32_t const f_nonillustrated = 1;
+std::uint32_t const f_no_can_issue   = 2;
+std::uint32_t const f_is_composite   = 4;
+
+/// Whether [offset, offset + size) lies within [0, limit).
+
+bool within(std::uint64_t offset, std::uint64_t size, std::uint64_t limit)
+{
+    return size <= limit && offset <= limit - size;
+}
+
+/// Copy an object of type T from a possibly misaligned address.
+
+template<typename T>
+T datum_at(char const* p)
+{
+    T z;
+    std::memcpy(&z, p, sizeof z);
+    return z;
+}
+
+/// Images are written and read without swapping bytes, so they are
+/// portable only among little-endian machines; refuse others.
+
+void require_native_byte_order()
+{
+    if(std::endian::native != std::endian::little)
+        {
+        alarum() << "Ledger images require little-endian hardware." << LMI_FLUSH;
+        }
+}
+} // Unnamed namespace.
+
+/// Fixed-size header at the beginning of a ledger image.
+///
+/// Sections follow in the order described in the class documentation,
+/// with no padding, so their offsets need not be stored.
+
+struct ledger_image::header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t ledger_type;
+    std::uint32_t flags;
+    std::uint32_t n_parts;
+    std::uint64_t n_entries;
+    std::uint64_t n_doubles;
+    std::uint64_t n_words;
+    std::uint64_t n_chars;
+    std::uint64_t file_size;
+};
+
+/// The invariant ledger, or the variant ledger for one basis.
+
+struct ledger_image::part
+{
+    std::int32_t  run_basis;
+    std::int32_t  length;
+    std::uint64_t first_entry;
+    std::uint64_t end_entry;
+};
+
+/// One named value. Its kind determines whether 'offset' and 'size'
+/// refer to doubles, words, or chars.
+
+struct ledger_image::entry
+{
+    std::uint32_t kind;
+    std::uint32_t name_size;
+    std::uint64_t name_offset;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+/// Accumulate the sections of an image.
+///
+/// Each operator() stores one member, chosen by its type.
+
+class ledger_image::writer
+{
+  public:
+    void begin_part(std::int32_t run_basis, int length)
+        {
+        std::uint64_t const n = entries_.size();
+        parts_.push_back({run_basis, bourn_cast<std::int32_t>(length), n, n});
+        }
+
+    void end_part()
+        {
+        auto const first = entries_.begin() + bourn_cast<std::ptrdiff_t>(parts_.back().first_entry);
+        auto const by_name = [this] (entry const& a, entry const& b)
+            {return name(a) < name(b);};
+        std::sort(first, entries_.end(), by_name);
+        auto const same_name = [this] (entry const& a, entry const& b)
+            {return name(a) == name(b);};
+        LMI_ASSERT(entries_.end() == std::adjacent_find(first, entries_.end(), same_name));
+        parts_.back().end_entry = entries_.size();
+        }
+
+    void operator()(std::string const& name, std::vector<double> const& z)
+        {
+        add(name, e_doubles, doubles_.size(), z.size());
+        doubles_.insert(doubles_.end(), z.begin(), z.end());
+        }
+
+    void operator()(std::string const& name, double z)
+        {
+        add(name, e_scalar, doubles_.size(), 1);
+        doubles_.push_back(z);
+        }
+
+    void operator()(std::string const& name, std::string const& z)
+        {
+        add(name, e_string, chars_.size(), z.size());
+        chars_ += z;
+        }
+
+    void operator()(std::string const& name, std::vector<std::string> const& z)
+        {
+        add(name, e_strings, words_.size(), z.size());
+        for(auto const& i : z)
+            {
+            words_.push_back(chars_.size());
+            words_.push_back(i.size());
+            chars_ += i;
+            }
+        }
+
+    void operator()(std::string const& name, std::vector<int> const& z)
+        {
+        std::vector<std::int64_t> const v(z.begin(), z.end());
+        integers(name, v);
+        }
+
+    template<typename T>
+    void operator()(std::string const& name, std::vector<mc_enum<T>> const& z)
+        {
+        std::vector<std::int64_t> v;
+        v.reserve(z.size());
+        for(auto const& i : z)
+            {
+            v.push_back(i.value());
+            }
+        integers(name, v);
+        }
+
+    void operator()(std::string const& name, int              z) {integers(name, {z});}
+    void operator()(std::string const& name, bool             z) {integers(name, {z});}
+    void operator()(std::string const& name, mcenum_gen_basis z) {integers(name, {z});}
+    void operator()(std::string const& name, mcenum_sep_basis z) {integers(name, {z});}
+
+    std::string image(std::uint32_t ledger_type, std::uint32_t flags) const
+        {
+        header h {};
+        std::memcpy(h.magic, ledger_magic, sizeof ledger_magic);
+        h.version     = ledger_version;
+        h.ledger_type = ledger_type;
+        h.flags       = flags;
+        h.n_parts     = bourn_cast<std::uint32_t>(parts_.size());
+        h.n_entries   = entries_.size();
+        h.n_doubles   = doubles_.size();
+        h.n_words     = words_.size();
+        h.n_chars     = chars_.size();
+        h.file_size   =
+              sizeof h
+            + parts_  .size() * sizeof(part)
+            + entries_.size() * sizeof(entry)
+            + doubles_.size() * sizeof(double)
+            + words_  .size() * sizeof(std::uint64_t)
+            + chars_  .size()
+            ;
+
+        std::string z;
+        z.reserve(bourn_cast<std::size_t>(h.file_size));
+        auto const put = [&z] (void const* p, std::size_t n)
+            {
+            z.append(static_cast<char const*>(p), n);
+            };
+        put(&h             , sizeof h);
+        put(parts_  .data(), parts_  .size() * sizeof(part));
+        put(entries_.data(), entries_.size() * sizeof(entry));
+        put(doubles_.data(), doubles_.size() * sizeof(double));
+        put(words_  .data(), words_  .size() * sizeof(std::uint64_t));
+        put(chars_  .data(), chars_  .size());
+        return z;
+        }
+
+  private:
+    void add
+        (std::string const& name
+        ,std::uint32_t      kind
+        ,std::uint64_t      offset
+        ,std::uint64_t      size
+        )
+        {
+        entries_.push_back
+            ({kind
+            ,bourn_cast<std::uint32_t>(name.size())
+            ,chars_.size()
+            ,offset
+            ,size
+            });
+        chars_ += name;
+        // A string's characters follow its name.
+        if(e_string == kind)
+            {
+            entries_.back().offset = chars_.size();
+            }
+        }
+
+    void integers(std::string const& name, std::vector<std::int64_t> const& z)
+        {
+        add(name, e_integers, words_.size(), z.size());
+        for(auto i : z)
+            {
+            words_.push_back(static_cast<std::uint64_t>(i));
+            }
+        }
+
+    std::string_view name(entry const& e) const
+        {
+        return std::string_view(chars_).substr(e.name_offset, e.name_size);
+        }
+
+    std::vector<part>          parts_;
+    std::vector<entry>         entries_;
+    std::vector<double>        doubles_;
+    std::vector<std::uint64_t> words_;
+    std::string                chars_;
+};
+
+/// Restore members from one part of an image.
+///
+/// Each operator() restores one member, chosen by its type. Entries
+/// are counted, so that entries no member claims can be detected.
+
+class ledger_image::loader
+{
+  public:
+    loader(ledger_image const& image, part const& p)
+        :image_ {image}
+        ,part_  {p}
+        {
+        }
+
+    void operator()(std::string const& name, std::vector<double>& z)
+        {
+        std::span<double const> const s = image_.doubles(get(name, e_doubles));
+        z.assign(s.begin(), s.end());
+        }
+
+    void operator()(std::string const& name, double& z)
+        {
+        z = image_.doubles(get(name, e_scalar))[0];
+        }
+
+    void operator()(std::string const& name, std::string& z)
+        {
+        entry const e = get(name, e_string);
+        z = image_.chars(e.offset, e.size);
+        }
+
+    void operator()(std::string const& name, std::vector<std::string>& z)
+        {
+        entry const e = get(name, e_strings);
+        z.clear();
+        z.reserve(bourn_cast<std::size_t>(e.size));
+        for(std::uint64_t j = 0; j < e.size; ++j)
+            {
+            std::uint64_t const offset = image_.word(e.offset + 2 * j);
+            std::uint64_t const size   = image_.word(e.offset + 2 * j + 1);
+            z.emplace_back(image_.chars(offset, size));
+            }
+        }
+
+    void operator()(std::string const& name, std::vector<int>& z)
+        {
+        entry const e = get(name, e_integers);
+        z.clear();
+        z.reserve(bourn_cast<std::size_t>(e.size));
+        for(std::uint64_t j = 0; j < e.size; ++j)
+            {
+            z.push_back(bourn_cast<int>(integer(e, j)));
+            }
+        }
+
+    template<typename T>
+    void operator()(std::string const& name, std::vector<mc_enum<T>>& z)
+        {
+        entry const e = get(name, e_integers);
+        z.clear();
+        z.reserve(bourn_cast<std::size_t>(e.size));
+        for(std::uint64_t j = 0; j < e.size; ++j)
+            {
+            z.emplace_back(static_cast<T>(integer(e, j)));
+            }
+        }
+
+    void operator()(std::string const& name, int& z)
+        {
+        z = bourn_cast<int>(integer(get_one(name), 0));
+        }
+
+    void operator()(std::string const& name, bool& z)
+        {
+        z = 0 != integer(get_one(name), 0);
+        }
+
+    void operator()(std::string const& name, mcenum_gen_basis& z)
+        {
+        z = static_cast<mcenum_gen_basis>(integer(get_one(name), 0));
+        }
+
+    void operator()(std::string const& name, mcenum_sep_basis& z)
+        {
+        z = static_cast<mcenum_sep_basis>(integer(get_one(name), 0));
+        }
+
+    /// Throw unless every entry of the part has been claimed.
+
+    void assert_complete() const
+        {
+        if(part_.end_entry - part_.first_entry != count_)
+            {
+            alarum()
+                << "Ledger image " << image_.filename_
+                << " has members that this version of lmi lacks."
+                << LMI_FLUSH
+                ;
+            }
+        }
+
+  private:
+    entry get(std::string const& name, std::uint32_t kind)
+        {
+        ++count_;
+        return image_.get_entry(part_, name, kind);
+        }
+
+    entry get_one(std::string const& name)
+        {
+        entry const e = get(name, e_integers);
+        if(1 != e.size)
+            {
+            alarum()
+                << "Ledger image " << image_.filename_
+                << ": '" << name << "' should hold one value."
+                << LMI_FLUSH
+                ;
+            }
+        return e;
+        }
+
+    std::int64_t integer(entry const& e, std::uint64_t j) const
+        {
+        return static_cast<std::int64_t>(image_.word(e.offset + j));
+        }
+
+    ledger_image const& image_;
+    part         const  part_;
+    std::uint64_t       count_ {0};
+};
+
+/// Apply a visitor to each member of class LedgerBase: the contents
+/// of its registries, and the scaling it records.
+
+template<typename B, typename V>
+void ledger_image::visit_base(B& b, V& v)
+{
+    for(auto const& i : b.AllVectors) {v(i.first, *i.second);}
+    for(auto const& i : b.AllScalars) {v(i.first, *i.second);}
+    for(auto const& i : b.Strings)    {v(i.first, *i.second);}
+    v("scale_power_", b.scale_power_);
+    v("scale_unit_" , b.scale_unit_ );
+}
+
+/// Apply a visitor to each member of class LedgerInvariant.
+///
+/// Members not held in the base class's registries are listed here.
+/// 'Length' is implied by the part record.
+
+template<typename I, typename V>
+void ledger_image::visit_invariant(I& z, V& v)
+{
+    visit_base(z, v);
+    v("DBOpt"              , z.DBOpt              );
+    v("EeMode"             , z.EeMode             );
+    v("ErMode"             , z.ErMode             );
+    v("InforceLives"       , z.InforceLives       );
+    v("FundNumbers"        , z.FundNumbers        );
+    v("FundNames"          , z.FundNames          );
+    v("FundAllocs"         , z.FundAllocs         );
+    v("FundAllocations"    , z.FundAllocations    );
+    v("IrrCsvGuar0"        , z.IrrCsvGuar0        );
+    v("IrrDbGuar0"         , z.IrrDbGuar0         );
+    v("IrrCsvCurr0"        , z.IrrCsvCurr0        );
+    v("IrrDbCurr0"         , z.IrrDbCurr0         );
+    v("IrrCsvGuarInput"    , z.IrrCsvGuarInput    );
+    v("IrrDbGuarInput"     , z.IrrDbGuarInput     );
+    v("IrrCsvCurrInput"    , z.IrrCsvCurrInput    );
+    v("IrrDbCurrInput"     , z.IrrDbCurrInput     );
+    v("EffDate"            , z.EffDate            );
+    v("DateOfBirth"        , z.DateOfBirth        );
+    v("LastCoiReentryDate" , z.LastCoiReentryDate );
+    v("ListBillDate"       , z.ListBillDate       );
+    v("InforceAsOfDate"    , z.InforceAsOfDate    );
+    v("irr_precision_"     , z.irr_precision_     );
+    v("irr_initialized_"   , z.irr_initialized_   );
+    v("guar_prem_omitted_" , z.guar_prem_omitted_ );
+    v("FullyInitialized"   , z.FullyInitialized   );
+}
+
+/// Apply a visitor to each member of class LedgerVariant.
+
+template<typename L, typename V>
+void ledger_image::visit_variant(L& z, V& v)
+{
+    visit_base(z, v);
+    v("GenBasis_"          , z.GenBasis_          );
+    v("SepBasis_"          , z.SepBasis_          );
+    v("FullyInitialized"   , z.FullyInitialized   );
+}
+
+/// Map a ledger image file, and validate its layout.
+
+ledger_image::ledger_image(fs::path const& filename)
+    :filename_ {filename.string()}
+{
+#if defined LMI_POSIX
+    int const fd = ::open(filename.string().c_str(), O_RDONLY);
+    struct stat st;
+    if(-1 == fd || 0 != ::fstat(fd, &st))
+        {
+        if(-1 != fd) {::close(fd);}
+        alarum() << "Unable to open ledger image " << filename << "." << LMI_FLUSH;
+        }
+    std::size_t const image_size = bourn_cast<std::size_t>(st.st_size);
+    void* const p =
+          sizeof(header) <= image_size
+        ? ::mmap(nullptr, image_size, PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED
+        ;
+    ::close(fd);
+    if(MAP_FAILED == p)
+        {
+        alarum() << "Unable to map ledger image " << filename << "." << LMI_FLUSH;
+        }
+    mapping_      = p;
+    mapping_size_ = image_size;
+    try
+        {
+        validate(p, image_size);
+        }
+    catch(...)
+        {
+        ::munmap(mapping_, mapping_size_);
+        throw;
+        }
+#else  // !defined LMI_POSIX
+    fs::ifstream ifs(filename, ios_in_binary() | std::ios_base::ate);
+    if(!ifs)
+        {
+        alarum() << "Unable to open ledger image " << filename << "." << LMI_FLUSH;
+        }
+    std::size_t const image_size =
+        bourn_cast<std::size_t>(static_cast<std::streamoff>(ifs.tellg()));
+    ifs.seekg(0);
+    buffer_.resize((image_size + sizeof(double) - 1) / sizeof(double));
+    ifs.read(reinterpret_cast<char*>(buffer_.data()), bourn_cast<std::streamsize>(image_size));
+    if(!ifs)
+        {
+        alarum() << "Unable to read ledger image " << filename << "." << LMI_FLUSH;
+        }
+    validate(buffer_.data(), image_size);
+#endif // !defined LMI_POSIX
+}
+
+/// Use an image held in memory, e.g. as received from another process.
+///
+/// The image is copied once, to align it; it is not decoded.
+
+ledger_image::ledger_image(char const* data, std::size_t size)
+    :filename_ {"(in memory)"}
+    ,buffer_   ((size + sizeof(double) - 1) / sizeof(double))
+{
+    if(0 != size)
+        {
+        std::memcpy(buffer_.data(), data, size);
+        }
+    validate(buffer_.data(), size);
+}
+
+ledger_image::~ledger_image()
+{
+#if defined LMI_POSIX
+    if(mapping_)
+        {
+        ::munmap(mapping_, mapping_size_);
+        }
+#endif // defined LMI_POSIX
+}
+
+/// Make an image of a ledger.
+
+std::string ledger_image::image(Ledger const& ledger)
+{
+    require_native_byte_order();
+    writer w;
+
+    LedgerInvariant const& invar = ledger.GetLedgerInvariant();
+    w.begin_part(invariant_basis, invar.GetLength());
+    visit_invariant(invar, w);
+    w.end_part();
+
+    for(auto const& i : ledger.GetLedgerMap().held())
+        {
+        w.begin_part(i.first, i.second.GetLength());
+        visit_variant(i.second, w);
+        w.end_part();
+        }
+
+    std::uint32_t const flags =
+          (ledger.nonillustrated() ? f_nonillustrated : 0U)
+        | (ledger.no_can_issue  () ? f_no_can_issue   : 0U)
+        | (ledger.is_composite  () ? f_is_composite   : 0U)
+        ;
+    return w.image(ledger.ledger_type(), flags);
+}
+
+/// Write an image of a ledger to a file.
+///
+/// The file is written under a temporary name and then renamed, so
+/// that a reader never sees a partial image.
+
+void ledger_image::write(Ledger const& ledger, fs::path const& filename)
+{
+    std::string const z = image(ledger);
+    fs::path const temporary(filename.string() + ".tmp");
+    {
+    fs::ofstream ofs(temporary, ios_out_trunc_binary());
+    ofs.write(z.data(), bourn_cast<std::streamsize>(z.size()));
+    if(!ofs)
+        {
+        alarum() << "Unable to write ledger image " << temporary << "." << LMI_FLUSH;
+        }
+    }
+    fs::rename(temporary, filename);
+}
+
+std::vector<mcenum_run_basis> ledger_image::run_bases() const
+{
+    std::vector<mcenum_run_basis> z;
+    for(std::uint32_t j = 1; j < n_parts_; ++j)
+        {
+        z.push_back(static_cast<mcenum_run_basis>(part_at(j).run_basis));
+        }
+    return z;
+}
+
+/// A vector or scalar of the invariant ledger, in place.
+
+std::span<double const> ledger_image::vector(std::string_view name) const
+{
+    return doubles(part_at(0), name);
+}
+
+/// A vector or scalar of one basis's variant ledger, in place.
+
+std::span<double const> ledger_image::vector
+    (mcenum_run_basis run_basis
+    ,std::string_view name
+    ) const
+{
+    return doubles(find_part(run_basis), name);
+}
+
+std::string_view ledger_image::string(std::string_view name) const
+{
+    entry const e = get_entry(part_at(0), name, e_string);
+    return chars(e.offset, e.size);
+}
+
+std::string_view ledger_image::string
+    (mcenum_run_basis run_basis
+    ,std::string_view name
+    ) const
+{
+    entry const e = get_entry(find_part(run_basis), name, e_string);
+    return chars(e.offset, e.size);
+}
+
+/// Reconstitute the ledger.
+
+Ledger ledger_image::ledger() const
+{
+    part const invariant_part = part_at(0);
+    Ledger z
+        (invariant_part.length
+        ,static_cast<mcenum_ledger_type>(ledger_type_)
+        ,0 != (flags_ & f_nonillustrated)
+        ,0 != (flags_ & f_no_can_issue  )
+        ,0 != (flags_ & f_is_composite  )
+        );
+    if(run_bases() != z.GetRunBases())
+        {
+        alarum()
+            << "Ledger image " << filename_
+            << " has bases inconsistent with its ledger type."
+            << LMI_FLUSH
+            ;
+        }
+
+    loader invariant_loader(*this, invariant_part);
+    visit_invariant(*z.ledger_invariant_, invariant_loader);
+    invariant_loader.assert_complete();
+
+    for(std::uint32_t j = 1; j < n_parts_; ++j)
+        {
+        part const p = part_at(j);
+        LedgerVariant v(p.length);
+        loader variant_loader(*this, p);
+        visit_variant(v, variant_loader);
+        variant_loader.assert_complete();
+        z.SetOneLedgerVariant(static_cast<mcenum_run_basis>(p.run_basis), v);
+        }
+    return z;
+}
+
+/// Validate an image's layout, and locate its sections.
+///
+/// Every count and offset is checked here, so that no later access
+/// can stray outside the image. Each count is checked against the
+/// space that remains before it is multiplied by the size of what
+/// it counts, so that no product can wrap around.
+///
+/// The image must be aligned for double: then the section of doubles
+/// is too, because every section before it has a size that is a
+/// multiple of eight bytes. Everything else is copied out of the
+/// image with memcpy() when it is used.
+
+void ledger_image::validate(void const* image, std::size_t size)
+{
+    // Sections are written without padding.
+    static_assert(64 == sizeof(header));
+    static_assert(24 == sizeof(part));
+    static_assert(32 == sizeof(entry));
+    static_assert(8 == sizeof(double) && 8 == sizeof(std::uint64_t));
+    require_native_byte_order();
+
+    char const* const bytes = static_cast<char const*>(image);
+    if(size < sizeof(header))
+        {
+        alarum() << "Ledger image " << filename_ << " is truncated." << LMI_FLUSH;
+        }
+    header const h = datum_at<header>(bytes);
+    if(0 != std::memcmp(h.magic, ledger_magic, sizeof ledger_magic))
+        {
+        alarum() << "File " << filename_ << " is not a ledger image." << LMI_FLUSH;
+        }
+    if(ledger_version != h.version)
+        {
+        alarum()
+            << "Ledger image " << filename_
+            << " has version " << h.version
+            << ", but version " << ledger_version
+            << " is required."
+            << LMI_FLUSH
+            ;
+        }
+
+    std::uint64_t remaining = size - sizeof(header);
+    auto const fits = [&remaining] (std::uint64_t count, std::uint64_t unit)
+        {
+        if(remaining / unit < count)
+            {
+            return false;
+            }
+        remaining -= count * unit;
+        return true;
+        };
+    bool okay =
+           0 != h.n_parts
+        && h.file_size == size
+        && fits(h.n_parts  , sizeof(part)         )
+        && fits(h.n_entries, sizeof(entry)        )
+        && fits(h.n_doubles, sizeof(double)       )
+        && fits(h.n_words  , sizeof(std::uint64_t))
+        && fits(h.n_chars  , 1                    )
+        && 0 == remaining
+        ;
+    if(!okay)
+        {
+        alarum() << "Ledger image " << filename_ << " is corrupt." << LMI_FLUSH;
+        }
+
+    std::uint64_t const parts_offset   = sizeof(header);
+    std::uint64_t const entries_offset = parts_offset   + h.n_parts   * sizeof(part);
+    std::uint64_t const doubles_offset = entries_offset + h.n_entries * sizeof(entry);
+    std::uint64_t const words_offset   = doubles_offset + h.n_doubles * sizeof(double);
+    std::uint64_t const chars_offset   = words_offset   + h.n_words   * sizeof(std::uint64_t);
+
+    ledger_type_ = h.ledger_type;
+    flags_       = h.flags;
+    n_parts_     = h.n_parts;
+    parts_       = bytes + parts_offset;
+    entries_     = bytes + entries_offset;
+    doubles_     = static_cast<double const*>(image) + doubles_offset / sizeof(double);
+    words_       = bytes + words_offset;
+    chars_       = bytes + chars_offset;
+
+    okay = invariant_basis == part_at(0).run_basis;
+    std::uint64_t next_entry = 0;
+    for(std::uint32_t j = 0; okay && j < n_parts_; ++j)
+        {
+        part const p = part_at(j);
+        okay =
+               0 < p.length
+            && next_entry == p.first_entry
+            && p.first_entry <= p.end_entry
+            && p.end_entry <= h.n_entries
+            && (0 == j || part_at(j - 1).run_basis < p.run_basis)
+            ;
+        next_entry = p.end_entry;
+        for(std::uint64_t k = p.first_entry; okay && k < p.end_entry; ++k)
+            {
+            entry const e = entry_at(k);
+            okay = within(e.name_offset, e.name_size, h.n_chars);
+            switch(e.kind)
+                {
+                case e_doubles:
+                    {
+                    okay = okay && within(e.offset, e.size, h.n_doubles);
+                    }
+                    break;
+                case e_scalar:
+                    {
+                    okay = okay && 1 == e.size && within(e.offset, 1, h.n_doubles);
+                    }
+                    break;
+                case e_integers:
+                    {
+                    okay = okay && within(e.offset, e.size, h.n_words);
+                    }
+                    break;
+                case e_string:
+                    {
+                    okay = okay && within(e.offset, e.size, h.n_chars);
+                    }
+                    break;
+                case e_strings:
+                    {
+                    okay =
+                           okay
+                        && e.size <= h.n_words / 2
+                        && within(e.offset, 2 * e.size, h.n_words)
+                        ;
+                    for(std::uint64_t i = 0; okay && i < e.size; ++i)
+                        {
+                        okay = within
+                            (word(e.offset + 2 * i)
+                            ,word(e.offset + 2 * i + 1)
+                            ,h.n_chars
+                            );
+                        }
+                    }
+                    break;
+                default:
+                    {
+                    okay = false;
+                    }
+                }
+            // Names must be sorted, for binary search.
+            okay =
+                   okay
+                && (   p.first_entry == k
+                    ||   entry_name(entry_at(k - 1)) < entry_name(e)
+                   )
+                ;
+            }
+        }
+    okay = okay && h.n_entries == next_entry;
+    if(!okay)
+        {
+        alarum() << "Ledger image " << filename_ << " is corrupt." << LMI_FLUSH;
+        }
+}
+
+ledger_image::part ledger_image::part_at(std::uint64_t j) const
+{
+    return datum_at<part>(parts_ + j * sizeof(part));
+}
+
+ledger_image::entry ledger_image::entry_at(std::uint64_t k) const
+{
+    return datum_at<entry>(entries_ + k * sizeof(entry));
+}
+
+std::uint64_t ledger_image::word(std::uint64_t i) const
+{
+    return datum_at<std::uint64_t>(words_ + i * sizeof(std::uint64_t));
+}
+
+ledger_image::part ledger_image::find_part(int run_basis) const
+{
+    for(std::uint32_t j = 0; j < n_parts_; ++j)
+        {
+        part const p = part_at(j);
+        if(run_basis == p.run_basis)
+            {
+            return p;
+            }
+        }
+    alarum()
+        << "Ledger image " << filename_
+        << " has no ledger for basis '"
+        << mc_str(static_cast<mcenum_run_basis>(run_basis))
+        << "'."
+        << LMI_FLUSH
+        ;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
+/// Find an entry by name, by binary search.
+
+std::optional<ledger_image::entry> ledger_image::find_entry
+    (part const&      p
+    ,std::string_view name
+    ) const
+{
+    std::uint64_t first = p.first_entry;
+    std::uint64_t count = p.end_entry - p.first_entry;
+    while(0 < count)
+        {
+        std::uint64_t const step = count / 2;
+        if(entry_name(entry_at(first + step)) < name)
+            {
+            first += step + 1;
+            count -= step + 1;
+            }
+        else
+            {
+            count = step;
+            }
+        }
+    if(p.end_entry != first)
+        {
+        entry const e = entry_at(first);
+        if(name == entry_name(e))
+            {
+            return e;
+            }
+        }
+    return std::nullopt;
+}
+
+/// Find an entry by name, and check its kind.
+
+ledger_image::entry ledger_image::get_entry
+    (part const&      p
+    ,std::string_view name
+    ,std::uint32_t    kind
+    ) const
+{
+    std::optional<entry> const e = find_entry(p, name);
+    if(!e)
+        {
+        alarum()
+            << "Ledger image " << filename_
+            << " lacks '" << name << "'."
+            << LMI_FLUSH
+            ;
+        }
+    if(kind != e->kind)
+        {
+        alarum()
+            << "Ledger image " << filename_
+            << ": '" << name << "' has the wrong type."
+            << LMI_FLUSH
+            ;
+        }
+    return *e;
+}
+
+std::span<double const> ledger_image::doubles
+    (part const&      p
+    ,std::string_view name
+    ) const
+{
+    std::optional<entry> const e = find_entry(p, name);
+    return doubles((e && e_scalar == e->kind) ? *e : get_entry(p, name, e_doubles));
+}
+
+std::span<double const> ledger_image::doubles(entry const& e) const
+{
+    return {doubles_ + e.offset, bourn_cast<std::size_t>(e.size)};
+}
+
+std::string_view ledger_image::chars(std::uint64_t offset, std::uint64_t size) const
+{
+    return {chars_ + offset, bourn_cast<std::size_t>(size)};
+}
+
+std::string_view ledger_image::entry_name(entry const& e) const
+{
+    return chars(e.name_offset, e.name_size);
+}
@@ -0,0 +1,140 @@
+// Compact binary images of ledgers.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef ledger_image_hpp
+#define ledger_image_hpp
+
+#include "config.hpp"
+
+#include "mc_enum_type_enums.hpp"       // mcenum_run_basis
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <cstddef>                      // size_t
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Ledger;
+class LedgerBase;
+class LedgerInvariant;
+class LedgerVariant;
+
+/// Compact binary image of a complete ledger.
+///
+/// Ledger::Spew() writes text for debugging, and CalculateCRC()
+/// reduces a ledger to a checksum; neither can be read back. An image
+/// holds everything a ledger holds--the invariant ledger, and the
+/// variant ledger for every basis--so that a ledger can be cached on
+/// disk, handed to another process, or compared with another ledger
+/// without going through text.
+///
+/// Each part is stored as a set of named entries, taken from the
+/// registries that class LedgerBase already maintains (AllVectors,
+/// AllScalars, Strings) together with the few members those maps
+/// don't hold. Names are stored, so reading an image made by a
+/// different version of lmi fails cleanly instead of misassigning.
+///
+/// File layout, in little-endian byte order; like rate packs, files
+/// are rejected at run time on other hardware:
+///   - a fixed-size header;
+///   - one record per part: the invariant ledger, then each variant
+///     ledger in run-basis order;
+///   - the entries of each part in turn, sorted by name;
+///   - the values of all floating-point entries, as doubles;
+///   - the values of all other numeric entries, as 64-bit words;
+///   - the characters of all names and strings.
+/// The doubles are aligned, so they can be used in place: for
+/// example, vector() returns a view of a column without copying or
+/// decoding it, and the image can be mapped rather than read. Records
+/// and words are copied out with memcpy() as they are needed. Only
+/// ledger() builds a Ledger object.
+
+class LMI_SO ledger_image final
+{
+    struct header;
+    struct part;
+    struct entry;
+    class  writer;
+    class  loader;
+
+  public:
+    explicit ledger_image(fs::path const& filename);
+    ledger_image(char const* data, std::size_t size);
+    ~ledger_image();
+
+    static std::string image(Ledger const&);
+    static void write(Ledger const&, fs::path const& filename);
+
+    std::vector<mcenum_run_basis> run_bases() const;
+
+    std::span<double const> vector(std::string_view name) const;
+    std::span<double const> vector(mcenum_run_basis, std::string_view name) const;
+    std::string_view        string(std::string_view name) const;
+    std::string_view        string(mcenum_run_basis, std::string_view name) const;
+
+    Ledger ledger() const;
+
+  private:
+    ledger_image(ledger_image const&) = delete;
+    ledger_image& operator=(ledger_image const&) = delete;
+
+    template<typename B, typename V> static void visit_base     (B&, V&);
+    template<typename I, typename V> static void visit_invariant(I&, V&);
+    template<typename L, typename V> static void visit_variant  (L&, V&);
+
+    void validate(void const* image, std::size_t size);
+
+    part          part_at (std::uint64_t) const;
+    entry         entry_at(std::uint64_t) const;
+    std::uint64_t word    (std::uint64_t) const;
+
+    part                 find_part (int run_basis) const;
+    std::optional<entry> find_entry(part const&, std::string_view name) const;
+    entry                get_entry (part const&, std::string_view name, std::uint32_t kind) const;
+
+    std::span<double const> doubles   (part const&, std::string_view name) const;
+    std::span<double const> doubles   (entry const&) const;
+    std::string_view        chars     (std::uint64_t offset, std::uint64_t size) const;
+    std::string_view        entry_name(entry const&) const;
+
+    std::string              filename_;
+    std::uint32_t            ledger_type_ {0};
+    std::uint32_t            flags_       {0};
+    std::uint32_t            n_parts_     {0};
+    char          const*     parts_       {nullptr};
+    char          const*     entries_     {nullptr};
+    double        const*     doubles_     {nullptr};
+    char          const*     words_       {nullptr};
+    char          const*     chars_       {nullptr};
+
+    // Mapped image, if memory mapping is available...
+    void*                    mapping_      {nullptr};
+    std::size_t              mapping_size_ {0};
+    // ...else the image as read into memory, aligned for double.
+    std::vector<double>      buffer_;
+};
+
+#endif // ledger_image_hpp
@@ -32,7 +32,9 @@
 #include "ledger.hpp"                   // for CalculateIrrs()
 #include "ledger_variant.hpp"           // for CalculateIrrs()
 #include "mc_enum_aux.hpp"              // mc_e_vector_to_string_vector()
+#include "mc_enum_types_aux.hpp"        // mc_str()
 #include "oecumenic_enumerations.hpp"
+#include "yare_input.hpp"
 
 #include <algorithm>                    // max(), min()
 #include <ostream>
@@ -40,8 +42,9 @@
 //============================================================================
 LedgerInvariant::LedgerInvariant(int len)
     :LedgerBase       (len)
-    ,irr_initialized_ {false}
-    ,FullyInitialized {false}
+    ,irr_initialized_   {false}
+    ,guar_prem_omitted_ {false}
+    ,FullyInitialized   {false}
 {
     Alloc(len);
 }
@@ -49,8 +52,9 @@ LedgerInvariant::LedgerInvariant(int len)
 //============================================================================
 LedgerInvariant::LedgerInvariant(LedgerInvariant const& obj)
     :LedgerBase       {obj}
-    ,irr_initialized_ {false}
-    ,FullyInitialized {false}
+    ,irr_initialized_   {false}
+    ,guar_prem_omitted_ {false}
+    ,FullyInitialized   {false}
 {
     Alloc(obj.GetLength());
     Copy(obj);
@@ -474,14 +478,16 @@ void LedgerInvariant::Copy(LedgerInvariant const& obj)
     // Private internals.
     irr_precision_         = obj.irr_precision_        ;
     irr_initialized_       = false; // IRR vectors are not copied.
+    guar_prem_omitted_     = obj.guar_prem_omitted_    ;
     FullyInitialized       = obj.FullyInitialized      ;
 }
 
 //============================================================================
 void LedgerInvariant::Destroy()
 {
-    irr_initialized_ = false;
-    FullyInitialized = false;
+    irr_initialized_   = false;
+    guar_prem_omitted_ = false;
+    FullyInitialized   = false;
 }
 
 //============================================================================
@@ -532,9 +538,61 @@ void LedgerInvariant::Init()
 
     irr_precision_             = 0;
     irr_initialized_           = false;
+    guar_prem_omitted_         = false;
     FullyInitialized           = false;
 }
 
+/// Set strings that are merely copied from input for display.
+///
+/// No calculation depends on these strings, so a ledger can be
+/// reused for an input that differs only in them; see
+/// Input::differs_only_in_presentation(). That function's list of
+/// such fields must be kept consistent with this one.
+
+void LedgerInvariant::SetPresentationText(yare_input const& y)
+{
+    ProducerName               = y.AgentName;
+
+    std::string const agent_city     = y.AgentCity;
+    std::string const agent_state    = mc_str(y.AgentState);
+    std::string const agent_zip_code = y.AgentZipCode;
+    // This is a two-letter USPS abbreviation, so it's never empty.
+    std::string agent_city_etc(agent_state);
+    if(!agent_city.empty())
+        {
+        agent_city_etc = agent_city + ", " + agent_state;
+        }
+    if(!agent_zip_code.empty())
+        {
+        agent_city_etc += " " + agent_zip_code;
+        }
+
+    ProducerStreet             = y.AgentAddress;
+    ProducerCityEtc            = agent_city_etc;
+    ProducerPhone              = y.AgentPhone;
+    ProducerId                 = y.AgentId;
+
+    CorpName                   = y.CorporationName;
+
+    MasterContractNumber       = y.MasterContractNumber;
+    ContractNumber             = y.ContractNumber;
+
+    Insured1                   = y.InsuredName;
+
+    SupplementalReportColumn00 = mc_str(y.SupplementalReportColumn00);
+    SupplementalReportColumn01 = mc_str(y.SupplementalReportColumn01);
+    SupplementalReportColumn02 = mc_str(y.SupplementalReportColumn02);
+    SupplementalReportColumn03 = mc_str(y.SupplementalReportColumn03);
+    SupplementalReportColumn04 = mc_str(y.SupplementalReportColumn04);
+    SupplementalReportColumn05 = mc_str(y.SupplementalReportColumn05);
+    SupplementalReportColumn06 = mc_str(y.SupplementalReportColumn06);
+    SupplementalReportColumn07 = mc_str(y.SupplementalReportColumn07);
+    SupplementalReportColumn08 = mc_str(y.SupplementalReportColumn08);
+    SupplementalReportColumn09 = mc_str(y.SupplementalReportColumn09);
+    SupplementalReportColumn10 = mc_str(y.SupplementalReportColumn10);
+    SupplementalReportColumn11 = mc_str(y.SupplementalReportColumn11);
+}
+
 // Notes on effective date.
 //
 // Should different cells in a census have different effective dates?
@@ -633,6 +691,10 @@ LedgerInvariant& LedgerInvariant::PlusEq(LedgerInvariant const& a_Addend)
 
     irr_precision_ = a_Addend.irr_precision_;
 
+    // A composite's guaranteed premium is the sum of its cells', so
+    // it's unknown if any cell's is.
+    guar_prem_omitted_ = guar_prem_omitted_ || a_Addend.guar_prem_omitted_;
+
     std::vector<double> const& N = a_Addend.InforceLives;
     int Max = std::min(Length, a_Addend.Length);
 
@@ -854,9 +916,23 @@ void LedgerInvariant::CalculateIrrs(Ledger const& LedgerValues)
     irr_initialized_ = true;
 }
 
+/// Record that 'GuarPrem' was deliberately not calculated.
+///
+/// Solving for the guaranteed premium can cost more than all other
+/// calculations for a cell together, so census runs omit it when no
+/// output they emit uses it. Any function that reads 'GuarPrem'
+/// should assert that it wasn't omitted.
+
+void LedgerInvariant::OmitGuarPrem()
+{
+    GuarPrem           = 0.0;
+    guar_prem_omitted_ = true;
+}
+
 //============================================================================
 void LedgerInvariant::UpdateCRC(CRC& a_crc) const
 {
+    LMI_ASSERT(!guar_prem_omitted_);
     LedgerBase::UpdateCRC(a_crc);
 
     a_crc += InforceLives;
@@ -872,6 +948,7 @@ void LedgerInvariant::UpdateCRC(CRC& a_crc) const
 //============================================================================
 void LedgerInvariant::Spew(std::ostream& os) const
 {
+    LMI_ASSERT(!guar_prem_omitted_);
     LedgerBase::Spew(os);
 
     SpewVector(os, std::string("InforceLives")    ,InforceLives    );
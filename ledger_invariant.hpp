@@ -39,10 +39,13 @@
 
 class BasicValues;
 class Ledger;
+class yare_input;
 
 class LMI_SO LedgerInvariant final
     :public LedgerBase
 {
+    friend class ledger_image;
+
   public:
     explicit LedgerInvariant(int len);
     LedgerInvariant(LedgerInvariant const&);
@@ -51,15 +54,18 @@ class LMI_SO LedgerInvariant final
 
     void Init(BasicValues const*);
     void ReInit(BasicValues const*);
+    void SetPresentationText(yare_input const&);
 
     LedgerInvariant& PlusEq(LedgerInvariant const& a_Addend);
 
     bool                       is_irr_initialized()    const;
+    bool                       is_guar_prem_omitted()  const;
     bool                       IsFullyInitialized()    const;
     int                        GetLength()             const override;
     std::vector<double> const& GetInforceLives()       const;
 
     void CalculateIrrs(Ledger const&);
+    void OmitGuarPrem();
 
     void UpdateCRC(CRC& a_crc) const override;
     void Spew(std::ostream& os) const override;
@@ -485,6 +491,7 @@ class LMI_SO LedgerInvariant final
     int  Length;
     int  irr_precision_;
     bool irr_initialized_ {false}; // CalculateIrrs() succeeded
+    bool guar_prem_omitted_ {false}; // OmitGuarPrem() called
     bool FullyInitialized {false}; // Init(BasicValues const*) succeeded
 };
 
@@ -493,6 +500,11 @@ inline bool LedgerInvariant::is_irr_initialized() const
     return irr_initialized_;
 }
 
+inline bool LedgerInvariant::is_guar_prem_omitted() const
+{
+    return guar_prem_omitted_;
+}
+
 inline bool LedgerInvariant::IsFullyInitialized() const
 {
     return FullyInitialized;
@@ -44,6 +44,7 @@
 #include "premium_tax.hpp"
 #include "product_data.hpp"
 #include "ssize_lmi.hpp"
+#include "yare_input.hpp"
 
 #include <algorithm>                    // max(), max_element()
 #include <stdexcept>
@@ -530,33 +531,8 @@ void LedgerInvariant::Init(BasicValues const* b)
 
     // Strings from class Input.
 
-    ProducerName               = b->yare_input_.AgentName;
+    SetPresentationText(b->yare_input_);
 
-    std::string const agent_city     = b->yare_input_.AgentCity;
-    std::string const agent_state    = mc_str(b->yare_input_.AgentState);
-    std::string const agent_zip_code = b->yare_input_.AgentZipCode;
-    // This is a two-letter USPS abbreviation, so it's never empty.
-    std::string agent_city_etc(agent_state);
-    if(!agent_city.empty())
-        {
-        agent_city_etc = agent_city + ", " + agent_state;
-        }
-    if(!agent_zip_code.empty())
-        {
-        agent_city_etc += " " + agent_zip_code;
-        }
-
-    ProducerStreet             = b->yare_input_.AgentAddress;
-    ProducerCityEtc            = agent_city_etc;
-    ProducerPhone              = b->yare_input_.AgentPhone;
-    ProducerId                 = b->yare_input_.AgentId;
-
-    CorpName                   = b->yare_input_.CorporationName;
-
-    MasterContractNumber       = b->yare_input_.MasterContractNumber;
-    ContractNumber             = b->yare_input_.ContractNumber;
-
-    Insured1                   = b->yare_input_.InsuredName;
     Gender                     = mc_str(b->yare_input_.Gender);
     UWType                     = mc_str(b->yare_input_.GroupUnderwritingType);
 
@@ -595,19 +571,6 @@ void LedgerInvariant::Init(BasicValues const* b)
     CountryIso3166Abbrev       = mc_str(b->yare_input_.Country);
     Comments                   = b->yare_input_.Comments;
 
-    SupplementalReportColumn00 = mc_str(b->yare_input_.SupplementalReportColumn00);
-    SupplementalReportColumn01 = mc_str(b->yare_input_.SupplementalReportColumn01);
-    SupplementalReportColumn02 = mc_str(b->yare_input_.SupplementalReportColumn02);
-    SupplementalReportColumn03 = mc_str(b->yare_input_.SupplementalReportColumn03);
-    SupplementalReportColumn04 = mc_str(b->yare_input_.SupplementalReportColumn04);
-    SupplementalReportColumn05 = mc_str(b->yare_input_.SupplementalReportColumn05);
-    SupplementalReportColumn06 = mc_str(b->yare_input_.SupplementalReportColumn06);
-    SupplementalReportColumn07 = mc_str(b->yare_input_.SupplementalReportColumn07);
-    SupplementalReportColumn08 = mc_str(b->yare_input_.SupplementalReportColumn08);
-    SupplementalReportColumn09 = mc_str(b->yare_input_.SupplementalReportColumn09);
-    SupplementalReportColumn10 = mc_str(b->yare_input_.SupplementalReportColumn10);
-    SupplementalReportColumn11 = mc_str(b->yare_input_.SupplementalReportColumn11);
-
     mcenum_dbopt const init_dbo = b->DeathBfts_->dbopt()[0];
     InitDBOpt =
          (mce_option1 == init_dbo) ? dbo_name_option1
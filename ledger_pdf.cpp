@@ -28,6 +28,16 @@
 #include "path_utility.hpp"             // unique_filepath()
 #include "pdf_command.hpp"
 
+/// Name of the PDF file that write_ledger_as_pdf() writes.
+
+fs::path pdf_out_filepath(fs::path const& filepath)
+{
+    fs::path print_dir(configurable_settings::instance().print_directory());
+    // PDF !! Either portable_filename() should be used here, or its
+    // use should be reconsidered everywhere else.
+    return unique_filepath(print_dir / filepath, ".pdf");
+}
+
 /// Write a scaled copy of the ledger to a PDF file.
 ///
 /// PDF !! Does the following block comment actually apply here? and
@@ -45,10 +55,7 @@ std::string write_ledger_as_pdf(Ledger const& ledger, fs::path const& filepath)
 {
     throw_if_interdicted(ledger);
 
-    fs::path print_dir(configurable_settings::instance().print_directory());
-    // PDF !! Either portable_filename() should be used here, or its
-    // use should be reconsidered everywhere else.
-    fs::path pdf_out_file = unique_filepath(print_dir / filepath, ".pdf");
+    fs::path pdf_out_file = pdf_out_filepath(filepath);
 
     Ledger scaled_ledger(ledger);
     scaled_ledger.AutoScale();
@@ -30,6 +30,8 @@
 
 class Ledger;
 
+fs::path pdf_out_filepath(fs::path const&);
+
 std::string write_ledger_as_pdf(Ledger const&, fs::path const&);
 
 #endif // ledger_pdf_hpp
@@ -23,15 +23,21 @@
 
 #include "ledger.hpp"
 #include "ledger_evaluator.hpp"
+#include "ledger_image.hpp"
 #include "ledger_invariant.hpp"
 #include "ledger_text_formats.hpp"      // ledger_format()
 #include "ledger_variant.hpp"
 #include "oecumenic_enumerations.hpp"
+#include "ssize_lmi.hpp"
 
 #include "test_tools.hpp"
 #include "timer.hpp"
 
+#include <cstdint>
 #include <cstdio>                       // remove()
+#include <cstring>                      // memcpy()
+#include <sstream>
+#include <stdexcept>
 
 void authenticate_system() {} // Do-nothing stub.
 
@@ -42,6 +48,8 @@ class ledger_test
         {
         test_default_initialization();
         test_evaluator();
+        test_guar_prem_omission();
+        test_image();
         test_ledger_format();
         test_speed();
         }
@@ -49,10 +57,128 @@ class ledger_test
   private:
     static void test_default_initialization();
     static void test_evaluator();
+    static void test_guar_prem_omission();
+    static void test_image();
     static void test_ledger_format();
     static void test_speed();
+
+    static Ledger sample_ledger();
 };
 
+/// A ledger whose members mostly differ from their defaults.
+
+Ledger ledger_test::sample_ledger()
+{
+    Ledger ledger(100, mce_ill_reg, false, false, false);
+    LedgerInvariant& invar = *ledger.ledger_invariant_;
+    for(int j = 0; j < 100; ++j)
+        {
+        invar.GrossPmt[j] = 1000.0 * j + 0.125;
+        invar.SpecAmt [j] = 1.0e6 - j;
+        }
+    invar.ProductName = "sample";
+    invar.FundNames   = {"alpha", "", "gamma"};
+    invar.FundAllocs  = {60, 0, 40};
+    invar.DBOpt[3]    = mce_dbopt(mce_option2);
+    invar.IrrCsvGuar0.assign(100, 0.03125);
+    invar.EffDate     = "2023-01-01";
+
+    LedgerVariant curr(ledger.GetCurrFull());
+    for(int j = 0; j < 100; ++j)
+        {
+        curr.AcctVal[j] = 12345.0 * j;
+        curr.CSVNet [j] = 12000.0 * j;
+        }
+    curr.LapseYear = 45.0;
+    ledger.SetOneLedgerVariant(mce_run_gen_curr_sep_full, curr);
+
+    ledger.AutoScale();
+    return ledger;
+}
+
+/// Test binary ledger images.
+///
+/// A ledger reconstituted from its image should spew exactly as the
+/// original does, and should have the same checksum.
+
+void ledger_test::test_image()
+{
+    Ledger const ledger {sample_ledger()};
+    std::ostringstream original;
+    ledger.Spew(original);
+
+    std::string const z = ledger_image::image(ledger);
+    ledger_image const image(z.data(), z.size());
+
+    Ledger const restored {image.ledger()};
+    std::ostringstream round_trip;
+    restored.Spew(round_trip);
+    LMI_TEST(original.str() == round_trip.str());
+    LMI_TEST_EQUAL(ledger.CalculateCRC(), restored.CalculateCRC());
+    LMI_TEST_EQUAL(ledger.ledger_type(), restored.ledger_type());
+    LMI_TEST(ledger.GetRunBases() == restored.GetRunBases());
+
+    // Members that Spew() omits.
+    LedgerInvariant const& invar = restored.GetLedgerInvariant();
+    LMI_TEST(invar.FundNames == ledger.GetLedgerInvariant().FundNames);
+    LMI_TEST(invar.IrrCsvGuar0 == ledger.GetLedgerInvariant().IrrCsvGuar0);
+    LMI_TEST_EQUAL("2023-01-01", invar.EffDate);
+    LMI_TEST_EQUAL(mce_option2, invar.DBOpt[3].value());
+    LMI_TEST_EQUAL(ledger.GetLedgerInvariant().scale_unit(), invar.scale_unit());
+
+    // Values can be used in place.
+    std::vector<double> const& acct_val = ledger.GetCurrFull().AcctVal;
+    auto const v = image.vector(mce_run_gen_curr_sep_full, "AcctVal");
+    LMI_TEST(std::vector<double>(v.begin(), v.end()) == acct_val);
+    LMI_TEST_EQUAL(45.0, image.vector(mce_run_gen_curr_sep_full, "LapseYear")[0]);
+    LMI_TEST_EQUAL("sample", image.string("ProductName"));
+    LMI_TEST_THROW
+        (image.vector("NoSuchVector")
+        ,std::runtime_error
+        ,"Ledger image (in memory) lacks 'NoSuchVector'."
+        );
+    LMI_TEST_THROW
+        (image.vector("ProductName")
+        ,std::runtime_error
+        ,"Ledger image (in memory): 'ProductName' has the wrong type."
+        );
+
+    // Files are mapped where possible.
+    ledger_image::write(ledger, "eraseme.ledger");
+    std::ostringstream from_file;
+    ledger_image("eraseme.ledger").ledger().Spew(from_file);
+    LMI_TEST(original.str() == from_file.str());
+    LMI_TEST(0 == std::remove("eraseme.ledger"));
+
+    // Damaged images are rejected.
+    std::string bad_magic(z);
+    bad_magic[0] = 'X';
+    LMI_TEST_THROW
+        (ledger_image(bad_magic.data(), bad_magic.size())
+        ,std::runtime_error
+        ,"File (in memory) is not a ledger image."
+        );
+    LMI_TEST_THROW
+        (ledger_image(z.data(), z.size() - 1)
+        ,std::runtime_error
+        ,"Ledger image (in memory) is corrupt."
+        );
+
+    // A count so great that its size in bytes would wrap around to
+    // the correct value is rejected. The number of entries, each of
+    // 32 bytes, follows the magic number and four 32-bit fields.
+    std::string wrapped(z);
+    std::uint64_t n_entries;
+    std::memcpy(&n_entries, wrapped.data() + 24, sizeof n_entries);
+    n_entries += std::uint64_t(1) << 59;
+    std::memcpy(wrapped.data() + 24, &n_entries, sizeof n_entries);
+    LMI_TEST_THROW
+        (ledger_image(wrapped.data(), wrapped.size())
+        ,std::runtime_error
+        ,"Ledger image (in memory) is corrupt."
+        );
+}
+
 void ledger_test::test_default_initialization()
 {
     Ledger ledger(100, mce_finra, false, false, false);
@@ -75,10 +201,61 @@ void ledger_test::test_evaluator()
     Ledger ledger(100, mce_finra, false, false, false);
     ledger.ledger_invariant_->WriteTsvFile = true;
     ledger_evaluator z {ledger.make_evaluator()};
+
+    // Values are formatted on demand, and memoized.
+    LMI_TEST_EQUAL("1"  , z.value("PolicyYear", 0));
+    LMI_TEST_EQUAL("100", z.value("PolicyYear", 99));
+    LMI_TEST_EQUAL(100  , lmi::ssize(z.values("PolicyYear")));
+    LMI_TEST(&z.values("PolicyYear") == &z.values("PolicyYear"));
+    LMI_TEST_THROW
+        (z.value("NoSuchKey")
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Key 'NoSuchKey' not found.")
+        );
+
+    // Copies share memoized values.
+    ledger_evaluator const y {z};
+    LMI_TEST(&y.values("PolicyYear") == &z.values("PolicyYear"));
+
     z.write_tsv("tsv_eraseme");
     LMI_TEST(0 == std::remove("tsv_eraseme.values.tsv"));
 }
 
+/// Test omission of the guaranteed premium.
+///
+/// A composite lacks that premium if any cell does, and it cannot be
+/// read from either.
+
+void ledger_test::test_guar_prem_omission()
+{
+    Ledger cell {sample_ledger()};
+    cell.OmitGuarPremium();
+    LMI_TEST(cell.GetLedgerInvariant().is_guar_prem_omitted());
+
+    std::string const z = ledger_image::image(cell);
+    LMI_TEST(ledger_image(z.data(), z.size()).ledger().GetLedgerInvariant().is_guar_prem_omitted());
+
+    Ledger composite(100, mce_ill_reg, false, false, true);
+    composite.PlusEq(sample_ledger());
+    LMI_TEST(!composite.GetLedgerInvariant().is_guar_prem_omitted());
+    composite.PlusEq(cell);
+    LMI_TEST( composite.GetLedgerInvariant().is_guar_prem_omitted());
+
+    std::ostringstream oss;
+    LMI_TEST_THROW
+        (composite.Spew(oss)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Assertion '!guar_prem_omitted_' failed")
+        );
+
+    ledger_evaluator const evaluator {cell.make_evaluator()};
+    LMI_TEST_THROW
+        (evaluator.value("GuarPrem")
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Assertion .* failed")
+        );
+}
+
 void ledger_test::test_ledger_format()
 {
     constexpr double pi {3.14159265358979323851};
@@ -128,11 +305,19 @@ void ledger_test::test_speed()
     auto f0 = [       ]() {Ledger(100, mce_finra, false, false, false);};
     auto f1 = [&ledger]() {ledger.make_evaluator();};
     auto f2 = [&z     ]() {z.write_tsv("tsv_eraseme");};
+    Ledger const sample {sample_ledger()};
+    std::string const image {ledger_image::image(sample)};
+    auto f3 = [&sample]() {ledger_image::image(sample);};
+    auto f4 = [&image ]() {ledger_image(image.data(), image.size()).ledger();};
+    auto f5 = [&image ]() {ledger_image(image.data(), image.size()).vector(mce_run_gen_curr_sep_full, "CSVNet");};
     std::cout
         << "\nLedger speed tests:"
         << "\n  construct        : " << TimeAnAliquot(f0)
         << "\n  make_evaluator() : " << TimeAnAliquot(f1)
         << "\n  write_tsv()      : " << TimeAnAliquot(f2)
+        << "\n  image()          : " << TimeAnAliquot(f3)
+        << "\n  image to ledger  : " << TimeAnAliquot(f4)
+        << "\n  image to column  : " << TimeAnAliquot(f5)
         << "\n  mete_format()    : " << TimeAnAliquot(mete_format)
         << std::endl
         ;
@@ -255,6 +255,7 @@ std::string calculation_summary_formatter::format_as_html() const
         oss << "<table border=\"0\" cellpadding=\"0\" cellspacing=\"0\" width=\"100%\">\n";
         if(is_subject_to_ill_reg(ledger_.ledger_type()))
             {
+            LMI_ASSERT(!invar_.is_guar_prem_omitted());
             oss
             << "<tr>\n"
             << "  <td align=\"right\" nowrap></td>\n"
@@ -358,6 +359,7 @@ std::string calculation_summary_formatter::format_as_tsv() const
         {
         if(is_subject_to_ill_reg(ledger_.ledger_type()))
             {
+            LMI_ASSERT(!invar_.is_guar_prem_omitted());
             oss
             << std::setprecision(2)
             << invar_.GuarPrem
@@ -934,6 +936,7 @@ void FlatTextLedgerPrinter::PrintFooter() const
 
 void FlatTextLedgerPrinter::PrintNarrativeSummary() const
 {
+    LMI_ASSERT(!invar().is_guar_prem_omitted());
 //         "123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 123456789 "
     os_ << center("Narrative summary") << endrow;
     os_ << endrow;
@@ -42,6 +42,8 @@ class BasicValues;
 class LMI_SO LedgerVariant final
     :public LedgerBase
 {
+    friend class ledger_image;
+
   public:
     // A default ctor is required because this class is used as a
     // std::map's value_type. It's okay to initialize map contents
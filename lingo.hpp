@@ -37,6 +37,8 @@
 class LMI_SO lingo final
     :public cache_file_reads<lingo>
 {
+    friend class product_snapshot;
+
   public:
     explicit lingo(fs::path const& filename);
 
@@ -47,6 +49,8 @@ class LMI_SO lingo final
     static void write_proprietary_lingo_files();
 
   private:
+    lingo() = default; // Used by product_snapshot.
+
     // This class does not derive from xml_serializable, but it
     // implements these three functions that are akin to virtuals
     // of class xml_serializable.
@@ -137,26 +137,29 @@ void Loads::Initialize(product_database const& database, load_details const& det
 {
     round_to<double> const& r = details.round_minutiae_;
 
-    database.query_into(DB_LoadRfdProportion , refundable_sales_load_proportion_   );
-    database.query_into(DB_DacTaxPremLoad    , dac_tax_load_                       );
-
     database.query_into(DB_GuarMonthlyPolFee , monthly_policy_fee_   [mce_gen_guar]);
     database.query_into(DB_GuarAnnualPolFee  , annual_policy_fee_    [mce_gen_guar]);
-    database.query_into(DB_GuarSpecAmtLoad   , specified_amount_load_[mce_gen_guar]);
-    database.query_into(DB_GuarAcctValLoad   , separate_account_load_[mce_gen_guar]);
-    database.query_into(DB_GuarPremLoadTgt   , target_premium_load_  [mce_gen_guar]);
-    database.query_into(DB_GuarPremLoadExc   , excess_premium_load_  [mce_gen_guar]);
-    database.query_into(DB_GuarPremLoadTgtRfd, target_sales_load_    [mce_gen_guar]);
-    database.query_into(DB_GuarPremLoadExcRfd, excess_sales_load_    [mce_gen_guar]);
-
     database.query_into(DB_CurrMonthlyPolFee , monthly_policy_fee_   [mce_gen_curr]);
     database.query_into(DB_CurrAnnualPolFee  , annual_policy_fee_    [mce_gen_curr]);
-    database.query_into(DB_CurrSpecAmtLoad   , specified_amount_load_[mce_gen_curr]);
-    database.query_into(DB_CurrSepAcctLoad   , separate_account_load_[mce_gen_curr]);
-    database.query_into(DB_CurrPremLoadTgt   , target_premium_load_  [mce_gen_curr]);
-    database.query_into(DB_CurrPremLoadExc   , excess_premium_load_  [mce_gen_curr]);
-    database.query_into(DB_CurrPremLoadTgtRfd, target_sales_load_    [mce_gen_curr]);
-    database.query_into(DB_CurrPremLoadExcRfd, excess_sales_load_    [mce_gen_curr]);
+
+    database.query_many
+        ({{DB_LoadRfdProportion , &refundable_sales_load_proportion_   }
+         ,{DB_DacTaxPremLoad    , &dac_tax_load_                       }
+
+         ,{DB_GuarSpecAmtLoad   , &specified_amount_load_[mce_gen_guar]}
+         ,{DB_GuarAcctValLoad   , &separate_account_load_[mce_gen_guar]}
+         ,{DB_GuarPremLoadTgt   , &target_premium_load_  [mce_gen_guar]}
+         ,{DB_GuarPremLoadExc   , &excess_premium_load_  [mce_gen_guar]}
+         ,{DB_GuarPremLoadTgtRfd, &target_sales_load_    [mce_gen_guar]}
+         ,{DB_GuarPremLoadExcRfd, &excess_sales_load_    [mce_gen_guar]}
+
+         ,{DB_CurrSpecAmtLoad   , &specified_amount_load_[mce_gen_curr]}
+         ,{DB_CurrSepAcctLoad   , &separate_account_load_[mce_gen_curr]}
+         ,{DB_CurrPremLoadTgt   , &target_premium_load_  [mce_gen_curr]}
+         ,{DB_CurrPremLoadExc   , &excess_premium_load_  [mce_gen_curr]}
+         ,{DB_CurrPremLoadTgtRfd, &target_sales_load_    [mce_gen_curr]}
+         ,{DB_CurrPremLoadExcRfd, &excess_sales_load_    [mce_gen_curr]}
+         });
 
     // Make sure database contents have no excess precision.
     LMI_ASSERT
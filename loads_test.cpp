@@ -50,6 +50,7 @@ std::vector<double> BasicValues::GetGuarSpecAmtLoadTable() const {return dummy_v
 #include "database.hpp"
 int product_database::length() const {return length_;}
 void product_database::query_into(e_database_key, std::vector<double>& v) const {v.resize(length_);}
+void product_database::query_many(query_list z) const {for(auto const& i : z) {i.second->resize(length_);}}
 void product_database::query_into(e_database_key, std::vector<currency>& v) const {v.resize(length_);}
 double product_database::query(e_database_key, database_index const&) const {return 0.0;}
 
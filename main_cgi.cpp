@@ -36,8 +36,10 @@
 #include "alert.hpp"
 #include "configurable_settings.hpp"
 #include "global_settings.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
 #include "illustrator.hpp"
 #include "input.hpp"
+#include "ledger_cache.hpp"             // ledger_cache::default_directory()
 #include "lmi.hpp"                      // is_antediluvian_fork()
 #include "main_common.hpp"
 #include "mc_enum_type_enums.hpp"       // mcenum_emission
@@ -94,6 +96,21 @@ int try_main(int argc, char* argv[])
         ,ios_out_trunc_binary()
         );
 
+    // Each request is served by a new process, so a ledger can be
+    // reused only if it was cached on disk. If the cache directory
+    // can't be created, just calculate every illustration.
+    try
+        {
+        global_settings::instance().set_ledger_cache_directory
+            (ledger_cache::default_directory()
+            );
+        global_settings::instance().set_cache_ledgers(true);
+        }
+    catch(...)
+        {
+        report_exception();
+        }
+
     if(argc == 2 && argv[1] == std::string("--capture"))
         {
 #       if defined LMI_POSIX
@@ -24,6 +24,7 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "calendar_date.hpp"
+#include "configurable_settings.hpp"
 #include "contains.hpp"
 #include "dbdict.hpp"                   // print_databases()
 #include "getopt.hpp"
@@ -33,8 +34,10 @@
 #include "illustrator.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
+#include "ledger_cache.hpp"             // ledger_cache::default_directory()
 #include "ledger_invariant.hpp"
 #include "ledger_variant.hpp"
+#include "ledgervalues.hpp"
 #include "license.hpp"
 #include "lmi.hpp"                      // is_antediluvian_fork()
 #include "main_common.hpp"
@@ -43,25 +46,105 @@
 #include "mc_enum_types_aux.hpp"        // allowed_strings_emission(), mc_emission_from_string()
 #include "mec_server.hpp"
 #include "miscellany.hpp"
+#include "monthly_trace.hpp"            // format_monthly_trace()
+#include "multiple_cell_document.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"
+#include "pdf_render_pool.hpp"
+#include "product_snapshot.hpp"         // write_product_snapshots()
+#include "rate_scenarios.hpp"
+#include "sensitivity_grid.hpp"
 #include "so_attributes.hpp"
+#include "ssize_lmi.hpp"
 #include "timer.hpp"
 #include "value_cast.hpp"
 #include "verify_products.hpp"
+#include "yare_input.hpp"
 
-#include <algorithm>                    // for_each()
+#include <algorithm>                    // equal(), for_each()
 #include <cmath>                        // fabs()
 #include <cstdio>                       // printf()
 #include <functional>                   // bind()
 #include <ios>
 #include <iostream>
+#include <memory>                       // shared_ptr
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+/// Verify that projecting a cell under several interest-rate scenarios
+/// gives the same results as a separate illustration for each.
+///
+/// The entered rate governs only if the current declared rate isn't
+/// used instead. Rates lie within the sample products' range of
+/// general-account rates, [0.03, 0.06].
+
+void test_rate_scenarios(Input const& input)
+{
+    Input base {input};
+    base["UseCurrentDeclaredRate"] = "No";
+    std::vector<std::string> const rates {"0.03", "0.06", "0.045"};
+    std::vector<rate_scenario> scenarios;
+    std::vector<std::shared_ptr<Ledger const>> separate;
+    for(auto const& i : rates)
+        {
+        Input cell {base};
+        cell["GeneralAccountRate"] = i;
+        cell.RealizeAllSequenceInput();
+        yare_input const y(cell);
+        scenarios.push_back({y.GeneralAccountRate, y.SeparateAccountRate});
+        IllusVal v("CLI_selftest");
+        v.run(cell);
+        separate.push_back(v.ledger());
+        }
+
+    std::vector<std::shared_ptr<Ledger const>> const shared =
+        run_rate_scenarios(base, scenarios);
+
+    auto const same = [](double_vector_map const& a, double_vector_map const& b)
+        {
+        return std::equal
+            (a.begin(), a.end()
+            ,b.begin(), b.end()
+            ,[](auto const& x, auto const& y)
+                {return x.first == y.first && *x.second == *y.second;}
+            );
+        };
+    for(int k = 0; k < lmi::ssize(rates); ++k)
+        {
+        Ledger const& a = *shared  [k];
+        Ledger const& b = *separate[k];
+        bool ok = same
+            (a.GetLedgerInvariant().all_vectors()
+            ,b.GetLedgerInvariant().all_vectors()
+            );
+        ledger_map_t const& a_bases = a.GetLedgerMap().held();
+        ledger_map_t const& b_bases = b.GetLedgerMap().held();
+        ok = ok && std::equal
+            (a_bases.begin(), a_bases.end()
+            ,b_bases.begin(), b_bases.end()
+            ,[&same](auto const& x, auto const& y)
+                {
+                return
+                       x.first == y.first
+                    && same(x.second.all_vectors(), y.second.all_vectors())
+                    ;
+                }
+            );
+        if(!ok)
+            {
+            warning()
+                << "Interest-rate scenario "
+                << rates[k]
+                << " differs from a separate illustration."
+                << LMI_FLUSH
+                ;
+            }
+        }
+}
+
 /// Spot check and time some insurance calculations.
 ///
 /// The antediluvian fork's calculated results don't match the
@@ -138,6 +221,10 @@ void self_test()
             ;
         }
 
+    test_rate_scenarios(naic_no_solve);
+    test_rate_scenarios(naic_solve_specamt);
+    test_rate_scenarios(naic_solve_ee_prem);
+
     Input finra_no_solve      {naic_no_solve};
     Input finra_solve_specamt {naic_solve_specamt};
     Input finra_solve_ee_prem {naic_solve_ee_prem};
@@ -209,6 +296,33 @@ void product_test()
         }
 }
 
+/// Command that starts a helper process to render pdf files.
+///
+/// The helper is this same program, given every option that affects
+/// rendering. It calculates nothing: it renders ledger images that
+/// the calling process writes.
+
+std::string pdf_helper_command(char const* program)
+{
+    global_settings const& g = global_settings::instance();
+    std::ostringstream oss;
+    oss << '"' << program << '"' << " --accept";
+    if(g.ash_nazg())
+        {
+        oss << " --ash_nazg";
+        }
+    else if(g.mellon())
+        {
+        oss << " --mellon";
+        }
+    oss << " --data_path=\"" << g.data_directory().string() << '"';
+    if(!g.pyx().empty())
+        {
+        oss << " --pyx=\"" << g.pyx() << '"';
+        }
+    return oss.str();
+}
+
 void process_command_line(int argc, char* argv[])
 {
     // TRICKY !! Some long options are aliased to unlikely octal values.
@@ -219,17 +333,26 @@ void process_command_line(int argc, char* argv[])
         {"mellon"       ,NO_ARG   ,nullptr ,002 ,nullptr ,"pedo mellon a minno"},
         {"mello"        ,NO_ARG   ,nullptr ,077 ,nullptr ,"fraud"},
         {"prospicience" ,REQD_ARG ,nullptr ,003 ,nullptr ,"validation date"},
+        {"ledger_store" ,NO_ARG   ,nullptr ,004 ,nullptr ,"like '--ledger_cache', but keep ledgers on disk too"},
         {"accept"       ,NO_ARG   ,nullptr ,'a' ,nullptr ,"accept license (-l to display)"},
+        {"binary_census",REQD_ARG ,nullptr ,'b' ,nullptr ,"write '.cns' file as binary '.cnsb' file"},
+        {"ledger_cache" ,NO_ARG   ,nullptr ,'c' ,nullptr ,"reuse ledgers of identical illustrations"},
         {"data_path"    ,REQD_ARG ,nullptr ,'d' ,nullptr ,"path to data files"},
         {"emit"         ,REQD_ARG ,nullptr ,'e' ,nullptr ,"choose what output to emit"},
         {"file"         ,REQD_ARG ,nullptr ,'f' ,nullptr ,"input file to run"},
+        {"grid"         ,REQD_ARG ,nullptr ,'g' ,nullptr ,"run '.ill' files on grid axis 'name=value|value|...'"},
         {"help"         ,NO_ARG   ,nullptr ,'h' ,nullptr ,"display this help and exit"},
+        {"render_pdf"   ,REQD_ARG ,nullptr ,'i' ,nullptr ,"render ledger image as pdf (with '--pdf_file')"},
         {"license"      ,NO_ARG   ,nullptr ,'l' ,nullptr ,"display license and exit"},
+        {"snapshot"     ,NO_ARG   ,nullptr ,'n' ,nullptr ,"write product snapshots and exit"},
         {"product_test" ,NO_ARG   ,nullptr ,'o' ,nullptr ,"validate products and exit"},
         {"print_db"     ,NO_ARG   ,nullptr ,'p' ,nullptr ,"print products and exit"},
+        {"pdf_processes",REQD_ARG ,nullptr ,'r' ,nullptr ,"render census pdf files in this many helper processes"},
         {"selftest"     ,NO_ARG   ,nullptr ,'s' ,nullptr ,"perform self test and exit"},
         {"test_db"      ,NO_ARG   ,nullptr ,'t' ,nullptr ,"test products and exit"},
+        {"pdf_file"     ,REQD_ARG ,nullptr ,'w' ,nullptr ,"pdf file to write for '--render_pdf'"},
         {"pyx"          ,REQD_ARG ,nullptr ,'x' ,nullptr ,"for docimasy"},
+        {"grid_years"   ,REQD_ARG ,nullptr ,'y' ,nullptr ,"policy years for grid cash values, e.g. '5,10,20'"},
         {nullptr        ,NO_ARG   ,nullptr ,000 ,nullptr ,""}
       };
 
@@ -240,6 +363,15 @@ void process_command_line(int argc, char* argv[])
     std::vector<std::string> illustrator_names;
     std::vector<std::string> mec_server_names;
     std::vector<std::string> gpt_server_names;
+    std::vector<std::string> raw_trace_names;
+    std::vector<std::string> binary_census_names;
+
+    std::vector<grid_axis> grid_axes;
+    std::vector<int>       grid_years {5, 10, 20, 30};
+
+    int pdf_processes = 0;
+    std::string render_pdf_image;
+    std::string render_pdf_file;
 
     int digit_optind = 0;
     int this_option_optind = 1;
@@ -304,6 +436,15 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 004:
+                {
+                global_settings::instance().set_cache_ledgers(true);
+                global_settings::instance().set_ledger_cache_directory
+                    (ledger_cache::default_directory()
+                    );
+                }
+                break;
+
             case '0':
             case '1':
             case '2':
@@ -330,6 +471,19 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'b':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                binary_census_names.push_back(getopt_long.optarg);
+                }
+                break;
+
+            case 'c':
+                {
+                global_settings::instance().set_cache_ledgers(true);
+                }
+                break;
+
             case 'd':
                 {
                 global_settings::instance().set_data_directory
@@ -375,18 +529,32 @@ void process_command_line(int argc, char* argv[])
                 LMI_ASSERT(nullptr != getopt_long.optarg);
                 std::string const s(getopt_long.optarg);
                 std::string const e = fs::path{s}.extension().string();
-                if(".cns" == e || ".ill" == e || ".ini" == e || ".inix" == e)
+                if
+                    (  ".cns" == e || ".cnsb" == e
+                    || ".ill" == e || ".ini"  == e || ".inix" == e
+                    )
                     {
                     illustrator_names.push_back(getopt_long.optarg);
                     }
-                else if(".mec" == e)
+                else if(".mec" == e || ".mecs" == e)
                     {
                     mec_server_names.push_back(getopt_long.optarg);
                     }
-                else if(".gpt" == e)
+                else if(".gpt" == e || ".gpts" == e)
                     {
                     gpt_server_names.push_back(getopt_long.optarg);
                     }
+                else if
+                    (  e
+                    == configurable_settings::instance().spreadsheet_file_extension()
+                    )
+                    {
+                    illustrator_names.push_back(getopt_long.optarg);
+                    }
+                else if(".mtrace" == e)
+                    {
+                    raw_trace_names.push_back(getopt_long.optarg);
+                    }
                 else
                     {
                     warning()
@@ -399,6 +567,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'g':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                grid_axes.push_back(parse_grid_axis(getopt_long.optarg));
+                }
+                break;
+
             case 'h':
                 {
                 getopt_long.usage();
@@ -411,6 +586,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'i':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                render_pdf_image = getopt_long.optarg;
+                }
+                break;
+
             case 'l':
                 {
                 std::cerr << license_as_text() << "\n\n";
@@ -418,6 +600,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'n':
+                {
+                write_product_snapshots();
+                return;
+                }
+                break;
+
             case 'o':
                 {
                 product_test();
@@ -432,6 +621,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'r':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                pdf_processes = value_cast<int>(std::string(getopt_long.optarg));
+                }
+                break;
+
             case 's':
                 {
                 self_test();
@@ -446,6 +642,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'w':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                render_pdf_file = getopt_long.optarg;
+                }
+                break;
+
             case 'x':
                 {
                 global_settings::instance().set_pyx(getopt_long.optarg);
@@ -456,6 +659,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'y':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                grid_years = parse_grid_years(getopt_long.optarg);
+                }
+                break;
+
             case '?':
                 {
                 break;
@@ -483,6 +693,47 @@ void process_command_line(int argc, char* argv[])
         std::cerr << license_notices_as_text() << "\n\n";
         }
 
+    // As a helper process for pdf_render_pool, render one ledger.
+    if(!render_pdf_image.empty() || !render_pdf_file.empty())
+        {
+        if(render_pdf_image.empty() || render_pdf_file.empty())
+            {
+            alarum()
+                << "Options '--render_pdf' and '--pdf_file' must be used together."
+                << LMI_FLUSH
+                ;
+            }
+        pdf_render_pool::render(render_pdf_image, render_pdf_file);
+        }
+
+    if(0 < pdf_processes)
+        {
+        pdf_render_pool::set_helper(pdf_helper_command(argv[0]), pdf_processes);
+        }
+
+    // With grid axes, each '.ill' file is run as a sensitivity grid
+    // instead of being illustrated.
+    if(!grid_axes.empty())
+        {
+        std::vector<std::string> grid_names;
+        std::erase_if
+            (illustrator_names
+            ,[&grid_names] (std::string const& i)
+                {
+                bool const b = ".ill" == fs::path{i}.extension().string();
+                if(b)
+                    {
+                    grid_names.push_back(i);
+                    }
+                return b;
+                }
+            );
+        for(auto const& i : grid_names)
+            {
+            run_sensitivity_grid_file(i, grid_axes, grid_years);
+            }
+        }
+
     std::for_each
         (illustrator_names.begin()
         ,illustrator_names.end()
@@ -500,6 +751,21 @@ void process_command_line(int argc, char* argv[])
         ,gpt_server_names.end()
         ,gpt_server(emission)
         );
+
+    // Format raw monthly traces as tab-delimited text, replacing the
+    // '.mtrace' extension with the spreadsheet extension.
+    std::string const& tsv_ext =
+        configurable_settings::instance().spreadsheet_file_extension();
+    for(auto const& i : raw_trace_names)
+        {
+        format_monthly_trace(i, fs::path{i}.replace_extension(tsv_ext).string());
+        }
+
+    // Write each census in binary form beside the original.
+    for(auto const& i : binary_census_names)
+        {
+        multiple_cell_document(i).write_binary(fs::path{i}.replace_extension(".cnsb"));
+        }
 }
 
 int try_main(int argc, char* argv[])
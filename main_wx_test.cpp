@@ -26,6 +26,7 @@
 #include "bourn_cast.hpp"
 #include "docmanager_ex.hpp"
 #include "force_linking.hpp"
+#include "global_settings.hpp"
 #include "handle_exceptions.hpp"        // stealth_exception
 #include "main_common.hpp"              // initialize_application()
 #include "path.hpp"
@@ -708,6 +709,10 @@ bool SkeletonTest::OnInit()
         return false;
         }
 
+    // Tests expect each census command to finish before its results
+    // are examined.
+    global_settings::instance().set_census_in_background(false);
+
     // Run the tests at idle time, when the main loop is running, in order to
     // do it in as realistic conditions as possible.
     CallAfter(&SkeletonTest::RunTheTests);
@@ -26,8 +26,11 @@
 
 #include <algorithm>                    // max(), min(), transform()
 #include <cmath>                        // fabs(), signbit()
+#include <cstddef>                      // size_t
+#include <cstring>                      // memcmp()
 #include <limits>
 #include <numeric>                      // midpoint(), partial_sum()
+#include <span>
 #include <stdexcept>
 #include <type_traits>                  // is_, has_, make_ ...
 #include <vector>
@@ -417,6 +420,117 @@ struct coi_rate_from_q
         }
 };
 
+// Batch versions of the actuarial functions above.
+//
+// Rates are usually converted a whole vector at a time, and such
+// vectors typically hold long runs of equal values (a level interest
+// rate, or q = 1 beyond some age). These kernels apply the scalar
+// functors to each element of a contiguous span, but reuse the last
+// result wherever an argument is bitwise identical to its
+// predecessor, so they give exactly the same results as the scalar
+// functors, including the same exceptions for the first invalid
+// argument. That reuse pays only for runs of equal arguments: for a
+// mortality table, whose rates seldom repeat, the comparison is pure
+// overhead (see the speed test in 'math_functions_test.cpp').
+// Vectorizing expm1() and log1p() themselves would be faster, but
+// could not preserve the fdlibm results to the last bit.
+//
+// Output may alias input, so a result can replace its argument.
+
+namespace math_functions_detail
+{
+template<typename T>
+bool bitwise_equal(T t0, T t1)
+{
+    static_assert(std::is_floating_point_v<T>);
+    return 0 == std::memcmp(&t0, &t1, sizeof(T));
+}
+
+template<typename T>
+void assert_equal_extents(std::span<T const> in, std::span<T> out)
+{
+    if(in.size() != out.size())
+        {
+        throw std::runtime_error("Spans are of unequal length.");
+        }
+}
+
+template<typename T, typename F>
+void apply_batch(F f, std::span<T const> in, std::span<T> out)
+{
+    assert_equal_extents(in, out);
+    T prior_argument {};
+    T prior_result   {};
+    for(std::size_t j = 0; j < in.size(); ++j)
+        {
+        T const argument = in[j];
+        if(0 == j || !bitwise_equal(argument, prior_argument))
+            {
+            prior_result   = f(argument);
+            prior_argument = argument;
+            }
+        out[j] = prior_result;
+        }
+}
+} // namespace math_functions_detail
+
+template<typename T>
+void i_upper_12_over_12_from_i_batch(std::span<T const> i, std::span<T> z)
+{
+    math_functions_detail::apply_batch(i_upper_12_over_12_from_i<T>(), i, z);
+}
+
+/// Batch coi_rate_from_q, with a scalar 'max_coi'.
+///
+/// 'max_coi' is validated even if 'q' is empty, as it would be by
+/// the scalar functor for any element.
+
+template<typename T>
+void coi_rate_from_q_batch(std::span<T const> q, T max_coi, std::span<T> z)
+{
+    coi_rate_from_q<T> const f;
+    f(T(0), max_coi);
+    math_functions_detail::apply_batch
+        ([=](T t) {return f(t, max_coi);}
+        ,q
+        ,z
+        );
+}
+
+/// Batch coi_rate_from_q, with a 'max_coi' for each element.
+
+template<typename T>
+void coi_rate_from_q_batch
+    (std::span<T const> q
+    ,std::span<T const> max_coi
+    ,std::span<T>       z
+    )
+{
+    using math_functions_detail::bitwise_equal;
+    math_functions_detail::assert_equal_extents(q, z);
+    math_functions_detail::assert_equal_extents(max_coi, z);
+    coi_rate_from_q<T> const f;
+    T prior_q      {};
+    T prior_max    {};
+    T prior_result {};
+    for(std::size_t j = 0; j < q.size(); ++j)
+        {
+        T const q_j   = q[j];
+        T const max_j = max_coi[j];
+        if
+            (  0 == j
+            || !bitwise_equal(q_j  , prior_q  )
+            || !bitwise_equal(max_j, prior_max)
+            )
+            {
+            prior_result = f(q_j, max_j);
+            prior_q      = q_j;
+            prior_max    = max_j;
+            }
+        z[j] = prior_result;
+        }
+}
+
 /// Midpoint for illustration reg.
 ///
 /// Section 7(C)(1)(c)(ii) prescribes an "average" without specifying
@@ -24,20 +24,25 @@
 #include "math_functions.hpp"
 
 #include "bin_exp.hpp"
+#include "cso_table.hpp"
 #include "fenv_lmi.hpp"
 #include "materially_equal.hpp"
 #include "miscellany.hpp"               // stifle_unused_warning()
 #include "test_tools.hpp"
 #include "timer.hpp"
 
-#include <algorithm>                    // min()
+#include <algorithm>                    // fill(), min()
 #include <cfloat>                       // DBL_EPSILON
 #include <climits>                      // CHAR_BIT
 #include <cmath>                        // fabs(), isnan(), pow()
+#include <cstddef>                      // size_t
 #include <cstdint>
+#include <cstring>                      // memcmp()
 #include <iomanip>
 #include <limits>
+#include <span>
 #include <type_traits>
+#include <vector>
 
 // Some of these tests may raise hardware exceptions. That means that
 // edge cases are tested, not that the code tested is invalid for
@@ -263,6 +268,58 @@ void mete9()
     stifle_unused_warning(x);
 }
 
+// These 'mete1[01]' functions convert every 1980 CSO table to monthly
+// COI rates, with the scalar functor and the batch kernel. Mortality
+// rates seldom repeat, so the batch kernel can rarely reuse a prior
+// result: this measures what its bitwise comparison costs on the
+// rates a product actually loads, not any benefit of memoization.
+
+std::vector<std::vector<double>> const& cso_1980_tables()
+{
+    static std::vector<std::vector<double>> const z = []
+        {
+        std::vector<std::vector<double>> v;
+        for(auto g : {mce_female, mce_male, mce_unisex})
+            for(auto s : {mce_smoker, mce_nonsmoker, mce_unismoke})
+                {
+                v.push_back
+                    (cso_table(mce_1980cso, oe_orthodox, oe_age_last_birthday, g, s)
+                    );
+                }
+        return v;
+        } ();
+    return z;
+}
+
+void mete10()
+{
+    for(auto const& q : cso_1980_tables())
+        {
+        std::vector<double> z(q.size());
+        for(int j = 0; j < 100; ++j)
+            {
+            for(std::size_t k = 0; k < q.size(); ++k)
+                {
+                z[k] = coi_rate_from_q<double>()(q[k], 1.0);
+                }
+            }
+        stifle_unused_warning(z);
+        }
+}
+
+void mete11()
+{
+    for(auto const& q : cso_1980_tables())
+        {
+        std::vector<double> z(q.size());
+        for(int j = 0; j < 100; ++j)
+            {
+            coi_rate_from_q_batch<double>(q, 1.0, z);
+            }
+        stifle_unused_warning(z);
+        }
+}
+
 void test_assign_midpoint()
 {
     constexpr double smallnum = std::numeric_limits<double>::denorm_min();
@@ -782,6 +839,148 @@ void test_expm1_log1p()
         ;
 }
 
+/// Batch kernels must reproduce the scalar functors bit for bit.
+///
+/// Test them first with rates as a product uses them--interest rates
+/// that stay level for many years, and a real mortality table--and
+/// then with rates chosen to probe edge cases.
+
+void test_batch_kernels()
+{
+    auto const identical = []
+        (std::vector<double> const& v0
+        ,std::vector<double> const& v1
+        )
+        {
+        return
+               v0.size() == v1.size()
+            && 0 == std::memcmp(v0.data(), v1.data(), v0.size() * sizeof(double))
+            ;
+        };
+
+    // Annual interest credited over a hundred policy years: a current
+    // rate for ten years, then an ultimate rate, as an illustration
+    // uses them; and the GLP and GSP rates that i7702 converts.
+    std::vector<double> product_i(10, 0.055);
+    product_i.resize(100, 0.045);
+    std::vector<double> glp_i(20, 0.06);
+    glp_i.resize(100, 0.04);
+    for(auto const& i : {product_i, glp_i})
+        {
+        std::vector<double> z(i.size());
+        std::vector<double> expected(i.size());
+        i_upper_12_over_12_from_i_batch<double>(i, z);
+        for(std::size_t j = 0; j < i.size(); ++j)
+            {expected[j] = i_upper_12_over_12_from_i<double>()(i[j]);}
+        LMI_TEST(identical(expected, z));
+        }
+
+    // Every CSO table a product can select, including the nine 1980
+    // CSO age-last tables that the sample products load as COI and
+    // 7702 rates. Smoker-distinct tables begin with runs of zeros, and
+    // all end with unity. Use them with a scalar COI maximum, and with
+    // a maximum that varies by year only occasionally.
+    auto const test_cso_table = [&identical]
+        (std::vector<double> const& product_q)
+        {
+        std::vector<double> product_max(product_q.size(), 1.0 / 11.0);
+        std::fill(product_max.begin() + 80, product_max.end(), 1.0);
+        std::vector<double> y(product_q.size());
+        std::vector<double> expected_y(product_q.size());
+
+        coi_rate_from_q_batch<double>(product_q, 1.0 / 11.0, y);
+        for(std::size_t j = 0; j < product_q.size(); ++j)
+            {expected_y[j] = coi_rate_from_q<double>()(product_q[j], 1.0 / 11.0);}
+        LMI_TEST(identical(expected_y, y));
+
+        coi_rate_from_q_batch<double>(product_q, product_max, y);
+        for(std::size_t j = 0; j < product_q.size(); ++j)
+            {expected_y[j] = coi_rate_from_q<double>()(product_q[j], product_max[j]);}
+        LMI_TEST(identical(expected_y, y));
+        };
+    for(auto e : {mce_1980cso, mce_2001cso, mce_2017cso})
+        {
+        for(auto a : {oe_orthodox, oe_heterodox})
+            {
+            for(auto b : {oe_age_last_birthday, oe_age_nearest_birthday_ties_older})
+                {
+                for(auto g : {mce_female, mce_male, mce_unisex})
+                    {
+                    for(auto s : {mce_smoker, mce_nonsmoker, mce_unismoke})
+                        {
+                        test_cso_table(cso_table(e, a, b, g, s));
+                        }
+                    }
+                }
+            }
+        }
+
+    // Runs of repeated values, signed zeros, and extreme rates.
+    std::vector<double> const i
+        {0.04, 0.04, 0.04, 0.03, 0.03, 0.0, -0.0, -0.0, 0.0
+        ,-0.5, 1.0e-12, 1.0e-12, 0.99, 3.0, 0.04
+        };
+    std::vector<double> z(i.size());
+    std::vector<double> expected(i.size());
+
+    i_upper_12_over_12_from_i_batch<double>(i, z);
+    for(std::size_t j = 0; j < i.size(); ++j)
+        {expected[j] = i_upper_12_over_12_from_i<double>()(i[j]);}
+    LMI_TEST(identical(expected, z));
+    LMI_TEST(std::signbit(z[6]));
+    LMI_TEST(!std::signbit(z[8]));
+
+    // Conversion in place.
+    z = i;
+    i_upper_12_over_12_from_i_batch<double>(z, z);
+    LMI_TEST(identical(expected, z));
+
+    std::vector<double> const q
+        {0.0, 0.0, 0.001, 0.001, 0.001, 0.25, 0.999999, 1.0, 1.25, 1.25
+        };
+    std::vector<double> const max_coi
+        {1.0, 1.0, 1.0, 0.0001, 0.0001, 1.0, 0.5, 0.5, 0.5, 1.0
+        };
+    std::vector<double> y(q.size());
+    std::vector<double> expected_y(q.size());
+
+    coi_rate_from_q_batch<double>(q, 0.5, y);
+    for(std::size_t j = 0; j < q.size(); ++j)
+        {expected_y[j] = coi_rate_from_q<double>()(q[j], 0.5);}
+    LMI_TEST(identical(expected_y, y));
+
+    coi_rate_from_q_batch<double>(q, max_coi, y);
+    for(std::size_t j = 0; j < q.size(); ++j)
+        {expected_y[j] = coi_rate_from_q<double>()(q[j], max_coi[j]);}
+    LMI_TEST(identical(expected_y, y));
+
+    // Invalid arguments throw the same exceptions as the scalar
+    // functors, and validation of a scalar maximum doesn't depend
+    // on whether there are any elements to convert.
+
+    LMI_TEST_THROW
+        (i_upper_12_over_12_from_i_batch<double>(std::vector<double>{0.04, -1.01}, z)
+        ,std::runtime_error
+        ,"Spans are of unequal length."
+        );
+    std::vector<double> w(2);
+    LMI_TEST_THROW
+        (i_upper_12_over_12_from_i_batch<double>(std::vector<double>{0.04, -1.01}, w)
+        ,std::domain_error
+        ,"i is less than -100%."
+        );
+    LMI_TEST_THROW
+        (coi_rate_from_q_batch<double>(std::vector<double>{0.01, -0.01}, 0.5, w)
+        ,std::domain_error
+        ,"q is negative."
+        );
+    LMI_TEST_THROW
+        (coi_rate_from_q_batch<double>(std::vector<double>{}, 1.5, std::span<double>())
+        ,std::runtime_error
+        ,"Maximum COI rate out of range."
+        );
+}
+
 /// This function isn't a unit test per se. Its purpose is to show
 /// how a sample calculation is affected by
 ///   exponential versus power method,
@@ -845,6 +1044,8 @@ void assay_speed()
     std::cout << "  std::expm1()     " << TimeAnAliquot(mete7) << '\n';
     std::cout << "  lmi::log1p()     " << TimeAnAliquot(mete8) << '\n';
     std::cout << "  std::log1p()     " << TimeAnAliquot(mete9) << '\n';
+    std::cout << "  scalar coi, CSO  " << TimeAnAliquot(mete10) << '\n';
+    std::cout << "  batch  coi, CSO  " << TimeAnAliquot(mete11) << '\n';
     std::cout << std::flush;
 }
 
@@ -874,6 +1075,8 @@ int test_main(int, char*[])
 
     test_expm1_log1p();
 
+    test_batch_kernels();
+
     sample_results();
 
     assay_speed();
@@ -46,11 +46,13 @@
 #include "path_utility.hpp"             // unique_filepath(), fs::path inserter
 #include "premium_tax.hpp"
 #include "product_data.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
 #include "round_to.hpp"
 #include "ssize_lmi.hpp"
 #include "stratified_algorithms.hpp"    // TieredGrossToNet()
 #include "stratified_charges.hpp"
 #include "timer.hpp"
+#include "transaction_batch.hpp"
 #include "ul_utilities.hpp"             // max_modal_premium()
 #include "value_cast.hpp"
 
@@ -64,6 +66,7 @@ namespace
 mec_state test_one_days_7702A_transactions
     (fs::path  const& file_path
     ,mec_input const& input
+    ,bool             write_spreadsheet
     )
 {
     bool                        Use7702ATables               = exact_cast<mce_yes_or_no           >(input["Use7702ATables"              ])->value();
@@ -104,8 +107,8 @@ mec_state test_one_days_7702A_transactions
     double                      Payment                      = exact_cast<tnr_nonnegative_double  >(input["Payment"                     ])->value();
     double                      BenefitAmount                = exact_cast<tnr_nonnegative_double  >(input["BenefitAmount"               ])->value();
 
-    // DATABASE !! consider caching these product files
-    product_data product_filenames(ProductName);
+    auto const product(read_product_via_cache(ProductName));
+    product_data const& product_filenames = *product;
 
     product_database database
         (ProductName
@@ -117,7 +120,8 @@ mec_state test_one_days_7702A_transactions
         ,StateOfJurisdiction
         );
 
-    stratified_charges stratified(AddDataDir(product_filenames.datum("TierFilename")));
+    auto const stratified_data(stratified_charges::read_via_cache(AddDataDir(product_filenames.datum("TierFilename"))));
+    stratified_charges const& stratified = *stratified_data;
 
     // SOMEDAY !! Ideally these would be in the GUI (or read from product files).
     round_to<double> const RoundNonMecPrem  (2, r_downward);
@@ -382,6 +386,11 @@ mec_state test_one_days_7702A_transactions
             );
         }
 
+    if(!write_spreadsheet)
+        {
+        return z.state();
+        }
+
     std::vector<double> ratio_Ax (input.years_to_maturity());
     ratio_Ax  += tabular_Ax  / analytic_Ax ;
     std::vector<double> ratio_7Px(input.years_to_maturity());
@@ -466,6 +475,21 @@ bool mec_server::operator()(fs::path const& file_path)
         seconds_for_input_ = timer.stop().elapsed_seconds();
         return operator()(file_path, doc.input_data());
         }
+    else if(".mecs" == extension)
+        {
+        Timer timer;
+        std::string const& tsv_ext =
+            configurable_settings::instance().spreadsheet_file_extension();
+        run_transaction_batch<mec_input,mec_state>
+            (file_path
+            ,fs::path{file_path}.replace_extension(".mecs" + tsv_ext)
+            ,[&file_path] (mec_input const& z)
+                {return test_one_days_7702A_transactions(file_path, z, false);}
+            );
+        seconds_for_calculations_ = timer.stop().elapsed_seconds();
+        conditionally_show_timings_on_stdout();
+        return true;
+        }
     else
         {
         alarum()
@@ -483,7 +507,7 @@ bool mec_server::operator()(fs::path const& file_path)
 bool mec_server::operator()(fs::path const& file_path, mec_input const& z)
 {
     Timer timer;
-    state_ = test_one_days_7702A_transactions(file_path, z);
+    state_ = test_one_days_7702A_transactions(file_path, z, true);
     seconds_for_calculations_ = timer.stop().elapsed_seconds();
     timer.restart();
     if(mce_emit_test_data & emission_)
@@ -40,6 +40,9 @@ class mec_input;
 /// a distinct enumeration seems unwarranted, especially because
 /// explaining another one in '--help' would be too complicated.
 /// Enumerators that don't make sense can be reported at run time.
+///
+/// A '.mecs' file is a tab-delimited batch of many contracts' input,
+/// processed by run_transaction_batch() (q.v.).
 
 class LMI_SO mec_server final
 {
@@ -192,6 +192,33 @@ std::vector<std::string> split_into_lines(std::string const& s)
     return lines;
 }
 
+/// Split a line into tab-delimited fields.
+///
+/// Like repeated std::getline() with a '\t' delimiter: an empty
+/// final field is ignored, so a trailing tab is harmless. Quotation
+/// marks have no special meaning, as in spreadsheet data copied to
+/// the clipboard.
+
+void split_fields
+    (std::string_view               line
+    ,std::vector<std::string_view>& fields
+    )
+{
+    fields.clear();
+    std::string_view::size_type pos = 0;
+    while(pos < line.size())
+        {
+        auto const tab = line.find('\t', pos);
+        if(std::string_view::npos == tab)
+            {
+            fields.push_back(line.substr(pos));
+            break;
+            }
+        fields.push_back(line.substr(pos, tab - pos));
+        pos = tab + 1;
+        }
+}
+
 /// Escape text for html, e.g., "a < b" --> "a &lt; b".
 
 std::string htmlize(std::string const& raw_text)
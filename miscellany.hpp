@@ -36,6 +36,7 @@
 #include <limits>                       // numeric_limits
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -158,6 +159,11 @@ LMI_SO int count_newlines(std::string const&);
 
 LMI_SO std::vector<std::string> split_into_lines(std::string const&);
 
+LMI_SO void split_fields
+    (std::string_view               line
+    ,std::vector<std::string_view>& fields
+    );
+
 std::string htmlize(std::string const&);
 
 LMI_SO bool begins_with(std::string const& s, std::string const& prefix);
@@ -33,6 +33,8 @@
 #include <iomanip>
 #include <limits>
 #include <sstream>
+#include <string_view>
+#include <vector>
 
 void test_each_equal()
 {
@@ -424,6 +426,27 @@ void test_trimming()
     LMI_TEST_EQUAL(s, "a ; a");
 }
 
+void test_split_fields()
+{
+    using v = std::vector<std::string_view>;
+
+    v fields {"stale"};
+    split_fields("", fields);
+    LMI_TEST(v{} == fields);
+    // Empty fields are kept, except a final one.
+    split_fields("a\t\tb", fields);
+    LMI_TEST((v{"a", "", "b"}) == fields);
+    split_fields("a\tb\t", fields);
+    LMI_TEST((v{"a", "b"}) == fields);
+    split_fields("\ta", fields);
+    LMI_TEST((v{"", "a"}) == fields);
+    split_fields("\t", fields);
+    LMI_TEST((v{""}) == fields);
+    // Quotation marks are not special.
+    split_fields("\"a\tb\"\t'c'", fields);
+    LMI_TEST((v{"\"a", "b\"", "'c'"}) == fields);
+}
+
 void test_scoped_ios_format()
 {
     std::ostringstream oss;
@@ -532,6 +555,7 @@ int test_main(int, char*[])
     test_prefix_and_suffix();
     test_scale_power();
     test_trimming();
+    test_split_fields();
     test_scoped_ios_format();
     test_stifle_unused_warning();
 
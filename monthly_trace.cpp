@@ -0,0 +1,332 @@
+// Detailed monthly trace: columns, markers, and formatting.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "monthly_trace.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "mc_enum_types.hpp"
+#include "mc_enum_types_aux.hpp"        // mc_str()
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "value_cast.hpp"
+
+#include <algorithm>                    // copy()
+#include <bit>                          // bit_cast
+#include <cmath>                        // isnan()
+#include <cstdint>
+#include <cstring>                      // memcmp()
+#include <exception>
+#include <fstream>
+#include <ios>                          // ios_base, streamoff
+#include <istream>
+#include <iterator>                     // ostream_iterator
+#include <ostream>
+
+namespace
+{
+    std::vector<std::string> DebugColHeadersHelper()
+    {
+        std::vector<std::string> v(eLast);
+        v[eYear]                = "Year";
+        v[eMonth]               = "Month";
+        v[eBasis]               = "Basis for values";
+        v[eAge]                 = "Age";
+        v[eGenAcctBOMAV]        = "Unloaned BOM GA AV";
+        v[eSepAcctBOMAV]        = "Unloaned BOM SA AV";
+        v[eUnloanedBOMAV]       = "Unloaned BOM Tot AV";
+        v[eRegularLoanBOMAV]    = "Regular loan BOM AV";
+        v[ePrefLoanBOMAV]       = "Pref loan BOM AV";
+        v[eTotalBOMAV]          = "Total BOM AV";
+        v[eRegLoanBal]          = "Reg loan bal";
+        v[ePrefLoanBal]         = "Pref loan bal";
+        v[eDBOption]            = "DB option";
+        v[eSpecAmt]             = "Spec amt";
+        v[eCorridorFactor]      = "Corridor factor";
+        v[eDeathBft]            = "Death benefit";
+        v[eForceout]            = "Forceout";
+        v[eEePrem]              = "Ee prem";
+        v[eErPrem]              = "Er prem";
+        v[eTotalPrem]           = "Total prem";
+        v[eTargetPrem]          = "Target prem";
+        v[ePremiumLoad]         = "Prem load";
+        v[eSalesLoad]           = "Sales load";
+        v[ePremiumTaxLoad]      = "Prem tax load";
+        v[eDacTaxLoad]          = "DAC tax load";
+        v[eNetPrem]             = "Net prem";
+        v[ePolicyFees]          = "Policy fees";
+        v[eSpecAmtLoad]         = "Spec amt load";
+        v[eNAAR]                = "NAAR";
+        v[eCoiRate]             = "COI rate";
+        v[eCoiCharge]           = "COI charge";
+        v[eAdbRate]             = "ADD rate";
+        v[eAdbCharge]           = "ADD charge";
+        v[eWpRate]              = "WP rate";
+        v[eWpCharge]            = "WP charge";
+        v[eTermAmount]          = "Term amount";
+        v[eTermRate]            = "Term rate";
+        v[eTermCharge]          = "Term charge";
+        v[eTotalRiderCharges]   = "Total rider charges";
+        v[eTotalMonthlyDeds]    = "Total monthly deductions";
+        v[eGenAcctIntRate]      = "Unloaned GA interest rate";
+        v[eGenAcctIntCred]      = "Unloaned GA interest credited";
+        v[eSepAcctIntRate]      = "Unloaned SA interest rate";
+        v[eSepAcctIntCred]      = "Unloaned SA interest credited";
+        v[eAssetsPostBom]       = "Assets post BOM";
+        v[eCumPmtsPostBom]      = "Cumulative payments post BOM";
+        v[eSepAcctLoad]         = "Separate account load";
+        v[eRegLnIntRate]        = "Regular loan interest rate";
+        v[eRegLnIntCred]        = "Regular loan interest credited";
+        v[ePrfLnIntRate]        = "Pref loan interest rate";
+        v[ePrfLnIntCred]        = "Pref loan interest credited";
+        v[eYearsHMValueRate]    = "Honeymoon value rate";
+        v[eYearsPostHMRate]     = "Post honeymoon rate";
+        v[eRequestedWD]         = "Requested wd";
+        v[eMaxWD]               = "Max wd";
+        v[eGrossWD]             = "Gross wd";
+        v[eNetWD]               = "Net wd";
+        v[eRequestedLoan]       = "Requested loan";
+        v[eMaxLoan]             = "Max loan";
+        v[eNewLoan]             = "New loan";
+        v[eTaxBasis]            = "Tax basis";
+        v[eCumNoLapsePrem]      = "Cumulative no lapse prem";
+        v[eNoLapseActive]       = "No lapse active";
+        v[eEOMAV]               = "EOM AV";
+        v[eHMValue]             = "Honeymoon value";
+        v[eSurrChg]             = "EOM surrender charge";
+        v[eEOMCSVNet]           = "EOM CSV net";
+        v[eEOMCV7702]           = "EOM CV for 7702";
+        v[eInforceFactor]       = "Inforce factor";
+        v[eClaimsPaid]          = "Partial mort claims paid";
+        v[e7702ATestDur]        = "7702A test duration";
+        v[e7702A7ppRate]        = "7702A 7pp rate";
+        v[e7702ANsp]            = "7702A NSP";
+        v[e7702ALowestDb]       = "7702A lowest DB";
+        v[e7702ADeemedCv]       = "7702A deemed CV";
+        v[e7702ANetMaxNecPm]    = "7702A net max nec prem";
+        v[e7702AGrossMaxNecPm]  = "7702A gross max nec prem";
+        v[e7702AUnnecPm]        = "7702A unnec prem";
+        v[e7702ADbAdj]          = "7702A DB adjustment";
+        v[e7702A7pp]            = "7702A 7pp";
+        v[e7702ACum7pp]         = "7702A cumulative 7pp";
+        v[e7702AAmountsPaid]    = "7702A amounts paid";
+        v[e7702AIsMec]          = "Is MEC";
+        v[eGLP]                 = "GLP";
+        v[eCumGLP]              = "Cumulative GLP";
+        v[eGSP]                 = "GSP";
+        v[e7702PremiumsPaid]    = "7702 premiums paid";
+
+        return v;
+    }
+
+    /// Header of a raw monthly-trace file.
+    ///
+    /// A raw trace is written in native byte order, and is meant to
+    /// be formatted on the machine that wrote it. After the header
+    /// come zero or more blocks, one per basis, each consisting of an
+    /// int32 row count followed by that many rows of 'eLast' doubles.
+
+    char const raw_trace_magic[8] = {'l', 'm', 'i', 't', 'r', 'a', 'c', 'e'};
+    std::int32_t const raw_trace_version = 1;
+
+    // Quiet NaNs whose payloads distinguish the two markers. Copying
+    // a double, or writing and reading it back, preserves its bits.
+
+    std::uint64_t const empty_bits          {0x7ff8'0000'0000'0001};
+    std::uint64_t const not_applicable_bits {0x7ff8'0000'0000'0002};
+} // Unnamed namespace.
+
+/// Headers for monthly output.
+
+std::vector<std::string> const& DebugColHeaders()
+{
+    static std::vector<std::string> const v(DebugColHeadersHelper());
+    return v;
+}
+
+/// Marker for a column that has not been set in a given month.
+///
+/// Every row starts out filled with this value; it is formatted as
+/// "EMPTY", so that a column someone forgot to set is conspicuous.
+
+double monthly_trace_empty()
+{
+    return std::bit_cast<double>(empty_bits);
+}
+
+/// Marker for a column that is not applicable in a given month.
+///
+/// Formatted as "---".
+
+double monthly_trace_not_applicable()
+{
+    return std::bit_cast<double>(not_applicable_bits);
+}
+
+void write_monthly_trace_headers(std::ostream& os)
+{
+    std::copy
+        (DebugColHeaders().begin()
+        ,DebugColHeaders().end()
+        ,std::ostream_iterator<std::string>(os, "\t")
+        );
+    os << '\n';
+}
+
+/// Format raw rows exactly as the former string-based trace did.
+
+void write_monthly_trace_rows(std::ostream& os, double const* p, int rows)
+{
+    LMI_ASSERT(0 <= rows);
+    for(int r = 0; r < rows; ++r)
+        {
+        for(int c = 0; c < eLast; ++c, ++p)
+            {
+            if(std::isnan(*p))
+                {
+                os << (not_applicable_bits == std::bit_cast<std::uint64_t>(*p) ? "---" : "EMPTY");
+                }
+            else if(eBasis == c)
+                {
+                os << mc_str(static_cast<mcenum_run_basis>(static_cast<int>(*p)));
+                }
+            else if(eDBOption == c)
+                {
+                os << mc_str(static_cast<mcenum_dbopt>(static_cast<int>(*p)));
+                }
+            else
+                {
+                os << value_cast<std::string>(*p);
+                }
+            os << '\t';
+            }
+        os << '\n';
+        }
+    // A blank line separates bases.
+    os << '\n';
+}
+
+void write_raw_monthly_trace_header(std::ostream& os)
+{
+    std::int32_t const columns {eLast};
+    os.write(raw_trace_magic, sizeof raw_trace_magic);
+    os.write(reinterpret_cast<char const*>(&raw_trace_version), sizeof raw_trace_version);
+    os.write(reinterpret_cast<char const*>(&columns), sizeof columns);
+}
+
+void write_raw_monthly_trace_rows(std::ostream& os, double const* p, int rows)
+{
+    LMI_ASSERT(0 <= rows);
+    std::int32_t const n {rows};
+    os.write(reinterpret_cast<char const*>(&n), sizeof n);
+    os.write
+        (reinterpret_cast<char const*>(p)
+        ,static_cast<std::streamsize>(rows) * eLast * static_cast<std::streamsize>(sizeof(double))
+        );
+}
+
+/// Format a raw monthly trace as tab-delimited text.
+///
+/// The result is identical to what would have been written directly
+/// had the "idiosyncrasyZ" trace been requested instead.
+
+void format_monthly_trace(std::istream& is, std::ostream& os)
+{
+    char magic[sizeof raw_trace_magic];
+    std::int32_t version {};
+    std::int32_t columns {};
+    is.read(magic, sizeof magic);
+    is.read(reinterpret_cast<char*>(&version), sizeof version);
+    is.read(reinterpret_cast<char*>(&columns), sizeof columns);
+    if
+        (  !is
+        || 0 != std::memcmp(magic, raw_trace_magic, sizeof magic)
+        || raw_trace_version != version
+        || eLast != columns
+        )
+        {
+        alarum()
+            << "Not a raw monthly trace written by this version of the program."
+            << LMI_FLUSH
+            ;
+        }
+
+    // Each row count is checked against the bytes that remain before
+    // any storage is allocated for its rows.
+    std::istream::pos_type const here = is.tellg();
+    is.seekg(0, std::ios_base::end);
+    std::istream::pos_type const end = is.tellg();
+    is.seekg(here);
+    if(!is || std::istream::pos_type(-1) == here || std::istream::pos_type(-1) == end)
+        {
+        alarum() << "Unable to determine size of raw monthly trace." << LMI_FLUSH;
+        }
+    std::streamoff remaining = end - here;
+    std::streamoff const row_size = eLast * static_cast<std::streamoff>(sizeof(double));
+
+    write_monthly_trace_headers(os);
+    std::vector<double> block;
+    for(std::int32_t rows {}; is.read(reinterpret_cast<char*>(&rows), sizeof rows);)
+        {
+        if(rows < 0)
+            {
+            alarum() << "Raw monthly trace is corrupt." << LMI_FLUSH;
+            }
+        remaining -= static_cast<std::streamoff>(sizeof rows);
+        if(remaining / row_size < rows)
+            {
+            alarum() << "Raw monthly trace is truncated." << LMI_FLUSH;
+            }
+        remaining -= rows * row_size;
+        block.resize(static_cast<std::size_t>(rows) * eLast);
+        is.read
+            (reinterpret_cast<char*>(block.data())
+            ,static_cast<std::streamsize>(block.size() * sizeof(double))
+            );
+        if(!is)
+            {
+            alarum() << "Raw monthly trace is truncated." << LMI_FLUSH;
+            }
+        write_monthly_trace_rows(os, block.data(), rows);
+        }
+}
+
+void format_monthly_trace
+    (std::string const& raw_filename
+    ,std::string const& tsv_filename
+    )
+{
+    std::ifstream is(raw_filename.c_str(), ios_in_binary());
+    if(!is)
+        {
+        alarum() << "Unable to open '" << raw_filename << "'." << LMI_FLUSH;
+        }
+    std::ofstream os(tsv_filename.c_str(), ios_out_trunc_binary());
+    try
+        {
+        format_monthly_trace(is, os);
+        }
+    catch(std::exception const& e)
+        {
+        alarum() << "'" << raw_filename << "': " << e.what() << LMI_FLUSH;
+        }
+}
@@ -0,0 +1,145 @@
+// Detailed monthly trace: columns, markers, and formatting.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef monthly_trace_hpp
+#define monthly_trace_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Columns can be rearranged by changing the order of enumerators.
+
+enum DebugColNames
+    {eYear
+    ,eMonth
+    ,eBasis
+    ,eAge
+    ,eGenAcctBOMAV
+    ,eSepAcctBOMAV
+    ,eUnloanedBOMAV
+    ,eRegularLoanBOMAV
+    ,ePrefLoanBOMAV
+    ,eTotalBOMAV
+    ,eRegLoanBal
+    ,ePrefLoanBal
+    ,eDBOption
+    ,eSpecAmt
+    ,eCorridorFactor
+    ,eDeathBft
+    ,eForceout
+    ,eEePrem
+    ,eErPrem
+    ,eTotalPrem
+    ,eTargetPrem
+    ,ePremiumLoad
+    ,eSalesLoad
+    ,ePremiumTaxLoad
+    ,eDacTaxLoad
+    ,eNetPrem
+    ,ePolicyFees
+    ,eSpecAmtLoad
+    ,eNAAR
+    ,eCoiRate
+    ,eCoiCharge
+    ,eAdbRate
+    ,eAdbCharge
+    ,eWpRate
+    ,eWpCharge
+    ,eTermAmount
+    ,eTermRate
+    ,eTermCharge
+    ,eTotalRiderCharges
+    ,eTotalMonthlyDeds
+    ,eGenAcctIntRate
+    ,eGenAcctIntCred
+    ,eSepAcctIntRate
+    ,eSepAcctIntCred
+    ,eAssetsPostBom
+    ,eCumPmtsPostBom
+    ,eSepAcctLoad
+    ,eRegLnIntRate
+    ,eRegLnIntCred
+    ,ePrfLnIntRate
+    ,ePrfLnIntCred
+    ,eYearsHMValueRate
+    ,eYearsPostHMRate
+    ,eRequestedWD
+    ,eMaxWD
+    ,eGrossWD
+    ,eNetWD
+    ,eRequestedLoan
+    ,eMaxLoan
+    ,eNewLoan
+    ,eTaxBasis
+    ,eCumNoLapsePrem
+    ,eNoLapseActive
+    ,eEOMAV
+    ,eHMValue
+    ,eSurrChg
+    ,eEOMCSVNet
+    ,eEOMCV7702
+    ,eInforceFactor
+    ,eClaimsPaid
+    ,e7702ATestDur
+    ,e7702A7ppRate
+    ,e7702ANsp
+    ,e7702ALowestDb
+    ,e7702ADeemedCv
+    ,e7702ANetMaxNecPm
+    ,e7702AGrossMaxNecPm
+    ,e7702AUnnecPm
+    ,e7702ADbAdj
+    ,e7702A7pp
+    ,e7702ACum7pp
+    ,e7702AAmountsPaid
+    ,e7702AIsMec
+    ,eGLP
+    ,eCumGLP
+    ,eGSP
+    ,e7702PremiumsPaid
+    // Insert new enumerators above
+    ,eLast
+    };
+
+std::vector<std::string> const& DebugColHeaders();
+
+double monthly_trace_empty();
+double monthly_trace_not_applicable();
+
+void write_monthly_trace_headers(std::ostream&);
+void write_monthly_trace_rows(std::ostream&, double const*, int rows);
+
+void write_raw_monthly_trace_header(std::ostream&);
+void write_raw_monthly_trace_rows(std::ostream&, double const*, int rows);
+
+void format_monthly_trace(std::istream& raw, std::ostream& tsv);
+
+LMI_SO void format_monthly_trace
+    (std::string const& raw_filename
+    ,std::string const& tsv_filename
+    );
+
+#endif // monthly_trace_hpp
@@ -0,0 +1,152 @@
+// Detailed monthly trace--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "monthly_trace.hpp"
+
+#include "mc_enum_types.hpp"
+#include "test_tools.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Two rows such as AccountValue::DebugPrint() might record.
+
+std::vector<double> sample_rows()
+{
+    std::vector<double> v(2 * eLast, monthly_trace_empty());
+    double* r = v.data();
+    r[eYear]         = 0;
+    r[eMonth]        = 0;
+    r[eBasis]        = mce_run_gen_curr_sep_full;
+    r[eDBOption]     = mce_option2;
+    r[eSpecAmt]      = 1000000;
+    r[eCoiRate]      = 0.000123;
+    r[eRequestedWD]  = monthly_trace_not_applicable();
+    r += eLast;
+    r[eYear]         = 0;
+    r[eMonth]        = 1;
+    r[eBasis]        = mce_run_gen_guar_sep_zero;
+    r[eEOMAV]        = -2.5;
+    return v;
+}
+} // Unnamed namespace.
+
+/// Formatting a raw trace gives the same text as writing it directly.
+
+void test_round_trip()
+{
+    std::vector<double> const v {sample_rows()};
+
+    std::ostringstream text;
+    write_monthly_trace_headers(text);
+    write_monthly_trace_rows(text, v.data(), 2);
+    write_monthly_trace_rows(text, v.data(), 1);
+    write_monthly_trace_rows(text, v.data(), 0);
+
+    std::stringstream raw;
+    write_raw_monthly_trace_header(raw);
+    write_raw_monthly_trace_rows(raw, v.data(), 2);
+    write_raw_monthly_trace_rows(raw, v.data(), 1);
+    write_raw_monthly_trace_rows(raw, v.data(), 0);
+
+    std::ostringstream formatted;
+    format_monthly_trace(raw, formatted);
+    LMI_TEST_EQUAL(text.str(), formatted.str());
+
+    // Unset and inapplicable columns remain distinct.
+    std::string const s {text.str()};
+    LMI_TEST(std::string::npos != s.find("\tEMPTY\t"));
+    LMI_TEST(std::string::npos != s.find("\t---\t"));
+    LMI_TEST(std::string::npos != s.find("\t1000000\t"));
+    LMI_TEST(std::string::npos != s.find("\t-2.5\t"));
+}
+
+/// Damaged raw traces are rejected.
+
+void test_malformed()
+{
+    std::vector<double> const v {sample_rows()};
+    std::ostringstream os;
+
+    std::stringstream not_a_trace("This is not a raw monthly trace.");
+    LMI_TEST_THROW
+        (format_monthly_trace(not_a_trace, os)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Not a raw monthly trace")
+        );
+
+    std::stringstream negative;
+    write_raw_monthly_trace_header(negative);
+    std::int32_t const n {-1};
+    negative.write(reinterpret_cast<char const*>(&n), sizeof n);
+    LMI_TEST_THROW
+        (format_monthly_trace(negative, os)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Raw monthly trace is corrupt")
+        );
+
+    std::stringstream truncated;
+    write_raw_monthly_trace_header(truncated);
+    write_raw_monthly_trace_rows(truncated, v.data(), 2);
+    std::string t {truncated.str()};
+    t.resize(t.size() - sizeof(double));
+    truncated.str(t);
+    LMI_TEST_THROW
+        (format_monthly_trace(truncated, os)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Raw monthly trace is truncated")
+        );
+
+    // A row count that the remaining bytes can't hold is rejected
+    // before any storage is allocated for it.
+    std::stringstream huge;
+    write_raw_monthly_trace_header(huge);
+    std::int32_t const m {std::numeric_limits<std::int32_t>::max()};
+    huge.write(reinterpret_cast<char const*>(&m), sizeof m);
+    huge.write(reinterpret_cast<char const*>(v.data()), sizeof(double));
+    LMI_TEST_THROW
+        (format_monthly_trace(huge, os)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Raw monthly trace is truncated")
+        );
+
+    LMI_TEST_THROW
+        (write_raw_monthly_trace_rows(os, v.data(), -1)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Assertion .* failed")
+        );
+}
+
+int test_main(int, char*[])
+{
+    test_round_trip();
+    test_malformed();
+    return 0;
+}
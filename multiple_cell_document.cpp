@@ -25,6 +25,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "binary_census.hpp"
 #include "data_directory.hpp"           // AddDataDir()
 #include "ssize_lmi.hpp"
 #include "value_cast.hpp"
@@ -59,13 +60,21 @@ multiple_cell_document::multiple_cell_document()
 
 /// Construct from filename.
 ///
+/// The file may be xml, or a binary census (see class binary_census),
+/// which is recognized by its content rather than its extension.
+///
 /// Postconditions established by parse(): Case, class, and cell
 /// parameters are of sizes {==1, >=1, >=1) respectively.
 ///
-/// Postconditions: established by parse().
+/// Postconditions: established by parse() or parse_binary().
 
 multiple_cell_document::multiple_cell_document(std::string const& filename)
 {
+    if(binary_census::is_binary_census(filename))
+        {
+        parse_binary(filename);
+        return;
+        }
     xml_lmi::dom_parser parser(filename);
     parse(parser);
 }
@@ -186,6 +195,34 @@ void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
     assert_vector_sizes_are_sane();
 }
 
+/// Read a binary census into vectors of class Input.
+///
+/// Calls assert_vector_sizes_are_sane() to assert postconditions.
+
+void multiple_cell_document::parse_binary(fs::path const& filename)
+{
+    binary_census const census(filename);
+
+    case_parms_ .clear();
+    class_parms_.clear();
+    cell_parms_ .clear();
+
+    case_parms_.push_back(census.case_default());
+    class_parms_.reserve(census.classes_count());
+    for(int j = 0; j < census.classes_count(); ++j)
+        {
+        class_parms_.push_back(census.class_default(j));
+        }
+    cell_parms_.reserve(census.cells_count());
+    for(int j = 0; j < census.cells_count(); ++j)
+        {
+        cell_parms_.push_back(census.cell(j));
+        }
+    status() << "Read " << census.cells_count() << " cells." << std::flush;
+
+    assert_vector_sizes_are_sane();
+}
+
 /// Parse obsolete version 0 xml (for backward compatibility).
 ///
 /// Calls assert_vector_sizes_are_sane() to assert postconditions.
@@ -533,3 +570,13 @@ void multiple_cell_document::write(std::ostream& os) const
 
     os << document;
 }
+
+/// Write to binary census file.
+///
+/// Calls assert_vector_sizes_are_sane() to assert preconditions.
+
+void multiple_cell_document::write_binary(fs::path const& filename) const
+{
+    assert_vector_sizes_are_sane();
+    binary_census::write(filename, case_parms_[0], class_parms_, cell_parms_);
+}
@@ -25,6 +25,7 @@
 #include "config.hpp"
 
 #include "input.hpp"
+#include "path.hpp"
 #include "so_attributes.hpp"
 #include "xml_lmi_fwd.hpp"
 
@@ -74,6 +75,9 @@
 /// case-default employee class; users have not asked for a command to
 /// add a new cell copied from a selection of class defaults, although
 /// that could of course be implemented.
+///
+/// The same document may alternatively be stored in the compact form
+/// described with class binary_census.
 
 class LMI_SO multiple_cell_document final
 {
@@ -94,11 +98,14 @@ class LMI_SO multiple_cell_document final
     void read(std::istream const&);
     void write(std::ostream&) const;
 
+    void write_binary(fs::path const&) const;
+
   private:
     multiple_cell_document(multiple_cell_document const&) = delete;
     multiple_cell_document& operator=(multiple_cell_document const&) = delete;
 
     void parse   (xml_lmi::dom_parser const&);
+    void parse_binary(fs::path const&);
     void parse_v0(xml_lmi::dom_parser const&);
 
     void assert_vector_sizes_are_sane() const;
@@ -42,10 +42,13 @@ using std::filesystem::filesystem_error;
 
 using std::filesystem::create_directory;
 using std::filesystem::exists;
+using std::filesystem::file_size;
 using std::filesystem::is_directory;
 using std::filesystem::last_write_time;
 using std::filesystem::remove;
+using std::filesystem::remove_all;
 using std::filesystem::rename;
+using std::filesystem::temp_directory_path;
 
 /// Class representing the file system path.
 ///
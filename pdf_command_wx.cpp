@@ -44,6 +44,7 @@
 #include "ssize_lmi.hpp"
 #include "wx_new.hpp"
 #include "wx_table_generator.hpp"
+#include "wx_utility.hpp"               // CallOnGuiThread()
 
 #include <wx/pdfdc.h>
 
@@ -3236,7 +3237,7 @@ class pdf_illustration_reg_d_indiv : public pdf_illustration
 
 namespace
 {
-void concrete_pdf_command(Ledger const& ledger, fs::path const& pdf_out_file)
+void render_pdf(Ledger const& ledger, fs::path const& pdf_out_file)
 {
     wxBusyCursor reverie;
 
@@ -3262,5 +3263,13 @@ void concrete_pdf_command(Ledger const& ledger, fs::path const& pdf_out_file)
         }
 }
 
+/// Census runs may be performed on a worker thread, but wx is not
+/// thread-safe, so render on the GUI thread.
+
+void concrete_pdf_command(Ledger const& ledger, fs::path const& pdf_out_file)
+{
+    CallOnGuiThread([&] {render_pdf(ledger, pdf_out_file);});
+}
+
 bool volatile ensure_setup = pdf_command_initialize(concrete_pdf_command);
 } // Unnamed namespace.
@@ -0,0 +1,254 @@
+// Render pdf illustrations in helper processes.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "pdf_render_pool.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "ledger.hpp"
+#include "ledger_image.hpp"
+#include "miscellany.hpp"               // iso_8601_datestamp_terse()
+#include "pdf_command.hpp"
+#include "system_command.hpp"
+
+#include <exception>
+#include <system_error>                 // error_code
+
+namespace
+{
+std::mutex  helper_mutex;
+std::string helper_command;
+int         helper_processes {0};
+
+/// Create a directory for job files in the system's temporary
+/// directory. Creation fails if the name is taken, so a directory
+/// returned here belongs to the caller alone.
+
+fs::path make_job_directory()
+{
+    fs::path const temp {fs::temp_directory_path()};
+    std::string const stem = "lmi-pdf-" + iso_8601_datestamp_terse() + "-";
+    for(int j = 0; j < 1000; ++j)
+        {
+        fs::path const z = temp / (stem + std::to_string(j));
+        if(fs::create_directory(z))
+            {
+            return z;
+            }
+        }
+    alarum()
+        << "Unable to create a directory for pdf jobs in "
+        << temp
+        << "."
+        << LMI_FLUSH
+        ;
+    return fs::path();
+}
+} // Unnamed namespace.
+
+pdf_render_pool::~pdf_render_pool()
+{
+    stop();
+}
+
+/// Set the command that starts a helper process, and the number of
+/// helpers to run at once. Zero processes disables the pool.
+///
+/// The command must name a command-line lmi program, along with any
+/// options, such as '--data_path', that the helper needs in order to
+/// render exactly as the calling process does.
+
+void pdf_render_pool::set_helper(std::string const& command, int n_processes)
+{
+    LMI_ASSERT(0 <= n_processes);
+    std::lock_guard<std::mutex> lock(helper_mutex);
+    helper_command   = command;
+    helper_processes = n_processes;
+}
+
+bool pdf_render_pool::enabled()
+{
+    std::lock_guard<std::mutex> lock(helper_mutex);
+    return 0 < helper_processes && !helper_command.empty();
+}
+
+/// Arguments that make a helper render one ledger image as a pdf.
+///
+/// The command-line program passes the values of these options to
+/// render().
+
+std::string pdf_render_pool::helper_arguments
+    (fs::path const& image_file
+    ,fs::path const& pdf_out_file
+    )
+{
+    return
+          " --render_pdf=\"" + image_file.string() + "\""
+        + " --pdf_file=\"" + pdf_out_file.string() + "\""
+        ;
+}
+
+/// Render a ledger image as a pdf, in a helper process.
+///
+/// The ledger is scaled here, as write_ledger_as_pdf() would scale
+/// it, so the image is of the unscaled ledger.
+
+void pdf_render_pool::render
+    (fs::path const& image_file
+    ,fs::path const& pdf_out_file
+    )
+{
+    Ledger ledger {ledger_image(image_file).ledger()};
+    ledger.AutoScale();
+    pdf_command(ledger, pdf_out_file);
+}
+
+/// Queue one ledger's pdf for rendering by a helper process.
+///
+/// The caller chooses the pdf's name, as write_ledger_as_pdf() would.
+/// The ledger is written as an image to this pool's job directory,
+/// which is created upon the first submission.
+
+void pdf_render_pool::submit(Ledger const& ledger, fs::path const& pdf_out_file)
+{
+    LMI_ASSERT(enabled());
+    throw_if_interdicted(ledger);
+
+    if(job_directory_.empty())
+        {
+        job_directory_ = make_job_directory();
+        }
+    fs::path const image_file =
+        job_directory_ / (std::to_string(n_submitted_++) + ".ledger");
+    ledger_image::write(ledger, image_file);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    LMI_ASSERT(!closed_);
+    jobs_.push_back({image_file, fs::absolute(pdf_out_file)});
+    if(threads_.empty())
+        {
+        int n_processes = 0;
+        {
+        std::lock_guard<std::mutex> helper_lock(helper_mutex);
+        n_processes = helper_processes;
+        }
+        threads_.reserve(n_processes);
+        for(int j = 0; j < n_processes; ++j)
+            {
+            threads_.emplace_back(&pdf_render_pool::work, this);
+            }
+        }
+    wakeup_.notify_one();
+}
+
+/// Wait until every queued pdf has been rendered.
+///
+/// A helper's failure doesn't stop the others, but is reported here,
+/// once all are done.
+
+void pdf_render_pool::finish()
+{
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    }
+    wakeup_.notify_all();
+    for(auto& t : threads_)
+        {
+        t.join();
+        }
+    threads_.clear();
+
+    if(!errors_.empty())
+        {
+        alarum()
+            << errors_.size()
+            << " pdf file(s) could not be rendered. First error:\n"
+            << errors_.front()
+            << LMI_FLUSH
+            ;
+        }
+}
+
+/// Render queued pdfs, one at a time, until the queue is closed and
+/// empty. Each job file is removed once its helper has finished.
+
+void pdf_render_pool::work()
+{
+    for(;;)
+        {
+        job j;
+        std::string command;
+        {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait(lock, [this] {return closed_ || !jobs_.empty();});
+        if(jobs_.empty())
+            {
+            return;
+            }
+        j = jobs_.front();
+        jobs_.pop_front();
+        }
+        {
+        std::lock_guard<std::mutex> lock(helper_mutex);
+        command = helper_command;
+        }
+
+        try
+            {
+            system_command(command + helper_arguments(j.image_file, j.pdf_out_file));
+            }
+        catch(std::exception const& e)
+            {
+            std::lock_guard<std::mutex> lock(mutex_);
+            errors_.push_back(e.what());
+            }
+        std::error_code ec;
+        fs::remove(j.image_file, ec);
+        }
+}
+
+/// Abandon any pdfs not yet begun, and wait for the rest, e.g. when
+/// a census run is cancelled. Then remove the job directory.
+
+void pdf_render_pool::stop()
+{
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    jobs_.clear();
+    }
+    wakeup_.notify_all();
+    for(auto& t : threads_)
+        {
+        t.join();
+        }
+    threads_.clear();
+
+    if(!job_directory_.empty())
+        {
+        std::error_code ec;
+        fs::remove_all(job_directory_, ec);
+        }
+}
@@ -0,0 +1,104 @@
+// Render pdf illustrations in helper processes.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef pdf_render_pool_hpp
+#define pdf_render_pool_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Ledger;
+
+/// Render pdf illustrations in helper processes.
+///
+/// Rendering a pdf takes much longer than calculating the ledger it
+/// shows, and cannot be done on several threads at once because the
+/// pdf code relies on wx. Instead, each ledger is written as a
+/// ledger_image to a temporary directory that belongs to the pool,
+/// and a helper process (a copy of the command-line program) renders
+/// that image while the calling process goes on to the next cell.
+/// Several helpers run concurrently, each driven by one thread of
+/// this pool. Because helpers don't recalculate anything, any ledger,
+/// including a composite, can be rendered this way.
+///
+/// The calling process chooses each pdf's name, in census order,
+/// just as write_ledger_as_pdf() would, and passes it to a helper,
+/// so output names are the same as for serial rendering.
+///
+/// The helper protocol is defined here: helper_arguments() is what
+/// the pool appends to the helper command, and render() is what the
+/// helper does with those arguments.
+///
+/// The pool is used only if set_helper() has been called with a
+/// positive number of processes: by default, nothing changes.
+
+class LMI_SO pdf_render_pool final
+{
+  public:
+    pdf_render_pool() = default;
+    ~pdf_render_pool();
+
+    static void set_helper(std::string const& command, int n_processes);
+    static bool enabled();
+
+    static std::string helper_arguments
+        (fs::path const& image_file
+        ,fs::path const& pdf_out_file
+        );
+    static void render(fs::path const& image_file, fs::path const& pdf_out_file);
+
+    void submit(Ledger const&, fs::path const& pdf_out_file);
+    void finish();
+
+  private:
+    pdf_render_pool(pdf_render_pool const&) = delete;
+    pdf_render_pool& operator=(pdf_render_pool const&) = delete;
+
+    struct job
+    {
+        fs::path image_file;
+        fs::path pdf_out_file;
+    };
+
+    void work();
+    void stop();
+
+    fs::path                 job_directory_;
+    int                      n_submitted_ {0};
+    std::vector<std::thread> threads_;
+    std::mutex               mutex_;
+    std::condition_variable  wakeup_;
+    std::deque<job>          jobs_;
+    std::vector<std::string> errors_;
+    bool                     closed_ {false};
+};
+
+#endif // pdf_render_pool_hpp
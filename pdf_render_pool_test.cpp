@@ -0,0 +1,224 @@
+// Render pdf illustrations in helper processes--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "pdf_render_pool.hpp"
+
+#include "alert.hpp"
+#include "istream_to_string.hpp"
+#include "ledger.hpp"
+#include "ledger_image.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "miscellany.hpp"               // ios_out_trunc_binary()
+#include "path.hpp"
+#include "pdf_command.hpp"
+#include "ssize_lmi.hpp"
+#include "test_tools.hpp"
+
+#include <algorithm>                    // sort()
+#include <cstdlib>                      // exit()
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void authenticate_system() {} // Do-nothing stub.
+
+namespace
+{
+/// Stand-in for the wx pdf writer: write the ledger's image instead.
+
+void write_image_as_pdf(Ledger const& ledger, fs::path const& pdf_out_file)
+{
+    std::string const z = ledger_image::image(ledger);
+    fs::ofstream ofs(pdf_out_file, ios_out_trunc_binary());
+    ofs << z;
+    if(!ofs)
+        {
+        alarum() << "Unable to write file " << pdf_out_file << "." << LMI_FLUSH;
+        }
+}
+
+bool volatile ensure_setup = pdf_command_initialize(write_image_as_pdf);
+
+/// An unscaled ledger, as a census run would emit it.
+
+Ledger sample_ledger(double premium)
+{
+    Ledger ledger(50, mce_ill_reg, false, false, false);
+    LedgerInvariant invar(50);
+    invar.GrossPmt.assign(50, premium);
+    invar.SpecAmt .assign(50, 1.0e8);
+    invar.ProductName = "sample";
+    ledger.SetLedgerInvariant(invar);
+    LedgerVariant curr(ledger.GetCurrFull());
+    for(int j = 0; j < 50; ++j)
+        {
+        curr.AcctVal[j] = 12345.0 * j * premium;
+        }
+    ledger.SetOneLedgerVariant(mce_run_gen_curr_sep_full, curr);
+    return ledger;
+}
+
+/// What the stand-in writes for a ledger rendered in this process.
+
+std::string expected_pdf(double premium)
+{
+    Ledger ledger {sample_ledger(premium)};
+    ledger.AutoScale();
+    return ledger_image::image(ledger);
+}
+
+std::string file_contents(fs::path const& p)
+{
+    fs::ifstream ifs(p, ios_in_binary());
+    std::string z;
+    istream_to_string(ifs, z);
+    return z;
+}
+
+std::vector<std::string> files_in(fs::path const& directory)
+{
+    std::vector<std::string> z;
+    for(auto const& i : fs::directory_iterator(directory))
+        {
+        z.push_back(fs::path(i.path()).filename().string());
+        }
+    std::sort(z.begin(), z.end());
+    return z;
+}
+} // Unnamed namespace.
+
+/// Render a ledger as a helper would, without any helper process.
+
+void test_render(fs::path const& dir)
+{
+    fs::path const image_file = dir / "render.ledger";
+    fs::path const pdf_file   = dir / "render.pdf";
+    ledger_image::write(sample_ledger(1000.0), image_file);
+    pdf_render_pool::render(image_file, pdf_file);
+    LMI_TEST(expected_pdf(1000.0) == file_contents(pdf_file));
+    fs::remove(image_file);
+    fs::remove(pdf_file);
+}
+
+/// Render several ledgers in helper processes, which are copies of
+/// this program: see test_main().
+///
+/// Each pdf is written exactly where the caller wanted it, and no job
+/// file is left beside it.
+
+void test_pool(fs::path const& dir, std::string const& program)
+{
+    // This program's main() complains of the helper options, which
+    // only test_main() understands; silence that where possible.
+    std::string command {'"' + program + '"'};
+#if !defined LMI_MSW
+    command += " 2>/dev/null";
+#endif // !defined LMI_MSW
+    pdf_render_pool::set_helper(command, 2);
+    LMI_TEST(pdf_render_pool::enabled());
+
+    std::vector<double> const premiums {1000.0, 2000.0, 3000.0, 4000.0, 5000.0};
+    {
+    pdf_render_pool pool;
+    for(int j = 0; j < lmi::ssize(premiums); ++j)
+        {
+        fs::path const pdf_file = dir / ("cell" + std::to_string(j) + ".pdf");
+        pool.submit(sample_ledger(premiums[j]), pdf_file);
+        }
+    pool.finish();
+    }
+
+    std::vector<std::string> const files {files_in(dir)};
+    std::vector<std::string> const pdfs
+        {"cell0.pdf", "cell1.pdf", "cell2.pdf", "cell3.pdf", "cell4.pdf"};
+    LMI_TEST(pdfs == files);
+    for(int j = 0; j < lmi::ssize(premiums); ++j)
+        {
+        fs::path const pdf_file = dir / ("cell" + std::to_string(j) + ".pdf");
+        LMI_TEST(expected_pdf(premiums[j]) == file_contents(pdf_file));
+        fs::remove(pdf_file);
+        }
+
+    // A helper's failure is reported when the pool finishes.
+    {
+    pdf_render_pool pool;
+    pool.submit(sample_ledger(1000.0), dir / "no_such_directory" / "cell.pdf");
+    pool.submit(sample_ledger(2000.0), dir / "cell.pdf");
+    LMI_TEST_THROW
+        (pool.finish()
+        ,std::runtime_error
+        ,lmi_test::what_regex("^1 pdf file\\(s\\) could not be rendered")
+        );
+    }
+    LMI_TEST(expected_pdf(2000.0) == file_contents(dir / "cell.pdf"));
+    fs::remove(dir / "cell.pdf");
+
+    pdf_render_pool::set_helper(std::string(), 0);
+    LMI_TEST(!pdf_render_pool::enabled());
+}
+
+/// Unit test--or helper process, when invoked by a pool.
+///
+/// Only the options that the helper protocol specifies are given to
+/// a helper, as pdf_render_pool::helper_arguments() writes them.
+
+int test_main(int argc, char* argv[])
+{
+    std::string const render_option {"--render_pdf="};
+    std::string const file_option   {"--pdf_file="};
+    if
+        (  3 == argc
+        && 0 == std::string(argv[1]).find(render_option)
+        && 0 == std::string(argv[2]).find(file_option)
+        )
+        {
+        try
+            {
+            pdf_render_pool::render
+                (std::string(argv[1]).substr(render_option.size())
+                ,std::string(argv[2]).substr(file_option.size())
+                );
+            }
+        catch(std::exception const& e)
+            {
+            std::cerr << e.what() << std::endl;
+            std::exit(EXIT_FAILURE);
+            }
+        std::exit(EXIT_SUCCESS);
+        }
+
+    LMI_TEST_EQUAL
+        (" --render_pdf=\"a b.ledger\" --pdf_file=\"c d.pdf\""
+        ,pdf_render_pool::helper_arguments("a b.ledger", "c d.pdf")
+        );
+
+    fs::path const dir {"pdf_render_pool_test_dir"};
+    fs::remove_all(dir);
+    fs::create_directory(dir);
+    test_render(dir);
+    test_pool(fs::absolute(dir), fs::absolute(argv[0]).string());
+    fs::remove_all(dir);
+    return 0;
+}
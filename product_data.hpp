@@ -81,6 +81,7 @@ class LMI_SO product_data
     friend class BasicValues; // For antediluvian fork only.
     friend class PolicyDocument;
     friend class product_file_test;
+    friend class product_snapshot;
 
     typedef deserialized<product_data>::value_type value_type;
 
@@ -27,16 +27,21 @@
 #include "fund_data.hpp"
 #include "lingo.hpp"
 #include "product_data.hpp"
+#include "product_snapshot.hpp"
 #include "rounding_rules.hpp"
 #include "stratified_charges.hpp"
 // End of headers tested here.
 
 #include "data_directory.hpp"           // AddDataDir()
 #include "global_settings.hpp"
+#include "istream_to_string.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
 #include "path.hpp"
+#include "sample.hpp"                   // superior::lingo
 #include "test_tools.hpp"
 #include "timer.hpp"                    // TimeAnAliquot()
 
+#include <stdexcept>                    // runtime_error
 #include <string>
 #include <utility>                      // move()
 
@@ -49,12 +54,14 @@ class product_file_test
         global_settings::instance().set_data_directory("/opt/lmi/data");
         get_filenames();
         test_copying();
+        test_snapshot();
         assay_speed();
         }
 
   private:
     static void get_filenames();
     static void test_copying();
+    static void test_snapshot();
     static void assay_speed();
     static void read_database_file()   ;
     static void read_fund_file()       ;
@@ -63,6 +70,7 @@ class product_file_test
     static void read_rounding_file()   ;
     static void read_stratified_file() ;
     static void read_cached_files()    ;
+    static void read_snapshot()        ;
 
     inline static fs::path database_filename_   ;
     inline static fs::path fund_filename_       ;
@@ -132,6 +140,75 @@ void product_file_test::test_copying()
     LMI_TEST(      99 == g.query<int>(DB_MaxIncrAge));
 }
 
+/// Test that a snapshot reproduces the objects read from xml.
+///
+/// Compare the objects that the snapshot itself holds, rather than
+/// those retrieved from the file caches: loading a snapshot keeps any
+/// instance already cached for the same file, so the caches may well
+/// hold objects that were read from xml.
+
+void product_file_test::test_snapshot()
+{
+    fs::path const snapshot = product_snapshot::snapshot_filename("sample");
+    fs::remove(snapshot);
+    LMI_TEST(!product_snapshot::read("sample"));
+    LMI_TEST(!product_snapshot::load("sample"));
+
+    product_snapshot::write("sample");
+    LMI_TEST(fs::exists(snapshot));
+    LMI_TEST(product_snapshot::load("sample"));
+    auto const z = product_snapshot::read("sample");
+    LMI_TEST(z.has_value());
+
+    product_data const p(policy_filename_);
+    LMI_TEST(p.equals(*z->product));
+
+    DBDictionary const d(database_filename_);
+    LMI_TEST(d.equals(*z->database));
+
+    rounding_rules const r(rounding_filename_);
+    LMI_TEST(r.equals(*z->rounding));
+
+    stratified_charges const s(stratified_filename_);
+    LMI_TEST(s.equals(*z->strata));
+
+    FundData const f(fund_filename_);
+    auto const& g = z->funds;
+    LMI_TEST_EQUAL(f.GetNumberOfFunds(), g->GetNumberOfFunds());
+    for(int j = 0; j < f.GetNumberOfFunds(); ++j)
+        {
+        LMI_TEST_EQUAL(f.GetFundInfo(j).ScalarIMF(), g->GetFundInfo(j).ScalarIMF());
+        LMI_TEST_EQUAL(f.GetFundInfo(j).ShortName(), g->GetFundInfo(j).ShortName());
+        LMI_TEST_EQUAL(f.GetFundInfo(j).LongName (), g->GetFundInfo(j).LongName ());
+        }
+
+    lingo const l(lingo_filename_);
+    auto const& m = z->words;
+    for(int j = superior::empty_string; j <= superior::DefnSpecAmt; ++j)
+        {
+        LMI_TEST_EQUAL(l.lookup(j), m->lookup(j));
+        }
+
+    // A corrupt snapshot is an error.
+    std::string image;
+    {
+    fs::ifstream ifs(snapshot, ios_in_binary());
+    istream_to_string(ifs, image);
+    }
+    image.back() = static_cast<char>(~image.back());
+    {
+    fs::ofstream ofs(snapshot, ios_out_trunc_binary());
+    ofs << image;
+    }
+    LMI_TEST_THROW
+        (product_snapshot::load("sample")
+        ,std::runtime_error
+        ,lmi_test::what_regex("is corrupt")
+        );
+
+    product_snapshot::write("sample");
+}
+
 void product_file_test::read_database_file()
 {
     DBDictionary z(database_filename_);
@@ -172,6 +249,11 @@ void product_file_test::read_cached_files()
     stratified_charges ::read_via_cache(stratified_filename_);
 }
 
+void product_file_test::read_snapshot()
+{
+    product_snapshot::load("sample");
+}
+
 void product_file_test::assay_speed()
 {
     std::cout
@@ -183,6 +265,7 @@ void product_file_test::assay_speed()
         << "\n  Read 'rounding'   : " << TimeAnAliquot(read_rounding_file  )
         << "\n  Read 'stratified' : " << TimeAnAliquot(read_stratified_file)
         << "\n  Read all, cached' : " << TimeAnAliquot(read_cached_files   )
+        << "\n  Read snapshot     : " << TimeAnAliquot(read_snapshot       )
         << '\n'
         ;
 }
@@ -0,0 +1,688 @@
+// Precompiled binary snapshots of product files.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "product_snapshot.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "ce_product_name.hpp"
+#include "crc32.hpp"
+#include "data_directory.hpp"           // AddDataDir()
+#include "dbdict.hpp"
+#include "dbvalue.hpp"
+#include "fund_data.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
+#include "lingo.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "path_utility.hpp"             // fs::path inserter
+#include "product_data.hpp"
+#include "rounding_rules.hpp"
+#include "stratified_charges.hpp"
+
+#include <cstdint>
+#include <cstring>                      // memcmp(), memcpy()
+#include <mutex>
+#include <set>
+#include <string>                       // to_string()
+#include <type_traits>                  // is_arithmetic_v, is_same_v
+#include <vector>
+
+namespace
+{
+char const snapshot_magic[8] = {'l', 'm', 'i', 's', 'n', 'a', 'p', 's'};
+
+/// Increment whenever the payload's layout changes. A snapshot of any
+/// other version is treated as stale rather than as an error.
+
+std::uint32_t const snapshot_version = 2;
+
+struct snapshot_header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t crc;              // Of the payload only.
+    std::uint64_t payload_size;
+};
+
+static_assert(24 == sizeof(snapshot_header));
+
+std::int64_t file_time_ticks(fs::file_time_type t)
+{
+    return t.time_since_epoch().count();
+}
+
+unsigned int payload_crc(char const* data, std::size_t size)
+{
+    CRC z;
+    for(std::size_t j = 0; j < size; ++j)
+        {
+        z += data[j];
+        }
+    return z.value();
+}
+
+/// Files from which a product's objects are read, in snapshot order.
+///
+/// These are the very names by which the objects are cached: see
+/// product_database::initialize() and class BasicValues's ctors.
+
+std::vector<fs::path> source_files
+    (std::string  const& product_name
+    ,product_data const& p
+    )
+{
+    return
+        {fs::path(filename_from_product_name(product_name))
+        ,fs::path(AddDataDir(p.datum("DatabaseFilename")))
+        ,fs::path(AddDataDir(p.datum("LingoFilename"   )))
+        ,fs::path(AddDataDir(p.datum("FundFilename"    )))
+        ,fs::path(AddDataDir(p.datum("RoundingFilename")))
+        ,fs::path(AddDataDir(p.datum("TierFilename"    )))
+        };
+}
+} // Unnamed namespace.
+
+/// Serialize values into a snapshot's payload.
+
+class product_snapshot::writer
+{
+  public:
+    template<typename T>
+    void scalar(T t)
+        {
+        static_assert(std::is_arithmetic_v<T>);
+        payload_.append(reinterpret_cast<char const*>(&t), sizeof t);
+        }
+
+    void text(std::string const& s)
+        {
+        scalar<std::uint64_t>(s.size());
+        payload_.append(s);
+        }
+
+    template<typename T>
+    void array(std::vector<T> const& v)
+        {
+        static_assert(std::is_arithmetic_v<T>);
+        scalar<std::uint64_t>(v.size());
+        payload_.append
+            (reinterpret_cast<char const*>(v.data())
+            ,v.size() * sizeof(T)
+            );
+        }
+
+    void names(std::vector<std::string> const& v)
+        {
+        scalar<std::uint64_t>(v.size());
+        for(auto const& i : v)
+            {
+            text(i);
+            }
+        }
+
+    std::string const& payload() const {return payload_;}
+
+  private:
+    std::string payload_;
+};
+
+/// Deserialize values from a snapshot's payload.
+///
+/// Throws if the payload is shorter than its contents require.
+
+class product_snapshot::reader
+{
+  public:
+    reader(fs::path const& filename, char const* data, std::size_t size)
+        :filename_ {filename}
+        ,data_     {data}
+        ,size_     {size}
+        {
+        }
+
+    template<typename T>
+    T scalar()
+        {
+        static_assert(std::is_arithmetic_v<T>);
+        T z;
+        std::memcpy(&z, take(sizeof z), sizeof z);
+        return z;
+        }
+
+    std::string text()
+        {
+        std::size_t const n = count(1);
+        char const* p = take(n);
+        return std::string(p, n);
+        }
+
+    template<typename T>
+    std::vector<T> array()
+        {
+        static_assert(std::is_arithmetic_v<T>);
+        std::size_t const n = count(sizeof(T));
+        std::vector<T> z(n);
+        std::memcpy(z.data(), take(n * sizeof(T)), n * sizeof(T));
+        return z;
+        }
+
+    /// Read a list of member names, and test whether it is the
+    /// same as the given list. If it isn't, then the snapshot was
+    /// written by a build whose classes had different members.
+
+    bool names_match(std::vector<std::string> const& v)
+        {
+        std::size_t const n = count(sizeof(std::uint64_t));
+        bool z = n == v.size();
+        for(std::size_t j = 0; j < n; ++j)
+            {
+            std::string const name = text();
+            z = z && name == v[j];
+            }
+        return z;
+        }
+
+    bool exhausted() const {return size_ == position_;}
+
+  private:
+    /// Read an element count, and validate it against the size of
+    /// the remaining payload, so that it can't provoke a huge
+    /// allocation or an overflow.
+
+    std::size_t count(std::size_t element_size)
+        {
+        std::size_t const n = bourn_cast<std::size_t>(scalar<std::uint64_t>());
+        if((size_ - position_) / element_size < n)
+            {
+            truncated();
+            }
+        return n;
+        }
+
+    char const* take(std::size_t n)
+        {
+        if(size_ - position_ < n)
+            {
+            truncated();
+            }
+        char const* z = data_ + position_;
+        position_ += n;
+        return z;
+        }
+
+    [[noreturn]]
+    void truncated() const
+        {
+        alarum() << "Product snapshot " << filename_ << " is truncated." << LMI_FLUSH;
+        throw "Unreachable--silences a compiler diagnostic.";
+        }
+
+    fs::path const&   filename_;
+    char const* const data_;
+    std::size_t const size_;
+    std::size_t       position_ {0};
+};
+
+/// Name of the snapshot for the given product: a sibling of its
+/// '.policy' file.
+
+fs::path product_snapshot::snapshot_filename(std::string const& product_name)
+{
+    fs::path z(filename_from_product_name(product_name));
+    z.replace_extension(".snapshot");
+    return z;
+}
+
+/// Read a product's xml files, and write its snapshot.
+///
+/// Each file's write time is recorded before the file is read, so
+/// that any change made while the snapshot is being written makes
+/// it stale. The file is written under a temporary name and then
+/// renamed, so that a reader never sees a partial snapshot.
+
+void product_snapshot::write(std::string const& product_name)
+{
+    fs::path const policy_filename(filename_from_product_name(product_name));
+    auto const policy_time = fs::last_write_time(policy_filename);
+    product_data const p(policy_filename);
+
+    std::vector<fs::path> const sources = source_files(product_name, p);
+    writer w;
+    put(w, p);
+    for(auto const& i : sources)
+        {
+        auto const t = (i == policy_filename) ? policy_time : fs::last_write_time(i);
+        w.scalar<std::int64_t >(file_time_ticks(t));
+        w.scalar<std::uint64_t>(fs::file_size(i));
+        }
+    put(w, DBDictionary      (sources[1]));
+    put(w, lingo             (sources[2]));
+    put(w, FundData          (sources[3]));
+    put(w, rounding_rules    (sources[4]));
+    put(w, stratified_charges(sources[5]));
+
+    std::string const& payload = w.payload();
+    snapshot_header h;
+    std::memcpy(h.magic, snapshot_magic, sizeof h.magic);
+    h.version      = snapshot_version;
+    h.crc          = payload_crc(payload.data(), payload.size());
+    h.payload_size = payload.size();
+
+    fs::path const filename = snapshot_filename(product_name);
+    fs::path const temporary(filename.string() + ".tmp");
+    {
+    fs::ofstream ofs(temporary, ios_out_trunc_binary());
+    ofs.write(reinterpret_cast<char const*>(&h), sizeof h);
+    ofs.write(payload.data(), bourn_cast<std::streamsize>(payload.size()));
+    if(!ofs)
+        {
+        alarum() << "Unable to write product snapshot " << temporary << "." << LMI_FLUSH;
+        }
+    }
+    fs::rename(temporary, filename);
+}
+
+/// Read a product's snapshot, if it exists and is current.
+///
+/// Returns nothing if the snapshot is missing or stale; throws if it
+/// is unreadable or corrupt.
+
+std::optional<product_snapshot::contents> product_snapshot::read
+    (std::string const& product_name
+    )
+{
+    fs::path const filename = snapshot_filename(product_name);
+    if(!fs::exists(filename))
+        {
+        return {};
+        }
+
+    std::string image(bourn_cast<std::size_t>(fs::file_size(filename)), '\0');
+    fs::ifstream ifs(filename, ios_in_binary());
+    ifs.read(image.data(), bourn_cast<std::streamsize>(image.size()));
+    if(!ifs)
+        {
+        alarum() << "Unable to read product snapshot " << filename << "." << LMI_FLUSH;
+        }
+
+    snapshot_header h;
+    if(image.size() < sizeof h)
+        {
+        alarum() << "Product snapshot " << filename << " is truncated." << LMI_FLUSH;
+        }
+    std::memcpy(&h, image.data(), sizeof h);
+    if(0 != std::memcmp(h.magic, snapshot_magic, sizeof h.magic))
+        {
+        alarum() << "File " << filename << " is not a product snapshot." << LMI_FLUSH;
+        }
+    if(snapshot_version != h.version)
+        {
+        return {};
+        }
+    char const* const payload = image.data() + sizeof h;
+    if
+        (  image.size() - sizeof h != h.payload_size
+        || payload_crc(payload, image.size() - sizeof h) != h.crc
+        )
+        {
+        alarum() << "Product snapshot " << filename << " is corrupt." << LMI_FLUSH;
+        }
+
+    reader r(filename, payload, image.size() - sizeof h);
+    contents z;
+    z.product = get_product(r);
+    if(!z.product)
+        {
+        return {};
+        }
+    z.sources = source_files(product_name, *z.product);
+    for(auto const& i : z.sources)
+        {
+        auto const ticks = r.scalar<std::int64_t >();
+        auto const size  = r.scalar<std::uint64_t>();
+        if(!fs::exists(i))
+            {
+            return {};
+            }
+        auto const t = fs::last_write_time(i);
+        if(file_time_ticks(t) != ticks || fs::file_size(i) != size)
+            {
+            return {};
+            }
+        z.write_times.push_back(t);
+        }
+    z.database = get_database(r);
+    z.words    = get_lingo   (r);
+    z.funds    = get_funds   (r);
+    z.rounding = get_rounding(r);
+    z.strata   = get_strata  (r);
+    if(!z.database || !z.words || !z.funds || !z.rounding || !z.strata)
+        {
+        return {};
+        }
+    if(!r.exhausted())
+        {
+        alarum() << "Product snapshot " << filename << " is corrupt." << LMI_FLUSH;
+        }
+    return z;
+}
+
+/// Load a product's snapshot, if it exists and is current, into the
+/// file caches for all the files it represents.
+///
+/// Returns false, leaving the caches unchanged, if the snapshot is
+/// missing or stale; throws if it is unreadable or corrupt.
+
+bool product_snapshot::load(std::string const& product_name)
+{
+    std::optional<contents> const z = read(product_name);
+    if(!z)
+        {
+        return false;
+        }
+    auto const& f = z->sources;
+    auto const& t = z->write_times;
+    product_data      ::adopt_into_cache(f[0], z->product , t[0]);
+    DBDictionary      ::adopt_into_cache(f[1], z->database, t[1]);
+    lingo             ::adopt_into_cache(f[2], z->words   , t[2]);
+    FundData          ::adopt_into_cache(f[3], z->funds   , t[3]);
+    rounding_rules    ::adopt_into_cache(f[4], z->rounding, t[4]);
+    stratified_charges::adopt_into_cache(f[5], z->strata  , t[5]);
+    return true;
+}
+
+// Each class is written and read member by member, with member names
+// written only once, so that a class whose members have changed is
+// detected (and its snapshot treated as stale) without any need to
+// remember to increment 'snapshot_version'. Database keys are stored
+// as integers, but are compared to the enumerators that the current
+// build assigns to the same names.
+
+void product_snapshot::put(writer& w, product_data const& z)
+{
+    w.names(z.member_names());
+    for(auto const& i : z.member_names())
+        {
+        glossed_string const& s = *member_cast<glossed_string>(z[i]);
+        w.text(s.datum());
+        w.text(s.gloss());
+        }
+}
+
+std::shared_ptr<product_data const> product_snapshot::get_product(reader& r)
+{
+    std::shared_ptr<product_data> z(::new product_data);
+    if(!r.names_match(z->member_names()))
+        {
+        return {};
+        }
+    for(auto const& i : z->member_names())
+        {
+        std::string const datum = r.text();
+        std::string const gloss = r.text();
+        z->item(i) = glossed_string(datum, gloss);
+        }
+    return z;
+}
+
+void product_snapshot::put(writer& w, DBDictionary const& z)
+{
+    w.names(z.member_names());
+    for(auto const& i : z.member_names())
+        {
+        database_entity const& e = z.datum(i);
+        w.scalar<std::int32_t>(e.key());
+        w.array(e.axis_lengths());
+        w.array(e.data_values());
+        w.text(e.gloss_);
+        }
+}
+
+std::shared_ptr<DBDictionary const> product_snapshot::get_database(reader& r)
+{
+    std::shared_ptr<DBDictionary> z(::new DBDictionary);
+    if(!r.names_match(z->member_names()))
+        {
+        return {};
+        }
+    for(auto const& i : z->member_names())
+        {
+        int                 const key   = r.scalar<std::int32_t>();
+        std::vector<int>    const dims  = r.array<int>();
+        std::vector<double> const data  = r.array<double>();
+        std::string         const gloss = r.text();
+        if(key != z->datum(i).key())
+            {
+            return {};
+            }
+        z->datum(i) = database_entity(key, dims, data, gloss);
+        }
+    return z;
+}
+
+/// Layout of a snapshot's lingo entries.
+///
+/// Class lingo has no named members that could be written and read
+/// like those of the classes below: it is a map of integer keys to
+/// strings. Those keys are neither enumerators nor names that this
+/// build knows--they're the very integers that the '.lingo' file
+/// stores and its product's '.database' entities refer to. They mean
+/// the same in a snapshot as in the files it was made from, as long
+/// as they are read as they were written; so describe that layout,
+/// with the xml version it was taken from, and treat any snapshot
+/// that describes a different one as stale.
+
+std::vector<std::string> product_snapshot::lingo_layout()
+{
+    static_assert(std::is_same_v<int, decltype(lingo::map_)::key_type>);
+    return
+        {lingo::xml_root_name()
+        ,"version " + std::to_string(lingo::class_version())
+        ,"int32 key"
+        ,"text"
+        };
+}
+
+/// Layout of a snapshot's funds: FundInfo's members, named as in
+/// '.funds' files.
+///
+/// FundInfo has no list of member names, so the assertion makes any
+/// change in its members fail to compile until this is updated.
+
+std::vector<std::string> product_snapshot::fund_layout()
+{
+    static_assert(sizeof(FundInfo) == sizeof(double) + 3 * sizeof(std::string));
+    return {"scalar_imf", "short_name", "long_name", "gloss"};
+}
+
+void product_snapshot::put(writer& w, lingo const& z)
+{
+    w.names(lingo_layout());
+    w.scalar<std::uint64_t>(z.map_.size());
+    for(auto const& i : z.map_)
+        {
+        w.scalar<std::int32_t>(i.first);
+        w.text(i.second);
+        }
+}
+
+std::shared_ptr<lingo const> product_snapshot::get_lingo(reader& r)
+{
+    std::shared_ptr<lingo> z(::new lingo);
+    if(!r.names_match(lingo_layout()))
+        {
+        return {};
+        }
+    auto const n = r.scalar<std::uint64_t>();
+    for(std::uint64_t j = 0; j < n; ++j)
+        {
+        int const key = r.scalar<std::int32_t>();
+        z->map_[key] = r.text();
+        }
+    return z;
+}
+
+void product_snapshot::put(writer& w, FundData const& z)
+{
+    w.names(fund_layout());
+    w.scalar<std::uint64_t>(z.FundInfo_.size());
+    for(auto const& i : z.FundInfo_)
+        {
+        w.scalar<double>(i.ScalarIMF());
+        w.text(i.ShortName());
+        w.text(i.LongName());
+        w.text(i.gloss());
+        }
+}
+
+std::shared_ptr<FundData const> product_snapshot::get_funds(reader& r)
+{
+    std::shared_ptr<FundData> z(::new FundData);
+    if(!r.names_match(fund_layout()))
+        {
+        return {};
+        }
+    auto const n = r.scalar<std::uint64_t>();
+    for(std::uint64_t j = 0; j < n; ++j)
+        {
+        double      const imf        = r.scalar<double>();
+        std::string const short_name = r.text();
+        std::string const long_name  = r.text();
+        std::string const gloss      = r.text();
+        z->FundInfo_.emplace_back(imf, short_name, long_name, gloss);
+        }
+    return z;
+}
+
+void product_snapshot::put(writer& w, rounding_rules const& z)
+{
+    w.names(z.member_names());
+    for(auto const& i : z.member_names())
+        {
+        rounding_parameters const& p = z.datum(i);
+        w.scalar<std::int32_t>(p.decimals());
+        w.scalar<std::int32_t>(p.raw_style());
+        w.text(p.gloss());
+        }
+}
+
+std::shared_ptr<rounding_rules const> product_snapshot::get_rounding(reader& r)
+{
+    std::shared_ptr<rounding_rules> z(::new rounding_rules);
+    if(!r.names_match(z->member_names()))
+        {
+        return {};
+        }
+    for(auto const& i : z->member_names())
+        {
+        int         const decimals = r.scalar<std::int32_t>();
+        int         const style    = r.scalar<std::int32_t>();
+        std::string const gloss    = r.text();
+        *member_cast<rounding_parameters>((*z)[i]) = rounding_parameters
+            (decimals
+            ,static_cast<rounding_style>(style)
+            ,gloss
+            );
+        }
+    return z;
+}
+
+void product_snapshot::put(writer& w, stratified_charges const& z)
+{
+    w.names(z.member_names());
+    for(auto const& i : z.member_names())
+        {
+        stratified_entity const& e = z.datum(i);
+        w.array(e.limits());
+        w.array(e.values());
+        w.text(e.gloss());
+        }
+}
+
+std::shared_ptr<stratified_charges const> product_snapshot::get_strata(reader& r)
+{
+    std::shared_ptr<stratified_charges> z(::new stratified_charges);
+    if(!r.names_match(z->member_names()))
+        {
+        return {};
+        }
+    for(auto const& i : z->member_names())
+        {
+        std::vector<double> const limits = r.array<double>();
+        std::vector<double> const values = r.array<double>();
+        std::string         const gloss  = r.text();
+        z->datum(i) = stratified_entity(limits, values, gloss);
+        }
+    return z;
+}
+
+/// Product data for the named product, via the file cache.
+///
+/// The first time each product is requested, its snapshot (if any)
+/// is loaded to seed the file caches for all its files. A snapshot
+/// that can't be used is reported, and the xml files are read just
+/// as though it didn't exist.
+
+std::shared_ptr<product_data const> read_product_via_cache
+    (std::string const& product_name
+    )
+{
+    static std::mutex            mutex;
+    static std::set<std::string> products_seen;
+    {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(products_seen.insert(product_name).second)
+        {
+        try
+            {
+            product_snapshot::load(product_name);
+            }
+        catch(...)
+            {
+            report_exception();
+            }
+        }
+    }
+    return product_data::read_via_cache(filename_from_product_name(product_name));
+}
+
+/// Write a snapshot for every product.
+///
+/// A product whose files can't be read is reported, and skipped.
+
+void write_product_snapshots()
+{
+    for(auto const& i : ce_product_name().all_strings())
+        {
+        try
+            {
+            product_snapshot::write(i);
+            }
+        catch(...)
+            {
+            report_exception();
+            }
+        }
+}
@@ -0,0 +1,115 @@
+// Precompiled binary snapshots of product files.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#ifndef product_snapshot_hpp
+#define product_snapshot_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <memory>                       // shared_ptr
+#include <optional>
+#include <string>
+#include <vector>
+
+class DBDictionary;
+class FundData;
+class lingo;
+class product_data;
+class rounding_rules;
+class stratified_charges;
+
+/// Precompiled binary image of all the files that define a product.
+///
+/// A product is defined by a '.policy' file, which names its
+/// '.database', '.lingo', '.funds', '.rounding', and '.strata' files.
+/// Reading all of them as xml is costly, and every new process pays
+/// that cost for each product it uses. A snapshot holds the objects
+/// constructed from all six files, in a simple binary format that is
+/// read without any parsing, and 'foo.snapshot' is loaded instead of
+/// the xml files for product 'foo' if it is not stale.
+///
+/// The xml files remain the editable source: a snapshot can always
+/// be regenerated ('lmi_cli --snapshot'), and is ignored if any file
+/// it was made from has since been changed. Loading a snapshot only
+/// seeds the file caches (see class cache_file_reads), so the objects
+/// it provides are used exactly as though they had been read from
+/// xml, and any file that changes later is simply reread.
+///
+/// File layout, in native byte order: a fixed-size header giving the
+/// format version and the payload's size and CRC; then the payload,
+/// which holds the product_data object, the write time and size of
+/// each source file, and the other five objects, in that order.
+
+class LMI_SO product_snapshot final
+{
+  public:
+    /// Objects held in a snapshot, and the files they stand for.
+
+    struct contents
+    {
+        std::vector<fs::path>                     sources;
+        std::vector<fs::file_time_type>           write_times;
+        std::shared_ptr<product_data       const> product;
+        std::shared_ptr<DBDictionary       const> database;
+        std::shared_ptr<lingo              const> words;
+        std::shared_ptr<FundData           const> funds;
+        std::shared_ptr<rounding_rules     const> rounding;
+        std::shared_ptr<stratified_charges const> strata;
+    };
+
+    static fs::path snapshot_filename(std::string const& product_name);
+    static void write(std::string const& product_name);
+    static std::optional<contents> read(std::string const& product_name);
+    static bool load(std::string const& product_name);
+
+  private:
+    class reader;
+    class writer;
+
+    static void put(writer&, product_data       const&);
+    static void put(writer&, DBDictionary       const&);
+    static void put(writer&, lingo              const&);
+    static void put(writer&, FundData           const&);
+    static void put(writer&, rounding_rules     const&);
+    static void put(writer&, stratified_charges const&);
+
+    static std::shared_ptr<product_data       const> get_product (reader&);
+    static std::shared_ptr<DBDictionary       const> get_database(reader&);
+    static std::shared_ptr<lingo              const> get_lingo   (reader&);
+    static std::shared_ptr<FundData           const> get_funds   (reader&);
+    static std::shared_ptr<rounding_rules     const> get_rounding(reader&);
+    static std::shared_ptr<stratified_charges const> get_strata  (reader&);
+
+    static std::vector<std::string> lingo_layout();
+    static std::vector<std::string> fund_layout();
+};
+
+LMI_SO std::shared_ptr<product_data const> read_product_via_cache
+    (std::string const& product_name
+    );
+
+LMI_SO void write_product_snapshots();
+
+#endif // product_snapshot_hpp
@@ -37,12 +37,19 @@ std::ostringstream& progress_meter_unit_test_stream()
 
 progress_meter_creator_type progress_meter_creator = nullptr;
 
+thread_local progress_meter_creator_type thread_progress_meter_creator = nullptr;
+
 std::unique_ptr<progress_meter> create_progress_meter
     (int                               max_count
     ,std::string const&                title
     ,progress_meter::enum_display_mode display_mode
     )
 {
+    if(nullptr != thread_progress_meter_creator)
+        {
+        return thread_progress_meter_creator(max_count, title, display_mode);
+        }
+
     if(nullptr == progress_meter_creator)
         {
         alarum() << "Function pointer not yet initialized." << LMI_FLUSH;
@@ -65,6 +72,11 @@ bool set_progress_meter_creator(progress_meter_creator_type f)
     return true;
 }
 
+void set_thread_progress_meter_creator(progress_meter_creator_type f)
+{
+    thread_progress_meter_creator = f;
+}
+
 progress_meter::progress_meter
     (int                max_count
     ,std::string const& title
@@ -119,6 +119,13 @@
 /// set_progress_meter_creator(): Set the function pointer used by
 /// create_progress_meter().
 ///
+/// set_thread_progress_meter_creator(): Set a function pointer that
+/// create_progress_meter() prefers to the one set above, but only on
+/// the calling thread; pass nullptr to restore the default. A GUI
+/// can thus run a long operation on a worker thread, with a meter
+/// that reports progress to the GUI thread instead of creating GUI
+/// objects itself.
+///
 /// Design alternatives considered; rationale for design choices.
 ///
 /// dawdle() is a non-static public member. It cannot be a private
@@ -263,4 +270,6 @@ typedef std::unique_ptr<progress_meter> (*progress_meter_creator_type)
 
 LMI_SO bool set_progress_meter_creator(progress_meter_creator_type);
 
+LMI_SO void set_thread_progress_meter_creator(progress_meter_creator_type);
+
 #endif // progress_meter_hpp
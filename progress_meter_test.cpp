@@ -27,6 +27,7 @@
 #include "unwind.hpp"                   // scoped_unwind_toggler
 
 #include <sstream>
+#include <thread>
 
 class progress_meter_test
 {
@@ -39,6 +40,7 @@ class progress_meter_test
         test_empty_title_and_zero_max_count();
         test_postcondition_failure();
         test_failure_to_culminate();
+        test_thread_progress_meter_creator();
         }
 
   private:
@@ -48,8 +50,37 @@ class progress_meter_test
     static void test_empty_title_and_zero_max_count();
     static void test_postcondition_failure();
     static void test_failure_to_culminate();
+    static void test_thread_progress_meter_creator();
 };
 
+namespace
+{
+/// A meter that never displays anything, and cancels after one step.
+
+class cancelling_progress_meter
+    :public progress_meter
+{
+  public:
+    cancelling_progress_meter(int max_count, std::string const& title)
+        :progress_meter(max_count, title, e_unit_test_mode)
+        {}
+
+  private:
+    std::string progress_message() const override {return "";}
+    bool show_progress_message() override {return count() < 1;}
+    void culminate_ui() override {}
+};
+
+std::unique_ptr<progress_meter> cancelling_progress_meter_creator
+    (int                               max_count
+    ,std::string const&                title
+    ,progress_meter::enum_display_mode
+    )
+{
+    return std::make_unique<cancelling_progress_meter>(max_count, title);
+}
+} // Unnamed namespace.
+
 void progress_meter_test::test_normal_usage()
 {
     progress_meter_unit_test_stream().str("");
@@ -228,6 +259,71 @@ void progress_meter_test::test_failure_to_culminate()
         ;
 }
 
+void progress_meter_test::test_thread_progress_meter_creator()
+{
+    progress_meter_unit_test_stream().str("");
+    int const max_count = 3;
+
+    // A creator set for another thread doesn't affect this one.
+    std::thread t
+        ([]
+            {
+            set_thread_progress_meter_creator(cancelling_progress_meter_creator);
+            std::unique_ptr<progress_meter> meter
+                (create_progress_meter(max_count, "Worker")
+                );
+            LMI_TEST(!meter->reflect_progress());
+            meter->culminate();
+            }
+        );
+    t.join();
+
+    std::unique_ptr<progress_meter> meter0
+        (create_progress_meter
+            (max_count
+            ,"Operation 0"
+            ,progress_meter::e_unit_test_mode
+            )
+        );
+    for(int i = 0; i < max_count; ++i)
+        {
+        LMI_TEST(meter0->reflect_progress());
+        }
+    meter0->culminate();
+
+    // The creator set for this thread is preferred...
+    set_thread_progress_meter_creator(cancelling_progress_meter_creator);
+    std::unique_ptr<progress_meter> meter1
+        (create_progress_meter
+            (max_count
+            ,"Operation 1"
+            ,progress_meter::e_unit_test_mode
+            )
+        );
+    LMI_TEST(!meter1->reflect_progress());
+    meter1->culminate();
+
+    // ...until it is reset.
+    set_thread_progress_meter_creator(nullptr);
+    std::unique_ptr<progress_meter> meter2
+        (create_progress_meter
+            (max_count
+            ,"Operation 2"
+            ,progress_meter::e_unit_test_mode
+            )
+        );
+    for(int i = 0; i < max_count; ++i)
+        {
+        LMI_TEST(meter2->reflect_progress());
+        }
+    meter2->culminate();
+
+    LMI_TEST_EQUAL
+        ("Operation 0...\nOperation 2...\n"
+        ,progress_meter_unit_test_stream().str()
+        );
+}
+
 int test_main(int, char*[])
 {
     progress_meter_test::test();
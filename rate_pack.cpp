@@ -0,0 +1,516 @@
+// Precompiled, read-only images of SOA table databases.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "rate_pack.hpp"
+
+#include "actuarial_table.hpp"
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "bourn_cast.hpp"
+#include "crc32.hpp"
+#include "istream_to_string.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary()
+#include "path_utility.hpp"             // fs::path inserter
+#include "ssize_lmi.hpp"
+
+#include <algorithm>                    // equal()
+#include <bit>                          // endian
+#include <cstring>                      // memcmp(), memcpy()
+#include <mutex>
+#include <type_traits>
+
+#if defined LMI_POSIX
+#   include <fcntl.h>                   // open()
+#   include <sys/mman.h>                // mmap(), munmap()
+#   include <sys/stat.h>                // fstat()
+#   include <unistd.h>                  // close()
+#endif // defined LMI_POSIX
+
+namespace
+{
+char const pack_magic[8] = {'l', 'm', 'i', 'r', 'p', 'a', 'c', 'k'};
+
+std::uint32_t const pack_version = 2;
+
+/// Fixed-size header at the beginning of a rate pack.
+///
+/// Sections follow in the order of the counts given here, with no
+/// padding, so their offsets need not be stored.
+
+struct pack_header
+{
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t n_slots;          // A power of two.
+    std::uint64_t n_tables;
+    std::uint64_t n_rows;
+    std::uint64_t n_values;
+    std::uint64_t dat_size;         // Size of the source '.dat' file.
+    std::uint64_t ndx_size;         // Size of the source '.ndx' file.
+    std::uint32_t dat_crc;          // CRC of the source '.dat' file.
+    std::uint32_t ndx_crc;          // CRC of the source '.ndx' file.
+    std::uint64_t file_size;
+};
+
+static_assert(std::is_trivially_copyable_v<pack_header>);
+static_assert(0 == sizeof(pack_header) % sizeof(double));
+
+std::uint64_t slots_offset()
+{
+    return sizeof(pack_header);
+}
+
+/// Home slot for a table number.
+///
+/// Table numbers often run consecutively, so multiplying by an odd
+/// constant and taking the low-order bits spreads them evenly.
+
+std::uint32_t home_slot(int table_number, std::uint32_t n_slots)
+{
+    return (static_cast<std::uint32_t>(table_number) * 2654435761U) & (n_slots - 1);
+}
+
+fs::path sibling(std::string const& database_filename, char const* extension)
+{
+    fs::path z(database_filename);
+    z.replace_extension(extension);
+    return z;
+}
+
+/// Packs are mapped and used in place, so their values must already
+/// be in this hardware's byte order.
+
+void require_little_endian()
+{
+    if(std::endian::native != std::endian::little)
+        {
+        alarum() << "Rate packs can be used only on little-endian hardware." << LMI_FLUSH;
+        }
+}
+
+/// CRC of an entire file's contents.
+
+std::uint32_t file_crc(fs::path const& filename)
+{
+    fs::ifstream ifs(filename, ios_in_binary());
+    if(!ifs)
+        {
+        alarum() << "Unable to open " << filename << "." << LMI_FLUSH;
+        }
+    std::string s;
+    istream_to_string(ifs, s);
+    CRC crc;
+    crc += s;
+    return crc.value();
+}
+} // Unnamed namespace.
+
+/// Map or read a rate pack, and validate its layout.
+
+rate_pack::rate_pack(fs::path const& filename)
+    :filename_ {filename}
+{
+    require_little_endian();
+
+    char const* image = nullptr;
+    std::size_t image_size = 0;
+
+#if defined LMI_POSIX
+    int const fd = ::open(filename.string().c_str(), O_RDONLY);
+    struct stat st;
+    if(-1 == fd || 0 != ::fstat(fd, &st))
+        {
+        if(-1 != fd) {::close(fd);}
+        alarum() << "Unable to open rate pack " << filename << "." << LMI_FLUSH;
+        }
+    image_size = bourn_cast<std::size_t>(st.st_size);
+    void* const p =
+          0 != image_size
+        ? ::mmap(nullptr, image_size, PROT_READ, MAP_PRIVATE, fd, 0)
+        : MAP_FAILED
+        ;
+    ::close(fd);
+    if(MAP_FAILED == p)
+        {
+        alarum() << "Unable to map rate pack " << filename << "." << LMI_FLUSH;
+        }
+    mapping_      = p;
+    mapping_size_ = image_size;
+    image = static_cast<char const*>(p);
+#else  // !defined LMI_POSIX
+    fs::ifstream ifs(filename, ios_in_binary() | std::ios_base::ate);
+    if(!ifs)
+        {
+        alarum() << "Unable to open rate pack " << filename << "." << LMI_FLUSH;
+        }
+    image_size = bourn_cast<std::size_t>(static_cast<std::streamoff>(ifs.tellg()));
+    ifs.seekg(0);
+    buffer_.resize((image_size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    ifs.read(reinterpret_cast<char*>(buffer_.data()), bourn_cast<std::streamsize>(image_size));
+    if(!ifs)
+        {
+        alarum() << "Unable to read rate pack " << filename << "." << LMI_FLUSH;
+        }
+    image = reinterpret_cast<char const*>(buffer_.data());
+#endif // !defined LMI_POSIX
+
+    try
+        {
+        pack_header h;
+        if(image_size < sizeof h)
+            {
+            alarum() << "Rate pack " << filename << " is truncated." << LMI_FLUSH;
+            }
+        std::memcpy(&h, image, sizeof h);
+        if(0 != std::memcmp(h.magic, pack_magic, sizeof pack_magic))
+            {
+            alarum() << "File " << filename << " is not a rate pack." << LMI_FLUSH;
+            }
+        if(pack_version != h.version)
+            {
+            alarum()
+                << "Rate pack " << filename
+                << " has version " << h.version
+                << ", but version " << pack_version
+                << " is required. Regenerate it with rate_table_tool."
+                << LMI_FLUSH
+                ;
+            }
+        std::uint64_t const rows_offset =
+            slots_offset() + h.n_slots * sizeof(slot);
+        std::uint64_t const values_offset =
+            rows_offset + h.n_rows * sizeof(std::uint64_t);
+        std::uint64_t const end =
+            values_offset + h.n_values * sizeof(double);
+        if
+            (  0 == h.n_slots
+            || 0 != (h.n_slots & (h.n_slots - 1))
+            || h.n_slots < h.n_tables
+            || end != h.file_size
+            || end != image_size
+            )
+            {
+            alarum() << "Rate pack " << filename << " is corrupt." << LMI_FLUSH;
+            }
+
+        slots_.resize(h.n_slots);
+        std::memcpy(slots_.data(), image + slots_offset(), h.n_slots * sizeof(slot));
+        tables_count_ = h.n_tables;
+        dat_size_     = h.dat_size;
+        ndx_size_     = h.ndx_size;
+        dat_crc_      = h.dat_crc;
+        ndx_crc_      = h.ndx_crc;
+        n_rows_       = h.n_rows;
+        n_values_     = h.n_values;
+        row_offsets_  = image + rows_offset;
+        values_       = image + values_offset;
+
+        for(auto const& s : slots_)
+            {
+            if(0 == s.table_number)
+                {
+                continue;
+                }
+            if(s.max_age < s.min_age)
+                {
+                alarum() << "Rate pack " << filename << " is corrupt." << LMI_FLUSH;
+                }
+            std::uint64_t const n_ages = bourn_cast<std::uint64_t>(1 + s.max_age - s.min_age);
+            if(n_rows_ < s.first_row + n_ages)
+                {
+                alarum() << "Rate pack " << filename << " is corrupt." << LMI_FLUSH;
+                }
+            for(std::uint64_t j = 0; j < n_ages; ++j)
+                {
+                // Row for issue age (min_age + j) runs through max_age.
+                if(n_values_ < row_offset(s.first_row + j) + n_ages - j)
+                    {
+                    alarum() << "Rate pack " << filename << " is corrupt." << LMI_FLUSH;
+                    }
+                }
+            }
+        }
+    catch(...)
+        {
+#if defined LMI_POSIX
+        ::munmap(mapping_, mapping_size_);
+#endif // defined LMI_POSIX
+        throw;
+        }
+}
+
+rate_pack::~rate_pack()
+{
+#if defined LMI_POSIX
+    if(mapping_)
+        {
+        ::munmap(mapping_, mapping_size_);
+        }
+#endif // defined LMI_POSIX
+}
+
+/// Compile the given tables of an SOA database into a rate pack.
+///
+/// Tables are read through class actuarial_table, so that the pack
+/// reproduces exactly what it would return for every issue age.
+///
+/// The file is written under a temporary name and then renamed, so
+/// that a reader never sees a partial pack.
+
+void rate_pack::write
+    (std::string      const& database_filename
+    ,std::vector<int> const& table_numbers
+    ,fs::path         const& pack_filename
+    )
+{
+    require_little_endian();
+
+    std::uint32_t n_slots = 1;
+    while(n_slots < 2 * table_numbers.size())
+        {
+        n_slots *= 2;
+        }
+
+    std::vector<slot>          slots(n_slots, slot {});
+    std::vector<std::uint64_t> row_offsets;
+    std::vector<double>        values;
+
+    for(auto const number : table_numbers)
+        {
+        actuarial_table const t(database_filename, number);
+
+        std::uint32_t k = home_slot(number, n_slots);
+        for(; 0 != slots[k].table_number; k = (k + 1) & (n_slots - 1))
+            {
+            if(number == slots[k].table_number)
+                {
+                alarum()
+                    << "Table " << number
+                    << " appears more than once in '"
+                    << database_filename
+                    << "'."
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+        slot& s = slots[k];
+        s.table_number   = number;
+        s.table_type     = t.table_type();
+        s.min_age        = t.min_age();
+        s.max_age        = t.max_age();
+        s.select_period  = t.select_period();
+        s.max_select_age = t.max_select_age();
+        s.first_row      = row_offsets.size();
+
+        // Store the row for the minimum age in full. Store any other
+        // row only if it isn't already present within that one.
+        std::uint64_t const base = values.size();
+        int const base_length = 1 + t.max_age() - t.min_age();
+        for(int age = t.min_age(); age <= t.max_age(); ++age)
+            {
+            std::vector<double> const row = t.values(age, 1 + t.max_age() - age);
+            if(age == t.min_age())
+                {
+                row_offsets.push_back(base);
+                values.insert(values.end(), row.begin(), row.end());
+                continue;
+                }
+            double const* first = values.data() + base;
+            double const* last  = first + base_length;
+            auto const matches = [&] (std::uint64_t offset)
+                {
+                return std::equal(row.begin(), row.end(), first + offset, last);
+                };
+            if('D' == t.table_type() && matches(0))
+                {
+                row_offsets.push_back(base);
+                }
+            else if('A' == t.table_type() && matches(age - t.min_age()))
+                {
+                row_offsets.push_back(base + bourn_cast<std::uint64_t>(age - t.min_age()));
+                }
+            else
+                {
+                row_offsets.push_back(values.size());
+                values.insert(values.end(), row.begin(), row.end());
+                }
+            }
+        }
+
+    pack_header h {};
+    std::memcpy(h.magic, pack_magic, sizeof pack_magic);
+    h.version   = pack_version;
+    h.n_slots   = n_slots;
+    h.n_tables  = table_numbers.size();
+    h.n_rows    = row_offsets.size();
+    h.n_values  = values.size();
+    h.dat_size  = fs::file_size(sibling(database_filename, ".dat"));
+    h.ndx_size  = fs::file_size(sibling(database_filename, ".ndx"));
+    h.dat_crc   = file_crc(sibling(database_filename, ".dat"));
+    h.ndx_crc   = file_crc(sibling(database_filename, ".ndx"));
+    h.file_size =
+          slots_offset()
+        + slots.size()       * sizeof(slot)
+        + row_offsets.size() * sizeof(std::uint64_t)
+        + values.size()      * sizeof(double)
+        ;
+
+    fs::path const temporary(pack_filename.string() + ".tmp");
+    {
+    fs::ofstream ofs(temporary, ios_out_trunc_binary());
+    auto const put = [&ofs] (void const* p, std::size_t n)
+        {
+        ofs.write(static_cast<char const*>(p), bourn_cast<std::streamsize>(n));
+        };
+    put(&h                , sizeof h);
+    put(slots.data()      , slots.size()       * sizeof(slot));
+    put(row_offsets.data(), row_offsets.size() * sizeof(std::uint64_t));
+    put(values.data()     , values.size()      * sizeof(double));
+    if(!ofs)
+        {
+        alarum() << "Unable to write rate pack " << temporary << "." << LMI_FLUSH;
+        }
+    }
+    fs::rename(temporary, pack_filename);
+}
+
+/// Name of the rate pack corresponding to an SOA database.
+
+fs::path rate_pack::pack_filename(std::string const& database_filename)
+{
+    return sibling(database_filename, ".rpk");
+}
+
+/// Whether this pack was compiled from the SOA database beside it.
+///
+/// Both SOA files must have the sizes and CRCs they had when the pack
+/// was written. Computing a CRC means reading the whole database, so
+/// this is determined only once for each pack that is loaded. Files
+/// are loaded via a cache that reloads a pack when it is rewritten,
+/// so rewriting a pack makes it be checked again; altering an SOA
+/// database while a pack compiled from it is loaded does not.
+
+bool rate_pack::is_current() const
+{
+    std::call_once
+        (verified_
+        ,[this]
+            {
+            fs::path const dat = sibling(filename_.string(), ".dat");
+            fs::path const ndx = sibling(filename_.string(), ".ndx");
+            current_ =
+                   fs::exists(dat)
+                && fs::exists(ndx)
+                && dat_size_ == fs::file_size(dat)
+                && ndx_size_ == fs::file_size(ndx)
+                && dat_crc_  == file_crc(dat)
+                && ndx_crc_  == file_crc(ndx)
+                ;
+            }
+        );
+    return current_;
+}
+
+int rate_pack::tables_count() const
+{
+    return bourn_cast<int>(tables_count_);
+}
+
+bool rate_pack::contains(int table_number) const
+{
+    return nullptr != find_slot(table_number);
+}
+
+rate_pack::table_view rate_pack::find_table(int table_number) const
+{
+    slot const* s = find_slot(table_number);
+    if(!s)
+        {
+        alarum()
+            << "There is no table number "
+            << table_number
+            << " in rate pack "
+            << filename_
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+    return table_view(*this, *s);
+}
+
+rate_pack::slot const* rate_pack::find_slot(int table_number) const
+{
+    if(table_number <= 0)
+        {
+        return nullptr;
+        }
+    std::uint32_t const n_slots = bourn_cast<std::uint32_t>(slots_.size());
+    std::uint32_t k = home_slot(table_number, n_slots);
+    for(std::uint32_t j = 0; j < n_slots; ++j, k = (k + 1) & (n_slots - 1))
+        {
+        if(table_number == slots_[k].table_number)
+            {
+            return &slots_[k];
+            }
+        if(0 == slots_[k].table_number)
+            {
+            break;
+            }
+        }
+    return nullptr;
+}
+
+int  rate_pack::table_view::table_number  () const {return slot_.table_number  ;}
+char rate_pack::table_view::table_type    () const {return static_cast<char>(slot_.table_type);}
+int  rate_pack::table_view::min_age       () const {return slot_.min_age       ;}
+int  rate_pack::table_view::max_age       () const {return slot_.max_age       ;}
+int  rate_pack::table_view::select_period () const {return slot_.select_period ;}
+int  rate_pack::table_view::max_select_age() const {return slot_.max_select_age;}
+
+/// Offset of the j-th row within the values section.
+///
+/// The image is only byte-addressable as far as the language is
+/// concerned, so each datum is copied out rather than read through
+/// a cast pointer.
+
+std::uint64_t rate_pack::row_offset(std::uint64_t j) const
+{
+    std::uint64_t z;
+    std::memcpy(&z, row_offsets_ + j * sizeof z, sizeof z);
+    return z;
+}
+
+/// Read a given number of values for a given issue age.
+///
+/// Same as actuarial_table::values(), q.v.
+
+std::vector<double> rate_pack::table_view::values(int issue_age, int length) const
+{
+    LMI_ASSERT(min_age() <= issue_age && issue_age <= max_age());
+    LMI_ASSERT(0 <= length && length <= 1 + max_age() - issue_age);
+    std::uint64_t const j = slot_.first_row + bourn_cast<std::uint64_t>(issue_age - min_age());
+    char const* p = pack_.values_ + pack_.row_offset(j) * sizeof(double);
+    std::vector<double> z(bourn_cast<std::size_t>(length));
+    std::memcpy(z.data(), p, z.size() * sizeof(double));
+    return z;
+}
@@ -0,0 +1,156 @@
+// Precompiled, read-only images of SOA table databases.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef rate_pack_hpp
+#define rate_pack_hpp
+
+#include "config.hpp"
+
+#include "cache_file_reads.hpp"
+#include "path.hpp"
+
+#include <cstddef>                      // size_t
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Precompiled, read-only image of an SOA table database.
+///
+/// The SOA '.dat' format stores each table as a variable-length
+/// record that must be parsed field by field, and select-and-ultimate
+/// tables must then be rearranged for each issue age. A rate pack
+/// does all that work in advance: rate_table_tool writes one, as
+/// 'foo.rpk' for 'foo.dat' and 'foo.ndx', and actuarial_table_rates()
+/// uses it instead of the SOA files if it is not stale. The SOA
+/// database remains the source of truth; a pack can always be
+/// regenerated from it, and is ignored if it no longer matches it.
+///
+/// File layout, in little-endian byte order, so that a pack can be
+/// mapped and used in place; other hardware rejects packs at run time
+/// rather than swapping every value:
+///   - a fixed-size header;
+///   - a hash index of fixed-size table records, addressed by table
+///     number, with linear probing;
+///   - for each table, one row offset per issue age;
+///   - the rows themselves, as aligned arrays of double, one for
+///     each issue age, running through the table's maximum age.
+/// Rows that are identical to part of another row are stored only
+/// once: all rows of a duration table share the same storage, and
+/// each row of an attained-age table is a suffix of the row for the
+/// minimum age.
+///
+/// Where memory mapping is available, the file is mapped rather than
+/// read, so that looking up a row costs only a copy of its values.
+
+class rate_pack final
+    :public cache_file_reads<rate_pack>
+{
+    struct slot;
+
+  public:
+    /// One table in a pack. Valid only as long as the pack is.
+
+    class table_view
+    {
+        friend class rate_pack;
+
+      public:
+        int  table_number   () const;
+        char table_type     () const;
+        int  min_age        () const;
+        int  max_age        () const;
+        int  select_period  () const;
+        int  max_select_age () const;
+
+        std::vector<double> values(int issue_age, int length) const;
+
+      private:
+        table_view(rate_pack const& pack, slot const& s)
+            :pack_ {pack}
+            ,slot_ {s}
+            {
+            }
+
+        rate_pack const& pack_;
+        slot      const& slot_;
+    };
+
+    explicit rate_pack(fs::path const& filename);
+    ~rate_pack();
+
+    static void write
+        (std::string      const& database_filename
+        ,std::vector<int> const& table_numbers
+        ,fs::path         const& pack_filename
+        );
+
+    static fs::path pack_filename(std::string const& database_filename);
+    bool is_current() const;
+
+    int tables_count() const;
+    bool contains(int table_number) const;
+    table_view find_table(int table_number) const;
+
+  private:
+    rate_pack(rate_pack const&) = delete;
+    rate_pack& operator=(rate_pack const&) = delete;
+
+    slot const* find_slot(int table_number) const;
+    std::uint64_t row_offset(std::uint64_t j) const;
+
+    fs::path                   filename_;
+    std::vector<slot>          slots_;
+    std::uint64_t              tables_count_ {0};
+    std::uint64_t              dat_size_     {0};
+    std::uint64_t              ndx_size_     {0};
+    std::uint32_t              dat_crc_      {0};
+    std::uint32_t              ndx_crc_      {0};
+    char const*                row_offsets_  {nullptr};
+    char const*                values_       {nullptr};
+    std::uint64_t              n_rows_       {0};
+    std::uint64_t              n_values_     {0};
+
+    // Mapped image, if memory mapping is available...
+    void*                      mapping_      {nullptr};
+    std::size_t                mapping_size_ {0};
+    // ...else the image as read into memory, aligned for double.
+    std::vector<std::uint64_t> buffer_;
+
+    // Outcome of the comparison in is_current(), made only once.
+    mutable std::once_flag     verified_;
+    mutable bool               current_      {false};
+};
+
+/// Index record for one table in a rate pack.
+
+struct rate_pack::slot
+{
+    std::int32_t  table_number;     // Zero for an empty slot.
+    std::int32_t  table_type;
+    std::int32_t  min_age;
+    std::int32_t  max_age;
+    std::int32_t  select_period;
+    std::int32_t  max_select_age;
+    std::uint64_t first_row;        // Index into the row offsets.
+};
+
+#endif // rate_pack_hpp
@@ -0,0 +1,140 @@
+// Projections of one cell under several interest-rate scenarios.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "rate_scenarios.hpp"
+
+#include "account_value.hpp"
+#include "alert.hpp"
+#include "basic_values.hpp"
+#include "death_benefits.hpp"
+#include "fenv_guard.hpp"
+#include "input.hpp"
+#include "interest_rates.hpp"
+#include "ledger.hpp"
+#include "ledger_variant.hpp"
+#include "mc_enum_types_aux.hpp"        // mc_str()
+#include "outlay.hpp"
+#include "ssize_lmi.hpp"
+
+/// Replace input interest rates, for another run of the same cell.
+///
+/// Interest rates are reinitialized. So are the death-benefit and
+/// outlay objects, which a run may change through strategies and
+/// solves, so that each scenario starts from the input values. All
+/// else is independent of input interest rates: mortality rates,
+/// loads, and the 7702 and 7702A machinery are kept.
+///
+/// Defined here rather than with the rest of the class, because it
+/// is the same for both branches.
+
+void BasicValues::SetInterestRateScenario
+    (std::vector<double> const& gen_acct_rate
+    ,std::vector<double> const& sep_acct_rate
+    )
+{
+    if
+        (  GetLength() != lmi::ssize(gen_acct_rate)
+        || GetLength() != lmi::ssize(sep_acct_rate)
+        )
+        {
+        alarum()
+            << "Interest-rate scenario has "
+            << gen_acct_rate.size()
+            << " general-account and "
+            << sep_acct_rate.size()
+            << " separate-account rates, but "
+            << GetLength()
+            << " are required."
+            << LMI_FLUSH
+            ;
+        }
+
+    yare_input_.GeneralAccountRate  = gen_acct_rate;
+    yare_input_.SeparateAccountRate = sep_acct_rate;
+
+    InterestRates_  = std::make_unique<InterestRates >(*this);
+    DeathBfts_      = std::make_unique<death_benefits>
+        (GetLength()
+        ,yare_input_
+        ,round_specamt_
+        );
+    Outlay_         = std::make_unique<modal_outlay>
+        (yare_input_
+        ,round_gross_premium_
+        ,round_withdrawal_
+        ,round_loan_
+        );
+}
+
+std::vector<std::shared_ptr<Ledger const>> run_rate_scenarios
+    (Input                      const& input
+    ,std::vector<rate_scenario> const& scenarios
+    )
+{
+    std::vector<std::shared_ptr<Ledger const>> z;
+    z.reserve(scenarios.size());
+    if(scenarios.empty())
+        {
+        return z;
+        }
+
+    fenv_guard fg;
+    AccountValue av(input);
+    for(auto const& i : scenarios)
+        {
+        z.push_back
+            (av.RunRateScenario
+                (i.general_account_rate
+                ,i.separate_account_rate
+                )
+            );
+        }
+    return z;
+}
+
+std::vector<std::vector<double>> scenario_column
+    (std::vector<std::shared_ptr<Ledger const>> const& ledgers
+    ,mcenum_run_basis                                  basis
+    ,std::string                                const& column
+    )
+{
+    std::vector<std::vector<double>> z;
+    z.reserve(ledgers.size());
+    for(auto const& i : ledgers)
+        {
+        ledger_map_t const& bases = i->GetLedgerMap().held();
+        auto const b = bases.find(basis);
+        if(bases.end() == b)
+            {
+            alarum() << "No " << mc_str(basis) << " basis." << LMI_FLUSH;
+            }
+        double_vector_map const& vectors = b->second.all_vectors();
+        auto const v = vectors.find(column);
+        if(vectors.end() == v)
+            {
+            alarum() << "No column '" << column << "'." << LMI_FLUSH;
+            }
+        z.push_back(*v->second);
+        }
+    return z;
+}
@@ -0,0 +1,69 @@
+// Projections of one cell under several interest-rate scenarios.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef rate_scenarios_hpp
+#define rate_scenarios_hpp
+
+#include "config.hpp"
+
+#include "mc_enum_type_enums.hpp"       // mcenum_run_basis
+#include "so_attributes.hpp"
+
+#include <memory>                       // shared_ptr
+#include <string>
+#include <vector>
+
+class Input;
+class Ledger;
+
+/// Input interest rates for one scenario, with one value for each
+/// policy year, expressed as in class Input.
+
+struct rate_scenario
+{
+    std::vector<double> general_account_rate;
+    std::vector<double> separate_account_rate;
+};
+
+/// Project one cell under each of several interest-rate scenarios.
+///
+/// This is equivalent to running an illustration for each scenario,
+/// with that scenario's rates substituted for the input rates; but
+/// everything that doesn't depend on those rates--product data,
+/// mortality rates, loads, and 7702 and 7702A machinery--is set up
+/// only once and shared by all scenarios.
+///
+/// Returns one ledger per scenario, in order.
+
+LMI_SO std::vector<std::shared_ptr<Ledger const>> run_rate_scenarios
+    (Input                      const& input
+    ,std::vector<rate_scenario> const& scenarios
+    );
+
+/// One column of each scenario's ledger, on the given basis.
+
+LMI_SO std::vector<std::vector<double>> scenario_column
+    (std::vector<std::shared_ptr<Ledger const>> const& ledgers
+    ,mcenum_run_basis                                  basis
+    ,std::string                                const& column
+    );
+
+#endif // rate_scenarios_hpp
@@ -0,0 +1,197 @@
+// Interest-rate scenarios for one cell--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "rate_scenarios.hpp"
+
+#include "global_settings.hpp"
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "ledgervalues.hpp"
+#include "mc_enum_types_aux.hpp"        // mc_str()
+#include "ssize_lmi.hpp"
+#include "test_tools.hpp"
+#include "yare_input.hpp"
+
+#include <iostream>
+#include <memory>                       // shared_ptr
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Names of vectors that differ between two maps, or that only one
+/// of them has.
+
+std::vector<std::string> differences
+    (double_vector_map const& a
+    ,double_vector_map const& b
+    )
+{
+    std::vector<std::string> z;
+    for(auto const& [name, v] : a)
+        {
+        auto const i = b.find(name);
+        if(b.end() == i || *i->second != *v)
+            {
+            z.push_back(name);
+            }
+        }
+    for(auto const& [name, v] : b)
+        {
+        if(!a.contains(name))
+            {
+            z.push_back(name);
+            }
+        }
+    return z;
+}
+
+/// Names of all ledger vectors that differ, qualified by basis.
+
+std::vector<std::string> differences(Ledger const& a, Ledger const& b)
+{
+    std::vector<std::string> z = differences
+        (a.GetLedgerInvariant().all_vectors()
+        ,b.GetLedgerInvariant().all_vectors()
+        );
+    ledger_map_t const& a_bases = a.GetLedgerMap().held();
+    ledger_map_t const& b_bases = b.GetLedgerMap().held();
+    LMI_TEST_EQUAL(a_bases.size(), b_bases.size());
+    for(auto const& [basis, variant] : a_bases)
+        {
+        auto const i = b_bases.find(basis);
+        LMI_TEST(b_bases.end() != i);
+        if(b_bases.end() == i)
+            {
+            continue;
+            }
+        for(auto const& name : differences(variant.all_vectors(), i->second.all_vectors()))
+            {
+            z.push_back(mc_str(basis) + ' ' + name);
+            }
+        }
+    return z;
+}
+} // Unnamed namespace.
+
+/// Test that projecting a cell under several scenarios gives exactly
+/// the same ledgers as a separate illustration for each.
+///
+/// Rates are not in ascending order, so that a cell that lapses under
+/// one scenario is then run under a scenario in which it doesn't.
+/// They lie within the sample products' range of general-account
+/// rates, [0.03, 0.06], outside which a separate illustration would
+/// be rejected.
+
+void test_against_separate_runs(Input const& base, std::string const& context)
+{
+    std::vector<std::string> const rates {"0.03", "0.06", "0.045"};
+    std::vector<rate_scenario> scenarios;
+    std::vector<std::shared_ptr<Ledger const>> separate;
+    for(auto const& i : rates)
+        {
+        Input cell {base};
+        cell["GeneralAccountRate"] = i;
+        cell.RealizeAllSequenceInput();
+        yare_input const y(cell);
+        scenarios.push_back({y.GeneralAccountRate, y.SeparateAccountRate});
+        IllusVal v("rate_scenarios_test");
+        v.run(cell);
+        separate.push_back(v.ledger());
+        }
+
+    std::vector<std::shared_ptr<Ledger const>> const shared =
+        run_rate_scenarios(base, scenarios);
+    LMI_TEST_EQUAL(rates.size(), shared.size());
+
+    for(int k = 0; k < lmi::ssize(rates); ++k)
+        {
+        std::vector<std::string> const d = differences(*shared[k], *separate[k]);
+        for(auto const& i : d)
+            {
+            std::cout << context << " at " << rates[k] << ": " << i << std::endl;
+            }
+        LMI_TEST(d.empty());
+        }
+}
+
+void test_rate_scenarios()
+{
+    Input no_solve;
+    no_solve["ProductName"           ] = "sample2naic";
+    no_solve["SolveType"             ] = "No solve";
+    no_solve["Gender"                ] = "Male";
+    no_solve["Smoking"               ] = "Nonsmoker";
+    no_solve["UnderwritingClass"     ] = "Standard";
+    no_solve["UseCurrentDeclaredRate"] = "No";
+    no_solve["GeneralAccountRate"    ] = "0.06";
+    no_solve["Payment"               ] = "20000.0";
+    no_solve["SpecifiedAmount"       ] = "1000000.0";
+    no_solve["SolveToWhich"          ] = "Maturity";
+    no_solve.RealizeAllSequenceInput();
+    test_against_separate_runs(no_solve, "no solve");
+
+    Input solve_specamt {no_solve};
+    solve_specamt["SolveType"] = "Specified amount";
+    test_against_separate_runs(solve_specamt, "specified-amount solve");
+
+    Input solve_ee_prem {no_solve};
+    solve_ee_prem["SolveType"] = "Employee premium";
+    test_against_separate_runs(solve_ee_prem, "premium solve");
+
+    // Lapses at 3% and 4.5%, but not at 6%.
+    Input lapse {no_solve};
+    lapse["Payment"] = "11000.0";
+    test_against_separate_runs(lapse, "low premium");
+
+    Input finra {no_solve};
+    finra["ProductName"] = "sample2finra";
+    test_against_separate_runs(finra, "finra");
+}
+
+/// Test that a scenario must have a rate for every policy year.
+
+void test_scenario_length()
+{
+    Input input;
+    input["ProductName"] = "sample2naic";
+    input.RealizeAllSequenceInput();
+    std::vector<double> const too_short(3, 0.04);
+    LMI_TEST_THROW
+        (run_rate_scenarios(input, {{too_short, too_short}})
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Interest-rate scenario has 3 general-account")
+        );
+}
+
+int test_main(int, char*[])
+{
+    global_settings::instance().set_data_directory("/opt/lmi/data");
+
+    test_rate_scenarios();
+    test_scenario_length();
+
+    return EXIT_SUCCESS;
+}
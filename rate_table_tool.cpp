@@ -21,15 +21,20 @@
 
 #include "pchfile.hpp"
 
+#include "actuarial_table.hpp"
 #include "alert.hpp"
+#include "bourn_cast.hpp"
 #include "getopt.hpp"
 #include "license.hpp"
 #include "main_common.hpp"
 #include "path.hpp"
 #include "path_utility.hpp"
+#include "rate_pack.hpp"
 #include "rate_table.hpp"
+#include "ssize_lmi.hpp"
 
-#include <algorithm>                    // sort()
+#include <algorithm>                    // max(), min(), sort()
+#include <atomic>
 #include <cstdio>                       // fflush()
 #include <cstdlib>                      // atoi()
 #include <exception>
@@ -37,35 +42,154 @@
 #include <iomanip>                      // setw(), setfill()
 #include <iostream>                     // cout, cerr
 #include <map>
-#include <memory>                       // unique_ptr
+#include <memory>                       // make_unique(), unique_ptr
+#include <optional>
 #include <ostream>                      // endl
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace soa_v3_format;
 
-void calculate_and_display_crcs(fs::path const& database_filename)
+/// Warnings and error, if any, that arose in one task.
+
+struct task_outcome
+{
+    std::vector<std::string> warnings;
+    std::exception_ptr       error;
+};
+
+/// Perform 'n' tasks, using up to 'n_jobs' threads.
+///
+/// 'f(j, i)' performs task 'i' on the thread numbered 'j', which may
+/// use per-thread resources. Warnings and errors are recorded rather
+/// than reported as they arise, so that callers can report them in
+/// task order, making output independent of scheduling.
+
+template<typename F>
+std::vector<task_outcome> run_tasks(int n, int n_jobs, F f)
+{
+    std::vector<task_outcome> outcomes(n);
+    std::atomic<int> next {0};
+    auto const worker = [&] (int j)
+        {
+        for(int i = next++; i < n; i = next++)
+            {
+            warning_capture capture;
+            try
+                {
+                f(j, i);
+                }
+            catch(...)
+                {
+                outcomes[i].error = std::current_exception();
+                }
+            outcomes[i].warnings = capture.messages();
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for(int j = 1; j < std::min(n_jobs, n); ++j)
+        {
+        threads.emplace_back(worker, j);
+        }
+    worker(0);
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+    return outcomes;
+}
+
+/// Reissue a task's warnings; then rethrow its error, if any.
+
+void report(task_outcome const& z)
+{
+    for(auto const& i : z.warnings)
+        {
+        warning() << i << std::flush;
+        }
+    if(z.error)
+        {
+        std::rethrow_exception(z.error);
+        }
+}
+
+/// One database object per thread, opened on first use.
+///
+/// A database reads tables lazily from a stream, which threads cannot
+/// share. The first thread uses the object the caller already has.
+
+class database_per_thread
+{
+  public:
+    database_per_thread
+        (fs::path const& database_filename
+        ,database const& first
+        ,int             n_jobs
+        )
+        :database_filename_ {database_filename}
+        ,first_             {first}
+        ,others_            (bourn_cast<std::size_t>(std::max(1, n_jobs)))
+        {
+        }
+
+    database const& operator[](int j)
+        {
+        if(0 == j)
+            {
+            return first_;
+            }
+        auto& z = others_.at(bourn_cast<std::size_t>(j));
+        if(!z)
+            {
+            z = std::make_unique<database>(database_filename_);
+            }
+        return *z;
+        }
+
+  private:
+    fs::path const&                        database_filename_;
+    database const&                        first_;
+    std::vector<std::unique_ptr<database>> others_;
+};
+
+void calculate_and_display_crcs(fs::path const& database_filename, int n_jobs)
 {
     database const table_file(database_filename);
-    for(int i = 0; i != table_file.tables_count(); ++i)
+    database_per_thread databases(database_filename, table_file, n_jobs);
+    int const n = table_file.tables_count();
+    std::vector<std::string> lines(n);
+    auto const outcomes = run_tasks
+        (n
+        ,n_jobs
+        ,[&] (int j, int i)
+            {
+            table const& t = databases[j].get_nth_table(i);
+            std::uint32_t crc = t.compute_hash_value();
+            std::ostringstream oss;
+            oss
+                << std::dec << std::setw( 5) << std::setfill('0')
+                << t.number().value()
+                << ' '
+                << std::dec << std::setw(10) << std::setfill('0')
+                << crc
+                << ' '
+                << std::hex << std::setw( 8) << std::setfill('0')
+                << crc
+                << ' '
+                << t.name()
+                << '\n'
+                ;
+            lines[i] = oss.str();
+            }
+        );
+    for(int i = 0; i != n; ++i)
         {
-        table const& t = table_file.get_nth_table(i);
-        std::uint32_t crc = t.compute_hash_value();
-        std::cout
-            << std::dec << std::setw( 5) << std::setfill('0')
-            << t.number().value()
-            << ' '
-            << std::dec << std::setw(10) << std::setfill('0')
-            << crc
-            << ' '
-            << std::hex << std::setw( 8) << std::setfill('0')
-            << crc
-            << ' '
-            << t.name()
-            << '\n'
-            ;
+        report(outcomes[i]);
+        std::cout << lines[i];
         }
 }
 
@@ -115,10 +239,13 @@ void list_tables(fs::path const& database_filename)
 /// a directory, then merge all '*.rates' files in that directory.
 /// Rationale:
 ///   https://lists.nongnu.org/archive/html/lmi/2016-11/msg00025.html
+///
+/// Files in a directory are parsed concurrently, but merged in order.
 
 void merge
     (fs::path const& database_filename
     ,fs::path const& path_to_merge
+    ,int             n_jobs
     )
 {
     std::unique_ptr<database> table_file;
@@ -151,10 +278,17 @@ void merge
                 }
             }
         std::sort(table_names.begin(), table_names.end());
-        for(auto const& j : table_names)
+        int const n = lmi::ssize(table_names);
+        std::vector<std::optional<table>> tables(n);
+        auto const outcomes = run_tasks
+            (n
+            ,n_jobs
+            ,[&] (int, int i) {tables[i] = table::read_from_text(table_names[i]);}
+            );
+        for(int i = 0; i != n; ++i)
             {
-            table const& t = table::read_from_text(j);
-            table_file->add_or_replace_table(t);
+            report(outcomes[i]);
+            table_file->add_or_replace_table(*tables[i]);
             ++count;
             }
         }
@@ -205,14 +339,20 @@ void extract
     std::cout << "Extracted: " << do_save_as_text_file(t) << '\n';
 }
 
-void extract_all(fs::path database_filename)
+void extract_all(fs::path database_filename, int n_jobs)
 {
     database const table_file(database_filename);
+    database_per_thread databases(database_filename, table_file, n_jobs);
 
     auto const count = table_file.tables_count();
-    for(int i = 0; i != count; ++i)
+    auto const outcomes = run_tasks
+        (count
+        ,n_jobs
+        ,[&] (int j, int i) {do_save_as_text_file(databases[j].get_nth_table(i));}
+        );
+    for(auto const& i : outcomes)
         {
-        do_save_as_text_file(table_file.get_nth_table(i));
+        report(i);
         }
 
     std::cout << "Number of tables extracted: " << count << "\n";
@@ -317,11 +457,63 @@ void rename_tables
     table_file.save(database_filename);
 }
 
+/// Compile the database into a rate pack alongside it.
+///
+/// Afterwards, read the pack back and compare every row it contains
+/// to the values read from the database, so that a pack that would
+/// not reproduce them exactly is never left in place.
+
+void pack(fs::path const& database_filename)
+{
+    database const table_file(database_filename);
+    std::vector<int> numbers;
+    for(auto const& num : get_all_tables_numbers(table_file))
+        {
+        numbers.push_back(num.value());
+        }
+
+    std::string const filename = database_filename.string();
+    fs::path const pack_filename = rate_pack::pack_filename(filename);
+    rate_pack::write(filename, numbers, pack_filename);
+
+    try
+        {
+        rate_pack const p(pack_filename);
+        for(auto const number : numbers)
+            {
+            actuarial_table const t(filename, number);
+            auto const v = p.find_table(number);
+            for(int age = t.min_age(); age <= t.max_age(); ++age)
+                {
+                int const length = 1 + t.max_age() - age;
+                if(t.values(age, length) != v.values(age, length))
+                    {
+                    alarum()
+                        << "Packed table #" << number
+                        << " differs from the original for issue age "
+                        << age
+                        << "."
+                        << LMI_FLUSH
+                        ;
+                    }
+                }
+            }
+        }
+    catch(...)
+        {
+        fs::remove(pack_filename);
+        throw;
+        }
+
+    std::cout << "Number of tables packed: " << numbers.size() << "\n";
+}
+
 /// Return the number of tables that failed verification.
 
-int verify(fs::path const& database_filename)
+int verify(fs::path const& database_filename, int n_jobs)
 {
     database const orig_db(database_filename);
+    database_per_thread databases(database_filename, orig_db, n_jobs);
 
     int errors = 0;
 
@@ -330,11 +522,12 @@ int verify(fs::path const& database_filename)
     //
     // Make the output ordered by table numbers.
     auto const numbers = get_all_tables_numbers(orig_db);
-    for(auto const& num : numbers)
-        {
-        try
+    auto const outcomes = run_tasks
+        (lmi::ssize(numbers)
+        ,n_jobs
+        ,[&] (int j, int i)
             {
-            table const& orig_table = orig_db.find_table(num);
+            table const& orig_table = databases[j].find_table(numbers[i]);
             auto const orig_text = orig_table.save_as_text();
             table const& new_table = table::read_from_text(orig_text);
             auto const new_text = new_table.save_as_text();
@@ -358,10 +551,17 @@ int verify(fs::path const& database_filename)
                     ;
                 }
             }
+        );
+    for(int i = 0; i != lmi::ssize(numbers); ++i)
+        {
+        try
+            {
+            report(outcomes[i]);
+            }
         catch(std::exception const& e)
             {
             std::cout
-                << "Verification failed for table #" << num << ": "
+                << "Verification failed for table #" << numbers[i] << ": "
                 << e.what()
                 << std::endl
                 ;
@@ -448,9 +648,11 @@ int try_main(int argc, char* argv[])
         {"file=FILE"   ,REQD_ARG ,nullptr ,'f' ,nullptr ,"use database FILE"},
         {"crc"         ,NO_ARG   ,nullptr ,'c' ,nullptr ,"show CRCs of all tables"},
         {"list"        ,NO_ARG   ,nullptr ,'t' ,nullptr ,"list all tables"},
+        {"jobs=n"      ,REQD_ARG ,nullptr ,'j' ,nullptr ,"use n threads for bulk operations (0: one per core)"},
         {"merge=PATH"  ,REQD_ARG ,nullptr ,'m' ,nullptr ,"merge PATH (file or dir) into database"},
         {"extract=n"   ,REQD_ARG ,nullptr ,'e' ,nullptr ,"extract table #n into '0000n.rates'"},
         {"extract-all" ,NO_ARG   ,nullptr ,'x' ,nullptr ,"extract all tables to '.rates' files"},
+        {"pack"        ,NO_ARG   ,nullptr ,'p' ,nullptr ,"compile database into a '.rpk' rate pack"},
         {"rename=FILE" ,REQD_ARG ,nullptr ,'r' ,nullptr ,"rename tables from FILE"},
         {"verify"      ,NO_ARG   ,nullptr ,'v' ,nullptr ,"verify integrity of all tables"},
         {nullptr       ,NO_ARG   ,nullptr ,000 ,nullptr ,""}
@@ -464,10 +666,12 @@ int try_main(int argc, char* argv[])
     bool run_delete       = false;
     bool run_extract      = false;
     bool run_extract_all  = false;
+    bool run_pack         = false;
     bool run_rename       = false;
     bool run_verify       = false;
 
     int  num_to_do        = 0;      // Number of actions to perform.
+    int  n_jobs           = 1;      // Threads for bulk operations.
     bool needs_database   = true;
 
     fs::path database_filename;
@@ -504,6 +708,21 @@ int try_main(int argc, char* argv[])
             }
             break;
 
+          case 'j':
+            {
+            n_jobs = std::atoi(getopt_long.optarg);
+            if(n_jobs < 0)
+                {
+                std::cerr << "Number of jobs must not be negative.\n";
+                command_line_syntax_error = true;
+                }
+            else if(0 == n_jobs)
+                {
+                n_jobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+                }
+            }
+            break;
+
           case 'h':
             {
             show_help = true;
@@ -564,6 +783,13 @@ int try_main(int argc, char* argv[])
             }
             break;
 
+          case 'p':
+            {
+            run_pack = true;
+            ++num_to_do;
+            }
+            break;
+
           case 'r':
             {
             run_rename = true;
@@ -619,7 +845,7 @@ int try_main(int argc, char* argv[])
                 {
                 std::cerr
                     << "Please use exactly one of the following options:\n"
-                    << "--crc, --list, --rename, --merge, --extract or --verify.\n";
+                    << "--crc, --list, --rename, --merge, --extract, --pack or --verify.\n";
                 command_line_syntax_error = true;
                 }
             break;
@@ -677,7 +903,7 @@ int try_main(int argc, char* argv[])
 
     if(run_crc)
         {
-        calculate_and_display_crcs(database_filename);
+        calculate_and_display_crcs(database_filename, n_jobs);
         return EXIT_SUCCESS;
         }
 
@@ -695,7 +921,7 @@ int try_main(int argc, char* argv[])
 
     if(run_merge)
         {
-        merge(database_filename, path_to_merge);
+        merge(database_filename, path_to_merge, n_jobs);
         return EXIT_SUCCESS;
         }
 
@@ -707,7 +933,13 @@ int try_main(int argc, char* argv[])
 
     if(run_extract_all)
         {
-        extract_all(database_filename);
+        extract_all(database_filename, n_jobs);
+        return EXIT_SUCCESS;
+        }
+
+    if(run_pack)
+        {
+        pack(database_filename);
         return EXIT_SUCCESS;
         }
 
@@ -721,7 +953,7 @@ int try_main(int argc, char* argv[])
 
     if(run_verify)
         {
-        return verify(database_filename) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        return verify(database_filename, n_jobs) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
         }
 
     std::cerr << "Unexpected unknown run mode, nothing done.\n";
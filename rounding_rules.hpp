@@ -94,6 +94,7 @@ class LMI_SO rounding_rules final
     ,public cache_file_reads  <rounding_rules>
 {
     friend class RoundingDocument;
+    friend class product_snapshot;
 
   public:
     explicit rounding_rules(fs::path const& filename);
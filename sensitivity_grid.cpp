@@ -0,0 +1,331 @@
+// Sensitivity grids: one cell run under a grid of input variations.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "sensitivity_grid.hpp"
+
+#include "account_value.hpp"
+#include "alert.hpp"
+#include "configurable_settings.hpp"
+#include "contains.hpp"
+#include "fenv_lmi.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_variant.hpp"
+#include "miscellany.hpp"               // ios_out_trunc_binary()
+#include "path_utility.hpp"             // fs::path inserter
+#include "single_cell_document.hpp"
+#include "ssize_lmi.hpp"
+#include "value_cast.hpp"
+#include "yare_input.hpp"
+
+#include <algorithm>                    // max(), min(), replace_if(), stable_sort()
+#include <atomic>
+#include <exception>
+#include <memory>                       // unique_ptr
+#include <numeric>                      // iota()
+#include <thread>
+
+namespace
+{
+/// Make an exception's text fit in one tab-delimited field.
+
+std::string as_field(std::string s)
+{
+    std::replace_if
+        (s.begin()
+        ,s.end()
+        ,[](char c) {return '\t' == c || '\n' == c || '\r' == c;}
+        ,' '
+        );
+    return s;
+}
+
+/// Summarize one point's ledger.
+
+void summarize
+    (Ledger           const& ledger
+    ,std::vector<int> const& years
+    ,grid_point            & point
+    )
+{
+    LedgerVariant const& curr = ledger.GetCurrFull();
+    LedgerVariant const& guar = ledger.GetGuarFull();
+    point.curr_lapse_year = curr.LapseYear;
+    point.guar_lapse_year = guar.LapseYear;
+    point.csv_net.clear();
+    for(auto const& i : years)
+        {
+        // After maturity, there is no cash value.
+        bool const in_range = i <= lmi::ssize(curr.CSVNet);
+        point.csv_net.push_back(in_range ? curr.CSVNet[i - 1] : 0.0);
+        }
+}
+
+/// Whether an axis varies only input interest rates.
+
+bool is_rate_axis(grid_axis const& axis)
+{
+    return
+           "GeneralAccountRate"  == axis.name
+        || "SeparateAccountRate" == axis.name
+        ;
+}
+} // Unnamed namespace.
+
+/// Run one cell under every combination of values on one or two axes.
+///
+/// Points are ordered with the first axis varying most slowly. They
+/// are divided among threads. Each thread rebinds one AccountValue
+/// to each point in turn, keeping its scratch storage, as a census
+/// run in series does; and product files are read only once, via the
+/// shared file caches. An error at one point is recorded, and doesn't prevent
+/// the others from being run.
+///
+/// Interest-rate axes get special treatment. Points that differ only
+/// in input interest rates are run in turn with one AccountValue, via
+/// AccountValue::RunRateScenario(), so that whatever doesn't depend
+/// on those rates is set up only once.
+
+std::vector<grid_point> run_sensitivity_grid
+    (Input                  const& base
+    ,std::vector<grid_axis> const& axes
+    ,std::vector<int>       const& years
+    )
+{
+    if(axes.empty() || 2 < axes.size())
+        {
+        alarum()
+            << "A sensitivity grid must have one or two axes, not "
+            << axes.size()
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+    for(auto const& i : axes)
+        {
+        if(!contains(base.member_names(), i.name))
+            {
+            alarum()
+                << "Grid axis '" << i.name << "' is not an input field."
+                << LMI_FLUSH
+                ;
+            }
+        if(i.values.empty())
+            {
+            alarum() << "Grid axis '" << i.name << "' has no values." << LMI_FLUSH;
+            }
+        }
+
+    std::vector<grid_point> points;
+    std::vector<std::string> const no_values {std::string()};
+    std::vector<std::string> const& inner =
+        2 == axes.size() ? axes[1].values : no_values;
+    for(auto const& i : axes[0].values)
+        {
+        for(auto const& j : inner)
+            {
+            grid_point p;
+            p.values.push_back(i);
+            if(2 == axes.size())
+                {
+                p.values.push_back(j);
+                }
+            points.push_back(p);
+            }
+        }
+
+    // Values of axes other than interest rates: points with the same
+    // values can share an AccountValue. Run such points consecutively.
+    auto const setup_values = [&axes](grid_point const& p)
+        {
+        std::vector<std::string> z;
+        for(int k = 0; k < lmi::ssize(axes); ++k)
+            {
+            if(!is_rate_axis(axes[k]))
+                {
+                z.push_back(p.values[k]);
+                }
+            }
+        return z;
+        };
+    int const n_points = lmi::ssize(points);
+    std::vector<int> order(n_points);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort
+        (order.begin()
+        ,order.end()
+        ,[&](int a, int b)
+            {return setup_values(points[a]) < setup_values(points[b]);}
+        );
+
+    std::atomic<int> next_point {0};
+    auto const worker = [&]
+        {
+        fenv_initialize();
+        Input cell(base);
+        std::unique_ptr<AccountValue> av;
+        std::vector<std::string> av_setup_values;
+        for(int j = next_point++; j < n_points; j = next_point++)
+            {
+            grid_point& p = points[order[j]];
+            try
+                {
+                cell = base;
+                for(int k = 0; k < lmi::ssize(axes); ++k)
+                    {
+                    cell[axes[k].name] = p.values[k];
+                    }
+                cell.Reconcile();
+                cell.RealizeAllSequenceInput(false);
+                if(av && setup_values(p) == av_setup_values)
+                    {
+                    yare_input const y(cell);
+                    summarize
+                        (*av->RunRateScenario
+                            (y.GeneralAccountRate
+                            ,y.SeparateAccountRate
+                            )
+                        ,years
+                        ,p
+                        );
+                    }
+                else
+                    {
+                    if(av)
+                        {
+                        av->Rebind(cell);
+                        }
+                    else
+                        {
+                        av = std::make_unique<AccountValue>(cell);
+                        }
+                    av_setup_values = setup_values(p);
+                    av->RunAV();
+                    summarize(*av->ledger_from_av(), years, p);
+                    }
+                }
+            catch(std::exception const& e)
+                {
+                av.reset();
+                p.error = as_field(e.what());
+                }
+            catch(...)
+                {
+                // Nothing to record but the fact of failure; report
+                // the exception, which mustn't escape this thread.
+                av.reset();
+                p.error = "Unknown error.";
+                report_exception();
+                }
+            }
+        };
+
+    int const n_threads = std::max
+        (1
+        ,std::min(n_points, static_cast<int>(std::thread::hardware_concurrency()))
+        );
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1);
+    for(int j = 1; j < n_threads; ++j)
+        {
+        threads.emplace_back(worker);
+        }
+    worker();
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+    return points;
+}
+
+/// Write a grid as a tab-delimited table, with one line per point.
+
+void write_sensitivity_grid
+    (fs::path                const& output_file
+    ,std::vector<grid_axis>  const& axes
+    ,std::vector<int>        const& years
+    ,std::vector<grid_point> const& points
+    )
+{
+    fs::ofstream ofs(output_file, ios_out_trunc_binary());
+    for(auto const& i : axes)
+        {
+        ofs << i.name << '\t';
+        }
+    ofs << "Error\tCurrLapseYear\tGuarLapseYear";
+    for(auto const& i : years)
+        {
+        ofs << "\tCSVNet" << i;
+        }
+    ofs << '\n';
+
+    for(auto const& p : points)
+        {
+        for(auto const& i : p.values)
+            {
+            ofs << as_field(i) << '\t';
+            }
+        ofs << p.error;
+        if(p.error.empty())
+            {
+            ofs
+                << '\t' << value_cast<std::string>(p.curr_lapse_year)
+                << '\t' << value_cast<std::string>(p.guar_lapse_year)
+                ;
+            for(auto const& i : p.csv_net)
+                {
+                ofs << '\t' << value_cast<std::string>(i);
+                }
+            }
+        ofs << '\n';
+        }
+
+    if(!ofs)
+        {
+        alarum() << "Unable to write file " << output_file << "." << LMI_FLUSH;
+        }
+}
+
+/// Run a grid for the cell in an '.ill' file, writing the summary to
+/// a file of the same name with a '.grid' extension followed by the
+/// spreadsheet extension.
+
+void run_sensitivity_grid_file
+    (fs::path               const& input_file
+    ,std::vector<grid_axis> const& axes
+    ,std::vector<int>       const& years
+    )
+{
+    single_cell_document const doc(input_file.string());
+    std::vector<grid_point> const points = run_sensitivity_grid
+        (doc.input_data()
+        ,axes
+        ,years
+        );
+    fs::path output_file(input_file);
+    output_file.replace_extension
+        (".grid" + configurable_settings::instance().spreadsheet_file_extension()
+        );
+    write_sensitivity_grid(output_file, axes, years, points);
+}
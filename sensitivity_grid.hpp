@@ -0,0 +1,83 @@
+// Sensitivity grids: one cell run under a grid of input variations.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef sensitivity_grid_hpp
+#define sensitivity_grid_hpp
+
+#include "config.hpp"
+
+#include "path.hpp"
+#include "so_attributes.hpp"
+
+#include <string>
+#include <vector>
+
+class Input;
+
+/// One axis of a sensitivity grid: an input member, and the values
+/// it is to take, written as in xml input files.
+
+struct grid_axis
+{
+    std::string              name;
+    std::vector<std::string> values;
+};
+
+/// Summary of one point of a sensitivity grid.
+///
+/// Lapse years are as in the ledger: the policy duration of lapse,
+/// or the length of the projection if the contract never lapses.
+/// Net cash surrender values are on the current basis, as of the
+/// end of each requested policy year.
+
+struct grid_point
+{
+    std::vector<std::string> values;    // One per axis.
+    std::string              error;     // Empty unless the run failed.
+    double                   curr_lapse_year {0.0};
+    double                   guar_lapse_year {0.0};
+    std::vector<double>      csv_net;   // One per requested year.
+};
+
+LMI_SO grid_axis parse_grid_axis(std::string const&);
+
+LMI_SO std::vector<int> parse_grid_years(std::string const&);
+
+LMI_SO std::vector<grid_point> run_sensitivity_grid
+    (Input                  const& base
+    ,std::vector<grid_axis> const& axes
+    ,std::vector<int>       const& years
+    );
+
+LMI_SO void write_sensitivity_grid
+    (fs::path                const& output_file
+    ,std::vector<grid_axis>  const& axes
+    ,std::vector<int>        const& years
+    ,std::vector<grid_point> const& points
+    );
+
+LMI_SO void run_sensitivity_grid_file
+    (fs::path                const& input_file
+    ,std::vector<grid_axis>  const& axes
+    ,std::vector<int>        const& years
+    );
+
+#endif // sensitivity_grid_hpp
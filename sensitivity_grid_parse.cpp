@@ -0,0 +1,98 @@
+// Sensitivity grids: parsing axes and years.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "sensitivity_grid.hpp"
+
+#include "alert.hpp"
+#include "value_cast.hpp"
+
+namespace
+{
+/// Split a string at each occurrence of a delimiter.
+///
+/// Unlike std::getline(), this yields an empty last token if the
+/// string ends with the delimiter, so that callers can reject it.
+
+std::vector<std::string> split(std::string const& s, char delimiter)
+{
+    std::vector<std::string> z;
+    std::string::size_type b = 0;
+    for(;;)
+        {
+        std::string::size_type const e = s.find(delimiter, b);
+        z.push_back(s.substr(b, e - b));
+        if(std::string::npos == e)
+            {
+            return z;
+            }
+        b = 1 + e;
+        }
+}
+} // Unnamed namespace.
+
+/// Parse an axis written as a member name, '=', and values separated
+/// by '|'. Values can't be separated by commas or semicolons, which
+/// may occur in input sequences.
+
+grid_axis parse_grid_axis(std::string const& s)
+{
+    std::string::size_type const eq = s.find('=');
+    if(std::string::npos == eq || 0 == eq || s.size() == 1 + eq)
+        {
+        alarum()
+            << "Grid axis '" << s << "' should be written as"
+            << " 'name=value|value|...'."
+            << LMI_FLUSH
+            ;
+        }
+    grid_axis z {s.substr(0, eq), split(s.substr(1 + eq), '|')};
+    for(auto const& i : z.values)
+        {
+        if(i.empty())
+            {
+            alarum() << "Grid axis '" << s << "' has an empty value." << LMI_FLUSH;
+            }
+        }
+    return z;
+}
+
+/// Parse policy years separated by commas, e.g. "5,10,20".
+
+std::vector<int> parse_grid_years(std::string const& s)
+{
+    std::vector<int> z;
+    for(auto const& i : split(s, ','))
+        {
+        if(i.empty())
+            {
+            alarum() << "Grid years '" << s << "' include an empty value." << LMI_FLUSH;
+            }
+        int const year = value_cast<int>(i);
+        if(year < 1)
+            {
+            alarum() << "Grid year " << year << " is not positive." << LMI_FLUSH;
+            }
+        z.push_back(year);
+        }
+    return z;
+}
@@ -0,0 +1,123 @@
+// Sensitivity grids--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "sensitivity_grid.hpp"
+
+#include "test_tools.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void test_parse_grid_axis()
+{
+    grid_axis const a = parse_grid_axis("GeneralAccountRate=0.03|0.06;0.04");
+    LMI_TEST_EQUAL("GeneralAccountRate", a.name);
+    std::vector<std::string> const v {"0.03", "0.06;0.04"};
+    LMI_TEST(v == a.values);
+
+    grid_axis const b = parse_grid_axis("Payment=1000, 5; 0");
+    LMI_TEST_EQUAL("Payment", b.name);
+    LMI_TEST_EQUAL(1, b.values.size());
+    LMI_TEST_EQUAL("1000, 5; 0", b.values[0]);
+
+    std::string const form {"' should be written as 'name=value|value|...'."};
+    LMI_TEST_THROW
+        (parse_grid_axis("")
+        ,std::runtime_error
+        ,"Grid axis '" + form
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("Payment")
+        ,std::runtime_error
+        ,"Grid axis 'Payment" + form
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("=1000")
+        ,std::runtime_error
+        ,"Grid axis '=1000" + form
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("Payment=")
+        ,std::runtime_error
+        ,"Grid axis 'Payment=" + form
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("Payment=1000||2000")
+        ,std::runtime_error
+        ,"Grid axis 'Payment=1000||2000' has an empty value."
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("Payment=|1000")
+        ,std::runtime_error
+        ,"Grid axis 'Payment=|1000' has an empty value."
+        );
+    LMI_TEST_THROW
+        (parse_grid_axis("Payment=1000|")
+        ,std::runtime_error
+        ,"Grid axis 'Payment=1000|' has an empty value."
+        );
+}
+
+void test_parse_grid_years()
+{
+    std::vector<int> const v {5, 10, 20};
+    LMI_TEST(v == parse_grid_years("5,10,20"));
+    LMI_TEST(std::vector<int>{1} == parse_grid_years("1"));
+
+    LMI_TEST_THROW
+        (parse_grid_years("")
+        ,std::runtime_error
+        ,"Grid years '' include an empty value."
+        );
+    LMI_TEST_THROW
+        (parse_grid_years("5,,10")
+        ,std::runtime_error
+        ,"Grid years '5,,10' include an empty value."
+        );
+    LMI_TEST_THROW
+        (parse_grid_years("5,")
+        ,std::runtime_error
+        ,"Grid years '5,' include an empty value."
+        );
+    LMI_TEST_THROW
+        (parse_grid_years("5,0")
+        ,std::runtime_error
+        ,"Grid year 0 is not positive."
+        );
+    LMI_TEST_THROW
+        (parse_grid_years("-5")
+        ,std::runtime_error
+        ,"Grid year -5 is not positive."
+        );
+    LMI_TEST_THROW(parse_grid_years("5;10"), std::invalid_argument, "");
+    LMI_TEST_THROW(parse_grid_years("ten") , std::invalid_argument, "");
+    LMI_TEST_THROW(parse_grid_years("5.5") , std::invalid_argument, "");
+}
+
+int test_main(int, char*[])
+{
+    test_parse_grid_axis();
+    test_parse_grid_years();
+    return 0;
+}
@@ -65,6 +65,7 @@ enum e_stratified
 
 class LMI_SO stratified_entity final
 {
+    friend class product_snapshot;
     friend class stratified_charges;
     friend class TierView;
 
@@ -101,6 +102,7 @@ class LMI_SO stratified_charges final
     ,public cache_file_reads  <stratified_charges>
 {
     friend class TierDocument;
+    friend class product_snapshot;
 
   public:
     explicit stratified_charges(fs::path const& filename);
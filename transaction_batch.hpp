@@ -0,0 +1,257 @@
+// Batches of one day's tax-testing transactions.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef transaction_batch_hpp
+#define transaction_batch_hpp
+
+#include "config.hpp"
+
+#include "alert.hpp"
+#include "any_member.hpp"               // MemberSymbolTable
+#include "contains.hpp"
+#include "fenv_lmi.hpp"
+#include "handle_exceptions.hpp"        // report_exception()
+#include "miscellany.hpp"               // ios_in_binary(), ios_out_trunc_binary(), split_fields()
+#include "path.hpp"
+#include "path_utility.hpp"             // fs::path inserter
+#include "ssize_lmi.hpp"
+
+#include <algorithm>                    // max(), min(), replace_if()
+#include <atomic>
+#include <exception>
+#include <functional>                   // ref()
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace transaction_batch_detail
+{
+/// Remove a final '\r', which getline() leaves on a CRLF line.
+
+inline std::string_view without_cr(std::string const& line)
+{
+    std::string_view z(line);
+    if(!z.empty() && '\r' == z.back())
+        {
+        z.remove_suffix(1);
+        }
+    return z;
+}
+
+/// Make an exception's text fit in one tab-delimited field.
+
+inline std::string as_field(std::string s)
+{
+    std::replace_if
+        (s.begin()
+        ,s.end()
+        ,[](char c) {return '\t' == c || '\n' == c || '\r' == c;}
+        ,' '
+        );
+    return s;
+}
+} // namespace transaction_batch_detail
+
+/// Process one day's transactions for many contracts.
+///
+/// The input file is tab-delimited. Its first line names columns,
+/// each of which must be a member of class 'InputType'; every other
+/// nonblank line represents one contract, with values written as in
+/// the corresponding xml input files. Members not named in the header
+/// take their default values.
+///
+/// Contracts are processed in blocks. Each block is divided among
+/// threads, each of which reuses one 'InputType' object. Product files
+/// are read only once, via the shared file caches, but 'calculate' is
+/// responsible for everything it derives from them for each contract.
+/// Results for each block are written before
+/// the next block is read, in input order: one line per contract,
+/// giving its line number in the input file, the text of any error
+/// that prevented testing it, and every member of class 'StateType'. An
+/// error in one contract doesn't stop the others from being tested.
+///
+/// 'calculate' maps a reconciled 'InputType' to a 'StateType', and
+/// must be safe to call concurrently: in particular, it must not
+/// write any per-contract file.
+///
+/// Returns the number of contracts processed.
+
+template<typename InputType, typename StateType, typename Calculate>
+int run_transaction_batch
+    (fs::path const& input_file
+    ,fs::path const& output_file
+    ,Calculate       calculate
+    )
+{
+    using namespace transaction_batch_detail;
+
+    static constexpr int block_size = 4096;
+
+    fs::ifstream ifs(input_file, ios_in_binary());
+    if(!ifs)
+        {
+        alarum() << "Unable to read file " << input_file << "." << LMI_FLUSH;
+        }
+
+    InputType const prototype;
+    std::string line;
+    if(!std::getline(ifs, line))
+        {
+        alarum() << "File " << input_file << " has no header line." << LMI_FLUSH;
+        }
+    std::vector<std::string_view> fields;
+    split_fields(without_cr(line), fields);
+    std::vector<std::string> const headers(fields.begin(), fields.end());
+    for(auto const& i : headers)
+        {
+        if(!contains(prototype.member_names(), i))
+            {
+            alarum()
+                << "File " << input_file
+                << ": column '" << i << "' is not an input field."
+                << LMI_FLUSH
+                ;
+            }
+        }
+
+    fs::ofstream ofs(output_file, ios_out_trunc_binary());
+    ofs << "Line\tError";
+    StateType const exemplar;
+    for(auto const& i : exemplar.member_names())
+        {
+        ofs << '\t' << i;
+        }
+    ofs << '\n';
+
+    int const n_threads = std::max
+        (1
+        ,std::min(block_size, static_cast<int>(std::thread::hardware_concurrency()))
+        );
+    std::vector<InputType> cells(n_threads, prototype);
+
+    std::vector<int>         line_numbers;
+    std::vector<std::string> lines;
+    std::vector<std::string> results;
+    line_numbers.reserve(block_size);
+    lines       .reserve(block_size);
+    results     .reserve(block_size);
+
+    int line_number = 1;
+    int n_contracts = 0;
+    for(;;)
+        {
+        line_numbers.clear();
+        lines       .clear();
+        while(lmi::ssize(lines) < block_size && std::getline(ifs, line))
+            {
+            ++line_number;
+            if(std::string::npos != line.find_first_not_of(" \t\r"))
+                {
+                line_numbers.push_back(line_number);
+                lines.push_back(line);
+                }
+            }
+        if(lines.empty())
+            {
+            break;
+            }
+
+        int const n_lines = lmi::ssize(lines);
+        results.assign(n_lines, std::string());
+        std::atomic<int> next_line {0};
+        auto const worker = [&] (InputType& cell)
+            {
+            fenv_initialize();
+            std::vector<std::string_view> values;
+            for(int j = next_line++; j < n_lines; j = next_line++)
+                {
+                std::string& result = results[j];
+                result = std::to_string(line_numbers[j]) + '\t';
+                try
+                    {
+                    split_fields(without_cr(lines[j]), values);
+                    if(values.size() != headers.size())
+                        {
+                        alarum()
+                            << "Line #" << line_numbers[j]
+                            << " should have one value per column."
+                            << " Number of values: " << values.size()
+                            << "; number expected: " << headers.size()
+                            << "."
+                            << LMI_FLUSH
+                            ;
+                        }
+                    cell.MemberSymbolTable<InputType>::assign(prototype);
+                    for(int k = 0; k < lmi::ssize(headers); ++k)
+                        {
+                        cell[headers[k]] = std::string(values[k]);
+                        }
+                    cell.Reconcile();
+                    cell.RealizeAllSequenceInput(false);
+                    StateType const state(calculate(cell));
+                    for(auto const& i : state.member_names())
+                        {
+                        result += '\t';
+                        result += state[i].str();
+                        }
+                    }
+                catch(std::exception const& e)
+                    {
+                    result += as_field(e.what());
+                    }
+                catch(...)
+                    {
+                    // Nothing to record but the fact of failure; report
+                    // the exception, which mustn't escape this thread.
+                    result += "Unknown error.";
+                    report_exception();
+                    }
+                }
+            };
+
+        std::vector<std::thread> threads;
+        threads.reserve(n_threads - 1);
+        for(int j = 1; j < std::min(n_threads, n_lines); ++j)
+            {
+            threads.emplace_back(worker, std::ref(cells[j]));
+            }
+        worker(cells[0]);
+        for(auto& t : threads)
+            {
+            t.join();
+            }
+
+        for(auto const& i : results)
+            {
+            ofs << i << '\n';
+            }
+        n_contracts += n_lines;
+        }
+
+    if(!ofs)
+        {
+        alarum() << "Unable to write file " << output_file << "." << LMI_FLUSH;
+        }
+    return n_contracts;
+}
+
+#endif // transaction_batch_hpp
@@ -0,0 +1,208 @@
+// Batch processing of one day's transactions--unit test.
+//
+// Copyright (C) 2023 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// https://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+
+#include "pchfile.hpp"
+
+#include "transaction_batch.hpp"
+
+#include "any_member.hpp"
+#include "miscellany.hpp"               // ios_out_trunc_binary()
+#include "path.hpp"
+#include "ssize_lmi.hpp"
+#include "test_tools.hpp"
+#include "value_cast.hpp"
+
+#include <atomic>
+#include <cstdio>                       // remove()
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// Minimal input class with the interface run_transaction_batch()
+/// requires.
+
+class batch_input final
+    :public MemberSymbolTable<batch_input>
+{
+  public:
+    batch_input()
+        {
+        ascribe("Amount", &batch_input::Amount);
+        ascribe("Years" , &batch_input::Years );
+        }
+    batch_input(batch_input const& z)
+        :MemberSymbolTable<batch_input> {}
+        {
+        ascribe("Amount", &batch_input::Amount);
+        ascribe("Years" , &batch_input::Years );
+        MemberSymbolTable<batch_input>::assign(z);
+        }
+
+    void Reconcile() {reconciled = true;}
+    void RealizeAllSequenceInput(bool) {}
+
+    double Amount     {0.0};
+    int    Years      {1};
+    bool   reconciled {false};
+};
+
+class batch_state final
+    :public MemberSymbolTable<batch_state>
+{
+  public:
+    batch_state()
+        {
+        ascribe("Product", &batch_state::Product);
+        }
+    batch_state(batch_state const& z)
+        :MemberSymbolTable<batch_state> {}
+        {
+        ascribe("Product", &batch_state::Product);
+        MemberSymbolTable<batch_state>::assign(z);
+        }
+
+    double Product {0.0};
+};
+
+std::vector<std::string> read_lines(fs::path const& p)
+{
+    fs::ifstream ifs(p);
+    std::vector<std::string> z;
+    for(std::string line; std::getline(ifs, line);)
+        {
+        z.push_back(line);
+        }
+    return z;
+}
+} // Unnamed namespace.
+
+/// Run enough contracts to span several blocks and threads, and make
+/// sure every result is written once, in input order, whether or not
+/// the contract could be tested.
+
+void test_batch()
+{
+    fs::path const input_file ("eraseme_batch.tsv");
+    fs::path const output_file("eraseme_batch_out.tsv");
+
+    int const n = 10000;
+    {
+    fs::ofstream ofs(input_file, ios_out_trunc_binary());
+    ofs << "Years\tAmount\n";
+    for(int j = 0; j < n; ++j)
+        {
+        ofs << (j % 7) << '\t' << j << ".5\n";
+        }
+    ofs << "\n";                // Blank line: ignored.
+    ofs << "2\n";               // Too few values.
+    ofs << "x\t1\n";            // Invalid value.
+    ofs << "3\t1\t4\r\n";       // Too many values.
+    ofs << "3\t1\t\r\n";        // Trailing tab and CR: harmless.
+    ofs << "1\t-1\n";          // Throws a non-standard exception.
+    }
+
+    std::atomic<int> n_calls {0};
+    std::atomic<bool> all_reconciled {true};
+    auto const calculate = [&] (batch_input const& z)
+        {
+        ++n_calls;
+        if(!z.reconciled)
+            {
+            all_reconciled = false;
+            }
+        if(z.Amount < 0.0)
+            {
+            throw "negative amount";
+            }
+        batch_state s;
+        s.Product = z.Amount * z.Years;
+        return s;
+        };
+
+    int const n_contracts = run_transaction_batch<batch_input,batch_state>
+        (input_file
+        ,output_file
+        ,calculate
+        );
+    LMI_TEST_EQUAL(n + 5, n_contracts);
+    LMI_TEST_EQUAL(n + 2, n_calls.load());
+    LMI_TEST(all_reconciled);
+
+    std::vector<std::string> const lines = read_lines(output_file);
+    LMI_TEST_EQUAL(1 + n + 5, lmi::ssize(lines));
+    LMI_TEST_EQUAL("Line\tError\tProduct", lines[0]);
+    LMI_TEST_EQUAL("2\t\t0"   , lines[1]);
+    LMI_TEST_EQUAL("3\t\t1.5" , lines[2]);
+    LMI_TEST_EQUAL("4\t\t5"   , lines[3]);
+    bool in_order = true;
+    for(int j = 0; j < n; ++j)
+        {
+        std::string const expected
+            (std::to_string(j + 2)
+            + "\t\t"
+            + value_cast<std::string>((j + 0.5) * (j % 7))
+            );
+        in_order = in_order && expected == lines[1 + j];
+        }
+    LMI_TEST(in_order);
+
+    // Line numbers count the blank line that was skipped.
+    LMI_TEST_EQUAL(0, lines[n + 1].find(std::to_string(n + 3) + "\tLine #"));
+    LMI_TEST(std::string::npos != lines[n + 1].find("Number of values: 1"));
+    LMI_TEST_EQUAL(0, lines[n + 2].find(std::to_string(n + 4) + '\t'));
+    LMI_TEST(std::string::npos == lines[n + 2].find("\t\t"));
+    LMI_TEST_EQUAL(0, lines[n + 3].find(std::to_string(n + 5) + "\tLine #"));
+    LMI_TEST(std::string::npos != lines[n + 3].find("Number of values: 3"));
+    LMI_TEST_EQUAL(std::to_string(n + 6) + "\t\t3", lines[n + 4]);
+    LMI_TEST_EQUAL(std::to_string(n + 7) + "\tUnknown error.", lines[n + 5]);
+
+    LMI_TEST(0 == std::remove(input_file .string().c_str()));
+    LMI_TEST(0 == std::remove(output_file.string().c_str()));
+}
+
+/// Reject a header that names no input member.
+
+void test_bad_header()
+{
+    fs::path const input_file ("eraseme_batch.tsv");
+    fs::path const output_file("eraseme_batch_out.tsv");
+    {
+    fs::ofstream ofs(input_file, ios_out_trunc_binary());
+    ofs << "Years\tBogus\n1\t2\n";
+    }
+    auto const calculate = [] (batch_input const&) {return batch_state();};
+    LMI_TEST_THROW
+        ((run_transaction_batch<batch_input,batch_state>(input_file, output_file, calculate))
+        ,std::runtime_error
+        ,lmi_test::what_regex("column 'Bogus' is not an input field")
+        );
+    LMI_TEST(0 == std::remove(input_file.string().c_str()));
+}
+
+int test_main(int, char*[])
+{
+    test_batch();
+    test_bad_header();
+    return 0;
+}
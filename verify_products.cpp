@@ -31,6 +31,7 @@
 #include "database.hpp"
 #include "mc_enum.hpp"                  // all_strings<>()
 #include "product_data.hpp"
+#include "product_snapshot.hpp"         // read_product_via_cache()
 #include "ssize_lmi.hpp"
 
 #include <iostream>
@@ -77,7 +78,7 @@ product_verifier::product_verifier
     :product_name_ {product_name}
     ,gender_str_   {gender_str}
     ,smoking_str_  {smoking_str}
-    ,p_            (*product_data::read_via_cache(filename_from_product_name(product_name)))
+    ,p_            (*read_product_via_cache(product_name))
     ,gender_       {mce_gender (gender_str ).value()}
     ,smoking_      {mce_smoking(smoking_str).value()}
     ,db0_
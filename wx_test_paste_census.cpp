@@ -185,7 +185,11 @@ int find_table_column_by_title
 ///   change underwriting class to any different value
 ///   apply to every cell: Yes
 /// Verify the expected result: the underwriting-class column is no
-/// longer shown.
+/// longer shown. Then, where cells do differ from the case defaults:
+///   Census | Edit case defaults
+///   change gender to "Female"
+///   apply to every cell: Yes
+/// Verify the expected result: the gender column is no longer shown.
 ///
 /// Then save the file in 'gui_test_path'; verify that it exists.
 
@@ -405,6 +409,63 @@ LMI_WX_TEST_CASE(paste_census)
         ,"Underwriting Class"
         );
 
+    // Change the case defaults again, this time in a column where the
+    // cells differ from them.
+    ui.Char('e', wxMOD_CONTROL | wxMOD_SHIFT); // "Census|Edit case defaults"
+
+    struct change_gender_in_case_defaults_dialog
+        :public wxExpectModalBase<MvcController>
+    {
+        int OnInvoked(MvcController* dialog) const override
+            {
+            dialog->Show();
+            wxYield();
+
+            wxWindow* const gender_window = wx_test_focus_controller_child
+                (*dialog
+                ,"Gender"
+                );
+
+            wxRadioBox* const
+                gender_radiobox = dynamic_cast<wxRadioBox*>(gender_window);
+            LMI_ASSERT(gender_radiobox);
+
+            wxUIActionSimulator ui;
+            // Select the first, "Female", radio button: the case
+            // default was "Male".
+            ui.Char(WXK_UP);
+            wxYield();
+
+            LMI_ASSERT_EQUAL(gender_radiobox->GetSelection(), 0);
+
+            return wxID_OK;
+            }
+
+        wxString GetDefaultDescription() const override
+            {
+            return "case defaults dialog";
+            }
+    };
+
+    wxTEST_DIALOG
+        (wxYield()
+        ,change_gender_in_case_defaults_dialog()
+        ,wxExpectModal<wxMessageDialog>(wxYES).
+            Describe("message box asking whether to apply gender changes to all")
+        );
+
+    // Every cell and class default now has the new case-default
+    // gender, so that column has disappeared.
+    LMI_ASSERT_EQUAL(table->GetNumberRows(), number_of_rows);
+
+    column_titles.erase("Gender");
+    check_grid_columns
+        (grid_window
+        ,"after changing gender in case defaults"
+        ,column_titles
+        ,"Gender"
+        );
+
     // Finally save the census with the pasted data for later inspection.
     std::string const census_file_name = get_test_file_path_for("PasteCensus.cns");
     output_file_existence_checker output_cns(census_file_name);
@@ -38,10 +38,13 @@
 #include <wx/clipbrd.h>
 #include <wx/datetime.h>
 #include <wx/msgdlg.h>
+#include <wx/thread.h>                  // wxThread::IsMain()
 #include <wx/toplevel.h>
 #include <wx/utils.h>                   // wxSafeYield()
 #include <wx/window.h>
 
+#include <exception>                    // current_exception()
+#include <future>
 #include <sstream>
 
 /// Return whatever plain text the clipboard contains, or an empty
@@ -302,6 +305,43 @@ wxTopLevelWindow& TopWindow()
     return *t;
 }
 
+/// Call a function on the GUI thread, and wait for it to return.
+///
+/// wx is not thread-safe, so a worker thread must delegate anything
+/// that touches the GUI. On the GUI thread itself, the function is
+/// simply called. Otherwise, it's queued for the event loop, and any
+/// exception it throws is rethrown on the calling thread.
+///
+/// The GUI thread must therefore never block waiting for a worker
+/// that might be waiting here; it must keep dispatching events.
+
+void CallOnGuiThread(std::function<void()> const& f)
+{
+    if(wxThread::IsMain())
+        {
+        f();
+        return;
+        }
+
+    std::promise<void> done;
+    std::future<void> result = done.get_future();
+    TheApp().CallAfter
+        ([&f, &done]
+            {
+            try
+                {
+                f();
+                done.set_value();
+                }
+            catch(...)
+                {
+                done.set_exception(std::current_exception());
+                }
+            }
+        );
+    result.get();
+}
+
 /// Convert a filename to an NTBS std::string, throwing upon failure.
 ///
 /// An operating system might hand an NTMBS or an NTWCS to wx.
@@ -29,6 +29,7 @@
 #include <wx/event.h>
 #include <wx/string.h>
 
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -146,6 +147,8 @@ std::string NameLabelId(wxWindow const*);
 wxApp& TheApp();
 wxTopLevelWindow& TopWindow();
 
+void CallOnGuiThread(std::function<void()> const&);
+
 std::string ValidateAndConvertFilename(wxString const&);
 
 #endif // wx_utility_hpp
@@ -23,17 +23,20 @@
 
 #include "alert.hpp"
 #include "any_member.hpp"               // MemberSymbolTable<>
+#include "assert_lmi.hpp"
 #include "contains.hpp"
 #include "path.hpp"
 #include "platform_dependent.hpp"       // access()
+#include "ssize_lmi.hpp"
 #include "xml_lmi.hpp"
 
 #include <xmlwrapp/nodes_view.h>
 
-#include <algorithm>                    // copy(), find()
-#include <iterator>                     // back_inserter()
+#include <list>
 #include <sstream>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 template<typename T>
@@ -98,25 +101,29 @@ void xml_serializable<T>::read(xml::element const& x)
 
     std::map<std::string,value_type> detritus_map;
 
-    std::list<std::string> residuary_names;
-    std::copy
-        (t().member_names().begin()
-        ,t().member_names().end()
-        ,std::back_inserter(residuary_names)
-        );
+    // Every instance of T ascribes the same members, so the index of
+    // each member's name is computed only once.
+    std::vector<std::string> const& names = t().member_names();
+    static std::unordered_map<std::string,int> const slots = [&names]
+        {
+        std::unordered_map<std::string,int> z;
+        for(int j = 0; j < lmi::ssize(names); ++j)
+            {
+            z.emplace(names[j], j);
+            }
+        return z;
+        } ();
+    LMI_ASSERT(slots.size() == names.size());
 
+    std::vector<bool> seen(names.size());
     for(auto const& child : x.elements())
         {
         std::string node_tag(child.get_name());
-        std::list<std::string>::iterator current_member = std::find
-            (residuary_names.begin()
-            ,residuary_names.end()
-            ,node_tag
-            );
-        if(residuary_names.end() != current_member)
+        auto const slot = slots.find(node_tag);
+        if(slots.end() != slot && !seen[slot->second])
             {
             read_element(child, node_tag, file_version);
-            residuary_names.erase(current_member);
+            seen[slot->second] = true;
             }
         else if(is_detritus(node_tag))
             {
@@ -127,7 +134,7 @@ void xml_serializable<T>::read(xml::element const& x)
             }
         else
             {
-            bool b = contains(t().member_names(), node_tag);
+            bool b = slots.end() != slot;
             std::string s = b ? "[duplicate]" : "[unrecognized]";
             oss << "  '" << node_tag << "' " << s << "\n";
             }
@@ -137,6 +144,15 @@ void xml_serializable<T>::read(xml::element const& x)
         warning() << "Discarded XML elements:\n" << oss.str() << LMI_FLUSH;
         }
 
+    std::list<std::string> residuary_names;
+    for(int j = 0; j < lmi::ssize(names); ++j)
+        {
+        if(!seen[j])
+            {
+            residuary_names.push_back(names[j]);
+            }
+        }
+
     redintegrate_ex_post(file_version, detritus_map, residuary_names);
 
     redintegrate_ad_terminum();